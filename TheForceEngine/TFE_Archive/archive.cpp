@@ -6,7 +6,9 @@
 #include "labArchive.h"
 #include "zipArchive.h"
 #include <TFE_FileSystem/fileutil.h>
+#include <TFE_System/system.h>
 #include <assert.h>
+#include <algorithm>
 #include <string>
 #include <map>
 
@@ -14,6 +16,7 @@ namespace
 {
 	typedef std::map<std::string, Archive*> ArchiveMap;
 	static ArchiveMap s_archives[ARCHIVE_COUNT];
+	static bool s_enableMapping = true;
 }
 
 static const char* c_archiveExt[ARCHIVE_COUNT]=
@@ -180,3 +183,72 @@ void Archive::deleteCustomArchive(Archive* archive)
 	}
 	delete archive;
 }
+
+void Archive::enableMemoryMapping(bool enable)
+{
+	s_enableMapping = enable;
+}
+
+bool Archive::isMemoryMappingEnabled()
+{
+	return s_enableMapping;
+}
+
+void Archive::openArchiveData(const char* archivePath)
+{
+	closeArchiveData();
+
+	MappedFile file;
+	if (s_enableMapping)
+	{
+		if (FileUtil::mapFile(archivePath, &file))
+		{
+			m_mapData = file.data;
+			m_mapSize = file.size;
+			return;
+		}
+		TFE_System::logWrite(LOG_WARNING, "Archive", "Cannot memory map \"%s\", falling back to file reads.", archivePath);
+	}
+	m_readHandle = FileUtil::openReadHandle(archivePath);
+}
+
+void Archive::closeArchiveData()
+{
+	MappedFile file = { m_mapData, m_mapSize };
+	FileUtil::unmapFile(&file);
+	FileUtil::closeReadHandle(m_readHandle);
+
+	m_mapData = nullptr;
+	m_mapSize = 0;
+	m_readHandle = INVALID_FILE_HANDLE;
+}
+
+ArchiveFileView Archive::getMappedRange(u64 offset, u64 size) const
+{
+	// Guard against truncated or corrupt archives.
+	if (!m_mapData || offset > m_mapSize || size > m_mapSize - offset)
+	{
+		return { nullptr, 0 };
+	}
+	return { m_mapData + offset, size_t(size) };
+}
+
+size_t Archive::readArchiveAt(u64 fileStart, u64 fileSize, size_t offset, void* dst, size_t size) const
+{
+	if (offset >= fileSize) { return 0; }
+	const size_t sizeToRead = size_t(std::min(u64(size), fileSize - offset));
+
+	if (m_mapData)
+	{
+		const ArchiveFileView view = getMappedRange(fileStart, fileSize);
+		if (!view.data) { return 0; }
+		memcpy(dst, view.data + offset, sizeToRead);
+		return sizeToRead;
+	}
+	return FileUtil::readAt(m_readHandle, u64(fileStart) + offset, dst, sizeToRead);
+}
+
+u64 Archive::getArchiveDataSize() const
+{
+	return m_mapData ? u64(m_mapSize) : FileUtil::getHandleSize(m_readHandle);
+}
@@ -17,6 +17,14 @@ enum ArchiveType
 
 #define INVALID_FILE 0xffffffff
 
+// Zero-copy view of a file inside of a memory mapped (or in-memory) archive.
+// Valid until the archive is closed, data is null if the archive does not support views.
+struct ArchiveFileView
+{
+	const u8* data;
+	size_t size;
+};
+
 class Archive
 {
 	// Public API handling the same archive in multiple locations.
@@ -29,11 +37,15 @@ public:
 	static void deleteCustomArchive(Archive* archive);
 
 	static ArchiveType getArchiveTypeFromName(const char* path);
+
+	// Memory map archives opened after this call (enabled by default).
+	static void enableMemoryMapping(bool enable);
+	static bool isMemoryMappingEnabled();
 	
 	// Public Archive API
 public:
-	Archive() : m_type(ARCHIVE_UNKNOWN) {}
-	Archive(ArchiveType type) : m_type(type) {}
+	Archive() : m_type(ARCHIVE_UNKNOWN), m_mapData(nullptr), m_mapSize(0), m_readHandle(-1) {}
+	Archive(ArchiveType type) : m_type(type), m_mapData(nullptr), m_mapSize(0), m_readHandle(-1) {}
 	virtual ~Archive() {}
 
 	// Archive
@@ -61,6 +73,14 @@ public:
 	virtual bool seekFile(s32 offset, s32 origin = SEEK_SET) = 0;
 	virtual size_t getLocInFile() = 0;
 
+	// Stateless read of up to 'size' bytes starting at 'offset' within file 'index', returns the number of bytes read.
+	// This does not use or change the current file, so it is safe to call from multiple threads at the same time,
+	// and while another thread uses the stateful API above. The archive must not be opened, closed or edited meanwhile.
+	virtual size_t readFileAt(u32 index, size_t offset, void* dst, size_t size) = 0;
+	// Zero-copy access to the file data, only supported by memory mapped and in-memory archives.
+	virtual ArchiveFileView getFileView(u32 index) { return { nullptr, 0 }; }
+	bool isMapped() const { return m_mapData != nullptr; }
+
 	// Directory
 	virtual u32 getFileCount() = 0;
 	virtual const char* getFileName(u32 index) = 0;
@@ -71,9 +91,29 @@ public:
 
 	// Shared Private State
 protected:
+	// Prepare the archive file for reads: memory map it if enabled, otherwise (or if mapping fails) open it for positional reads.
+	void openArchiveData(const char* archivePath);
+	void closeArchiveData();
+	// Returns a view of [offset, offset + size) if it lies within the mapped archive.
+	ArchiveFileView getMappedRange(u64 offset, u64 size) const;
+	// Stateless read from a file stored at [fileStart, fileStart + fileSize) in the archive file, used to implement readFileAt().
+	size_t readArchiveAt(u64 fileStart, u64 fileSize, size_t offset, void* dst, size_t size) const;
+	// Size of the archive file opened by openArchiveData().
+	u64 getArchiveDataSize() const;
+
 	ArchiveType m_type;
 	char m_name[TFE_MAX_PATH];
 	char m_archivePath[TFE_MAX_PATH];
 
 	s32 m_fileOffset;
+	// Memory mapped archive file, see FileUtil::mapFile().
+	const u8* m_mapData;
+	size_t m_mapSize;
+	// Positional read handle used when the archive is not mapped, see FileUtil::openReadHandle().
+	intptr_t m_readHandle;
 };
+
+// Compares the file stream and memory mapped reads of a source data archive, see archiveTest.cpp.
+void archive_readTest(const char* archiveName);
+// Compares opening every entry of a mod ZIP with zip_open() and with the persistent reader, see archiveTest.cpp.
+void archive_zipTest(const char* modName = nullptr);
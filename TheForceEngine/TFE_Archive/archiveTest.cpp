@@ -0,0 +1,237 @@
+#include <cstring>
+
+#include "archive.h"
+#include "gobArchive.h"
+#include "lfdArchive.h"
+#include "labArchive.h"
+#include "zipArchive.h"
+#include "zip/zip.h"
+#include <TFE_FileSystem/fileutil.h>
+#include <TFE_System/system.h>
+#include <algorithm>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////
+// Archive tests, these are not called by the engine.
+// See main.cpp to run them.
+//////////////////////////////////////////////////////////////////////
+namespace
+{
+	Archive* createTestArchive(ArchiveType type)
+	{
+		switch (type)
+		{
+			case ARCHIVE_GOB: return new GobArchive();
+			case ARCHIVE_LFD: return new LfdArchive();
+			case ARCHIVE_LAB: return new LabArchive();
+			default: break;
+		}
+		return nullptr;
+	}
+
+	// Touch every byte so both paths actually read the data, but keep it cheap so the read cost dominates.
+	u32 checksumData(const u8* data, size_t size)
+	{
+		u64 sum = 0;
+		size_t i = 0;
+		for (; i + sizeof(u64) <= size; i += sizeof(u64))
+		{
+			u64 value;
+			memcpy(&value, data + i, sizeof(u64));
+			sum += value;
+		}
+		for (; i < size; i++)
+		{
+			sum += data[i];
+		}
+		return u32(sum) ^ u32(sum >> 32);
+	}
+
+	f64 getElapsedMs(u64 start)
+	{
+		return TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - start) * 1000.0;
+	}
+
+	// Write a deflated archive with 'fileCount' small generated files, the size of a large mod.
+	bool createTestZip(const char* path, u32 fileCount)
+	{
+		struct zip_t* zip = zip_open(path, ZIP_DEFAULT_COMPRESSION_LEVEL, 'w');
+		if (!zip) { return false; }
+
+		// Text-like data of varying size, similar to the INF, O and VUE files found in mods.
+		std::vector<char> data;
+		char name[TFE_MAX_PATH];
+		bool result = true;
+		for (u32 i = 0; i < fileCount && result; i++)
+		{
+			const size_t size = 64 + (i * 2654435761u) % 4096;
+			data.resize(size);
+			for (size_t c = 0; c < size; c++)
+			{
+				data[c] = "0123456789 ABCDEF\n"[(c * 7 + i + c / 13) % 18];
+			}
+			sprintf(name, "TEST/FILE%05u.TXT", i);
+			result = zip_entry_open(zip, name) == 0 && zip_entry_write(zip, data.data(), size) == 0;
+			zip_entry_close(zip);
+		}
+		zip_close(zip);
+		return result;
+	}
+}
+
+// Read every file in a source data archive (such as DARK.GOB) through the file stream path and through the memory mapped
+// view, verify that both return the same data and log the best time of several runs.
+void archive_readTest(const char* archiveName)
+{
+	const ArchiveType type = Archive::getArchiveTypeFromName(archiveName);
+	char path[TFE_MAX_PATH];
+	TFE_Paths::appendPath(PATH_SOURCE_DATA, archiveName, path);
+
+	// The read path without memory mapping.
+	const bool prevMapping = Archive::isMemoryMappingEnabled();
+	Archive::enableMemoryMapping(false);
+	Archive* streamArchive = createTestArchive(type);
+	const bool streamOpen = streamArchive && streamArchive->open(path);
+
+	Archive::enableMemoryMapping(true);
+	Archive* mappedArchive = createTestArchive(type);
+	const bool mappedOpen = mappedArchive && mappedArchive->open(path) && mappedArchive->isMapped();
+	Archive::enableMemoryMapping(prevMapping);
+
+	if (!streamOpen || !mappedOpen)
+	{
+		TFE_System::logWrite(LOG_ERROR, "Archive Test", "Cannot test \"%s\", only GOB, LFD and LAB archives that can be memory mapped are supported.", path);
+		delete streamArchive;
+		delete mappedArchive;
+		return;
+	}
+
+	const u32 runs = 5;
+	const u32 fileCount = mappedArchive->getFileCount();
+	f64 streamMs = 1e10, viewMs = 1e10;
+	size_t totalBytes = 0;
+	bool match = true;
+	std::vector<u8> buffer;
+	for (u32 r = 0; r < runs; r++)
+	{
+		u32 streamHash = 0;
+		u64 start = TFE_System::getCurrentTimeInTicks();
+		for (u32 i = 0; i < fileCount; i++)
+		{
+			if (!streamArchive->openFile(i)) { continue; }
+			const size_t len = streamArchive->getFileLength();
+			buffer.resize(len);
+			const size_t bytesRead = len ? streamArchive->readFile(buffer.data(), len) : 0;
+			streamArchive->closeFile();
+			streamHash += checksumData(buffer.data(), bytesRead);
+		}
+		streamMs = std::min(streamMs, getElapsedMs(start));
+
+		u32 viewHash = 0;
+		totalBytes = 0;
+		start = TFE_System::getCurrentTimeInTicks();
+		for (u32 i = 0; i < fileCount; i++)
+		{
+			const ArchiveFileView view = mappedArchive->getFileView(i);
+			viewHash += checksumData(view.data, view.size);
+			totalBytes += view.size;
+		}
+		viewMs = std::min(viewMs, getElapsedMs(start));
+		match = match && streamHash == viewHash;
+	}
+
+	if (!match)
+	{
+		TFE_System::logWrite(LOG_ERROR, "Archive Test", "\"%s\": the mapped data does not match the file stream data.", path);
+	}
+	TFE_System::logWrite(LOG_MSG, "Archive Test", "\"%s\": %u files, %.1f KB. Stream: %.3f ms, copy buffer peak %.1f KB. Mapped: %.3f ms, no copy.",
+		path, fileCount, f64(totalBytes) / 1024.0, streamMs, f64(buffer.capacity()) / 1024.0, viewMs);
+
+	delete streamArchive;
+	delete mappedArchive;
+}
+
+// Open and read every entry of a mod ZIP by name, both with a zip_open() per entry (the previous ZipArchive behavior)
+// and through the persistent reader, verify that both return the same data and log the best time of several runs.
+// If 'modName' is null, a 5000 file archive is generated in the program data directory.
+void archive_zipTest(const char* modName)
+{
+	char path[TFE_MAX_PATH];
+	if (modName)
+	{
+		TFE_Paths::appendPath(PATH_MOD, modName, path);
+	}
+	else
+	{
+		TFE_Paths::appendPath(PATH_PROGRAM_DATA, "zipTest.zip", path);
+		if (!FileUtil::exists(path) && !createTestZip(path, 5000))
+		{
+			TFE_System::logWrite(LOG_ERROR, "Archive Test", "Cannot create the test archive \"%s\".", path);
+			return;
+		}
+	}
+
+	u64 start = TFE_System::getCurrentTimeInTicks();
+	ZipArchive archive;
+	if (!archive.open(path))
+	{
+		TFE_System::logWrite(LOG_ERROR, "Archive Test", "Cannot open \"%s\".", path);
+		return;
+	}
+	const f64 directoryMs = getElapsedMs(start);
+
+	const u32 runs = 3;
+	const u32 fileCount = archive.getFileCount();
+	f64 legacyMs = 1e10, readerMs = 1e10;
+	size_t totalBytes = 0;
+	bool match = true;
+	std::vector<u8> buffer;
+	for (u32 r = 0; r < runs; r++)
+	{
+		// A linear name search, then zip_open() reparses the central directory for every entry.
+		u32 legacyHash = 0;
+		start = TFE_System::getCurrentTimeInTicks();
+		for (u32 i = 0; i < fileCount; i++)
+		{
+			const char* name = archive.getFileName(i);
+			s32 index = -1;
+			for (u32 e = 0; e < fileCount; e++)
+			{
+				if (strcasecmp(name, archive.getFileName(e)) == 0) { index = s32(e); break; }
+			}
+			struct zip_t* zip = zip_open(path, 0, 'r');
+			if (!zip) { continue; }
+			if (zip_entry_openbyindex(zip, index) == 0)
+			{
+				buffer.resize(archive.getFileLength(i));
+				const ssize_t bytesRead = buffer.empty() ? 0 : zip_entry_noallocread(zip, buffer.data(), buffer.size());
+				legacyHash += bytesRead > 0 ? checksumData(buffer.data(), size_t(bytesRead)) : 0u;
+				zip_entry_close(zip);
+			}
+			zip_close(zip);
+		}
+		legacyMs = std::min(legacyMs, getElapsedMs(start));
+
+		// Persistent reader: hashed name lookup and a read with the reused decompression state.
+		u32 readerHash = 0;
+		totalBytes = 0;
+		start = TFE_System::getCurrentTimeInTicks();
+		for (u32 i = 0; i < fileCount; i++)
+		{
+			const u32 index = archive.getFileIndex(archive.getFileName(i));
+			buffer.resize(archive.getFileLength(index));
+			const size_t bytesRead = archive.readFileAt(index, 0, buffer.data(), buffer.size());
+			readerHash += checksumData(buffer.data(), bytesRead);
+			totalBytes += bytesRead;
+		}
+		readerMs = std::min(readerMs, getElapsedMs(start));
+		match = match && legacyHash == readerHash;
+	}
+
+	if (!match)
+	{
+		TFE_System::logWrite(LOG_ERROR, "Archive Test", "\"%s\": the persistent reader data does not match zip_open().", path);
+	}
+	TFE_System::logWrite(LOG_MSG, "Archive Test", "\"%s\": %u files, %.1f KB, directory parsed in %.3f ms. zip_open per file: %.3f ms. Persistent reader: %.3f ms.",
+		path, fileCount, f64(totalBytes) / 1024.0, directoryMs, legacyMs, readerMs);
+}
@@ -76,12 +76,14 @@ bool GobArchive::open(const char *archivePath)
 
 	strcpy(m_archivePath, archivePath);
 	m_file.close();
+	openArchiveData(archivePath);
 
 	return true;
 }
 
 void GobArchive::close()
 {
+	closeArchiveData();
 	m_file.close();
 	m_archiveOpen = false;
 	delete[] m_fileList.entries;
@@ -93,7 +95,6 @@ bool GobArchive::openFile(const char *file)
 {
 	if (!m_archiveOpen) { return false; }
 
-	m_file.open(m_archivePath, Stream::MODE_READ);
 	m_curFile = -1;
 	m_fileOffset = 0;
 
@@ -109,13 +110,8 @@ bool GobArchive::openFile(const char *file)
 
 	if (m_curFile == -1)
 	{
-		m_file.close();
 		TFE_System::logWrite(LOG_ERROR, "GOB", "Failed to load \"%s\" from \"%s\"", file, m_archivePath);
 	}
-	else
-	{
-		m_file.seek(m_fileList.entries[m_curFile].IX);
-	}
 	return m_curFile > -1 ? true : false;
 }
 
@@ -125,15 +121,12 @@ bool GobArchive::openFile(u32 index)
 
 	m_curFile = s32(index);
 	m_fileOffset = 0;
-	m_file.open(m_archivePath, Stream::MODE_READ);
-	m_file.seek(m_fileList.entries[m_curFile].IX);
 	return true;
 }
 
 void GobArchive::closeFile()
 {
 	m_curFile = -1;
-	m_file.close();
 }
 
 u32 GobArchive::getFileIndex(const char* file)
@@ -185,8 +178,9 @@ size_t GobArchive::readFile(void *data, size_t size)
 	if (size == 0) { size = m_fileList.entries[m_curFile].LEN; }
 	const size_t sizeToRead = std::min(size, (size_t)m_fileList.entries[m_curFile].LEN);
 
-	u32 bytesRead = m_file.readBuffer(data, (u32)sizeToRead);
-	m_fileOffset += (s32)sizeToRead;
+	// The stateful API is a thin wrapper over readFileAt().
+	const size_t bytesRead = readFileAt(u32(m_curFile), size_t(m_fileOffset), data, sizeToRead);
+	m_fileOffset += (s32)bytesRead;
 	return bytesRead;
 }
 
@@ -217,7 +211,6 @@ bool GobArchive::seekFile(s32 offset, s32 origin)
 		return false;
 	}
 
-	m_file.seek(m_fileList.entries[m_curFile].IX + m_fileOffset);
 	return true;
 }
 
@@ -226,6 +219,18 @@ size_t GobArchive::getLocInFile()
 	return m_fileOffset;
 }
 
+size_t GobArchive::readFileAt(u32 index, size_t offset, void* dst, size_t size)
+{
+	if (!m_archiveOpen || index >= m_fileList.MASTERN) { return 0; }
+	return readArchiveAt(m_fileList.entries[index].IX, m_fileList.entries[index].LEN, offset, dst, size);
+}
+
+ArchiveFileView GobArchive::getFileView(u32 index)
+{
+	if (!m_archiveOpen || index >= m_fileList.MASTERN) { return { nullptr, 0 }; }
+	return getMappedRange(m_fileList.entries[index].IX, m_fileList.entries[index].LEN);
+}
+
 // Directory
 u32 GobArchive::getFileCount()
 {
@@ -284,7 +289,8 @@ void GobArchive::addFile(const char* fileName, const char* filePath)
 		file.close();
 	}
 
-	// Now write the new file.
+	// Now write the new file, the archive cannot be mapped or held open for reads while it is being written.
+	closeArchiveData();
 	if (m_file.open(m_archivePath, Stream::MODE_WRITE))
 	{
 		m_file.writeBuffer(&m_header, sizeof(GOB_Header_t));
@@ -297,4 +303,5 @@ void GobArchive::addFile(const char* fileName, const char* filePath)
 		m_file.writeBuffer(m_fileList.entries, sizeof(GOB_Entry_t), m_fileList.MASTERN);
 		m_file.close();
 	}
+	openArchiveData(m_archivePath);
 }
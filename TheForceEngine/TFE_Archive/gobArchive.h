@@ -11,7 +11,7 @@ class GobArchive : public Archive
 public:
 	friend GobMemoryArchive;
 public:
-	GobArchive() : Archive(ARCHIVE_GOB), m_archiveOpen(false), m_curFile(-1) {}
+	GobArchive() : Archive(ARCHIVE_GOB), m_archiveOpen(false), m_fileList{}, m_curFile(-1) {}
 	~GobArchive() override;
 
 	// Archive
@@ -32,6 +32,8 @@ public:
 	size_t readFile(void *data, size_t size) override;
 	bool seekFile(s32 offset, s32 origin = SEEK_SET) override;
 	size_t getLocInFile() override;
+	size_t readFileAt(u32 index, size_t offset, void* dst, size_t size) override;
+	ArchiveFileView getFileView(u32 index) override;
 
 	// Directory
 	u32 getFileCount() override;
@@ -30,7 +30,6 @@ bool GobMemoryArchive::open(const u8* buffer, size_t size)
 	if (!m_buffer) { return false; }
 
 	m_size    = size;
-	m_readLoc = 0;
 
 	const u8* readBuffer = m_buffer;
 	m_header   = (GobArchive::GOB_Header_t*)readBuffer;
@@ -82,10 +81,6 @@ bool GobMemoryArchive::openFile(const char *file)
 	{
 		TFE_System::logWrite(LOG_ERROR, "GOB", "Failed to load \"%s\" from \"%s\"", file, m_archivePath);
 	}
-	else
-	{
-		m_readLoc = m_fileList.entries[m_curFile].IX;
-	}
 	return m_curFile > -1 ? true : false;
 }
 
@@ -95,14 +90,12 @@ bool GobMemoryArchive::openFile(u32 index)
 
 	m_curFile = s32(index);
 	m_fileOffset = 0;
-	m_readLoc = m_fileList.entries[m_curFile].IX;
 	return true;
 }
 
 void GobMemoryArchive::closeFile()
 {
 	m_curFile = -1;
-	m_readLoc = 0;
 }
 
 u32 GobMemoryArchive::getFileIndex(const char* file)
@@ -154,10 +147,9 @@ size_t GobMemoryArchive::readFile(void *data, size_t size)
 	if (size == 0) { size = m_fileList.entries[m_curFile].LEN; }
 	const size_t sizeToRead = std::min(size, (size_t)m_fileList.entries[m_curFile].LEN);
 
-	memcpy(data, m_buffer + m_readLoc, sizeToRead);
-	m_readLoc += sizeToRead;
-	m_fileOffset += (s32)sizeToRead;
-	return sizeToRead;
+	const size_t bytesRead = readFileAt(u32(m_curFile), size_t(m_fileOffset), data, sizeToRead);
+	m_fileOffset += (s32)bytesRead;
+	return bytesRead;
 }
 
 bool GobMemoryArchive::seekFile(s32 offset, s32 origin)
@@ -187,7 +179,6 @@ bool GobMemoryArchive::seekFile(s32 offset, s32 origin)
 		return false;
 	}
 
-	m_readLoc = m_fileList.entries[m_curFile].IX + m_fileOffset;
 	return true;
 }
 
@@ -196,6 +187,24 @@ size_t GobMemoryArchive::getLocInFile()
 	return m_fileOffset;
 }
 
+size_t GobMemoryArchive::readFileAt(u32 index, size_t offset, void* dst, size_t size)
+{
+	const ArchiveFileView view = getFileView(index);
+	if (!view.data || offset >= view.size) { return 0; }
+
+	const size_t sizeToRead = std::min(size, view.size - offset);
+	memcpy(dst, view.data + offset, sizeToRead);
+	return sizeToRead;
+}
+
+ArchiveFileView GobMemoryArchive::getFileView(u32 index)
+{
+	if (!m_archiveOpen || index >= m_fileList.MASTERN) { return { nullptr, 0 }; }
+	const GobArchive::GOB_Entry_t* entry = &m_fileList.entries[index];
+	if (size_t(entry->IX) + size_t(entry->LEN) > m_size) { return { nullptr, 0 }; }
+	return { m_buffer + entry->IX, entry->LEN };
+}
+
 // Directory
 u32 GobMemoryArchive::getFileCount()
 {
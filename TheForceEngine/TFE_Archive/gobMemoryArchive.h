@@ -10,7 +10,7 @@
 class GobMemoryArchive : public Archive
 {
 public:
-	GobMemoryArchive() : Archive(ARCHIVE_GOB), m_buffer(nullptr), m_size(0), m_readLoc(0), m_archiveOpen(false), m_curFile(-1) {}
+	GobMemoryArchive() : Archive(ARCHIVE_GOB), m_buffer(nullptr), m_size(0), m_archiveOpen(false), m_curFile(-1) {}
 	~GobMemoryArchive() override;
 
 	// Archive
@@ -32,6 +32,9 @@ public:
 	size_t readFile(void *data, size_t size) override;
 	bool seekFile(s32 offset, s32 origin = SEEK_SET) override;
 	size_t getLocInFile() override;
+	size_t readFileAt(u32 index, size_t offset, void* dst, size_t size) override;
+	// The whole archive is in memory, so views are always available.
+	ArchiveFileView getFileView(u32 index) override;
 
 	// Directory
 	u32 getFileCount() override;
@@ -44,7 +47,6 @@ public:
 private:
 	const u8* m_buffer;
 	size_t m_size;
-	size_t m_readLoc;
 	bool m_archiveOpen;
 
 	GobArchive::GOB_Header_t* m_header;
@@ -23,7 +23,8 @@ bool LabArchive::open(const char *archivePath)
 	m_fileOffset = 0;
 	if (!m_archiveOpen) { return false; }
 
-	// Read the directory.
+	// Read the directory, the entries and string table directly follow the header.
+	m_file.setBuffered();
 	m_file.readBuffer(&m_header, sizeof(LAB_Header_t));
 	m_stringTable = new char[m_header.stringTableSize + 1];
 	m_entries = new LAB_Entry_t[m_header.fileCount];
@@ -33,7 +34,10 @@ bool LabArchive::open(const char *archivePath)
 
 	// Read string table.
 	m_file.readBuffer(m_stringTable, m_header.stringTableSize);
+	// The directory has been read, so the buffer is no longer needed.
+	m_file.setBuffered(0);
 	m_file.close();
+	openArchiveData(archivePath);
 		
 	strcpy(m_archivePath, archivePath);
 	
@@ -42,10 +46,13 @@ bool LabArchive::open(const char *archivePath)
 
 void LabArchive::close()
 {
+	closeArchiveData();
 	m_file.close();
 	m_archiveOpen = false;
 	delete[] m_entries;
 	delete[] m_stringTable;
+	m_entries = nullptr;
+	m_stringTable = nullptr;
 }
 
 // File Access
@@ -53,7 +60,6 @@ bool LabArchive::openFile(const char *file)
 {
 	if (!m_archiveOpen) { return false; }
 
-	m_file.open(m_archivePath, Stream::MODE_READ);
 	m_curFile = -1;
 	m_fileOffset = 0;
 
@@ -69,13 +75,8 @@ bool LabArchive::openFile(const char *file)
 
 	if (m_curFile == -1)
 	{
-		m_file.close();
 		TFE_System::logWrite(LOG_ERROR, "GOB", "Failed to load \"%s\" from \"%s\"", file, m_archivePath);
 	}
-	else
-	{
-		m_file.seek(m_entries[m_curFile].dataOffset);
-	}
 	return m_curFile > -1 ? true : false;
 }
 
@@ -85,15 +86,12 @@ bool LabArchive::openFile(u32 index)
 
 	m_curFile = s32(index);
 	m_fileOffset = 0;
-	m_file.open(m_archivePath, Stream::MODE_READ);
-	m_file.seek(m_entries[m_curFile].dataOffset);
 	return true;
 }
 
 void LabArchive::closeFile()
 {
 	m_curFile = -1;
-	m_file.close();
 }
 
 u32 LabArchive::getFileIndex(const char* file)
@@ -146,8 +144,9 @@ size_t LabArchive::readFile(void *data, size_t size)
 	if (size == 0) { size = m_entries[m_curFile].len; }
 	const size_t sizeToRead = std::min(size, (size_t)m_entries[m_curFile].len);
 
-	size_t bytesRead = m_file.readBuffer(data, (u32)sizeToRead);
-	m_fileOffset += (s32)sizeToRead;
+	// The stateful API is a thin wrapper over readFileAt().
+	const size_t bytesRead = readFileAt(u32(m_curFile), size_t(m_fileOffset), data, sizeToRead);
+	m_fileOffset += (s32)bytesRead;
 	return bytesRead;
 }
 
@@ -178,7 +177,6 @@ bool LabArchive::seekFile(s32 offset, s32 origin)
 		return false;
 	}
 
-	m_file.seek(m_entries[m_curFile].dataOffset + m_fileOffset);
 	return true;
 }
 
@@ -187,6 +185,18 @@ size_t LabArchive::getLocInFile()
 	return m_fileOffset;
 }
 
+size_t LabArchive::readFileAt(u32 index, size_t offset, void* dst, size_t size)
+{
+	if (!m_archiveOpen || index >= m_header.fileCount) { return 0; }
+	return readArchiveAt(m_entries[index].dataOffset, m_entries[index].len, offset, dst, size);
+}
+
+ArchiveFileView LabArchive::getFileView(u32 index)
+{
+	if (!m_archiveOpen || index >= m_header.fileCount) { return { nullptr, 0 }; }
+	return getMappedRange(m_entries[index].dataOffset, m_entries[index].len);
+}
+
 // Directory
 u32 LabArchive::getFileCount()
 {
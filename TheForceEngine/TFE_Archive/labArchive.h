@@ -7,7 +7,7 @@
 class LabArchive : public Archive
 {
 public:
-	LabArchive() : Archive(ARCHIVE_LAB), m_archiveOpen(false), m_curFile(-1) {}
+	LabArchive() : Archive(ARCHIVE_LAB), m_archiveOpen(false), m_stringTable(nullptr), m_entries(nullptr), m_curFile(-1) {}
 	~LabArchive() override;
 
 	// Archive
@@ -28,6 +28,8 @@ public:
 	size_t readFile(void *data, size_t size) override;
 	bool seekFile(s32 offset, s32 origin = SEEK_SET) override;
 	size_t getLocInFile() override;
+	size_t readFileAt(u32 index, size_t offset, void* dst, size_t size) override;
+	ArchiveFileView getFileView(u32 index) override;
 
 	// Directory
 	u32 getFileCount() override;
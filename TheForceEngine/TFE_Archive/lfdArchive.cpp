@@ -36,7 +36,8 @@ bool LfdArchive::open(const char *archivePath)
 	m_fileOffset = 0;
 	if (!m_archiveOpen) { return false; }
 
-	// Read the directory.
+	// Read the directory, one small entry at a time.
+	m_file.setBuffered();
 	LFD_Entry_t root, entry;
 	m_file.readBuffer(&root, sizeof(LFD_Entry_t));
 	m_fileList.MASTERN = root.LENGTH / sizeof(LFD_Entry_t);
@@ -61,13 +62,17 @@ bool LfdArchive::open(const char *archivePath)
 	}
 
 	strcpy(m_archivePath, archivePath);
+	// The directory has been read, so the buffer is no longer needed.
+	m_file.setBuffered(0);
 	m_file.close();
+	openArchiveData(archivePath);
 
 	return true;
 }
 
 void LfdArchive::close()
 {
+	closeArchiveData();
 	m_file.close();
 	m_archiveOpen = false;
 
@@ -83,7 +88,6 @@ bool LfdArchive::openFile(const char *file)
 {
 	if (!m_archiveOpen) { return false; }
 
-	m_file.open(m_archivePath, Stream::MODE_READ);
 	m_curFile = -1;
 	m_fileOffset = 0;
 
@@ -99,13 +103,8 @@ bool LfdArchive::openFile(const char *file)
 
 	if (m_curFile == -1)
 	{
-		m_file.close();
 		TFE_System::logWrite(LOG_ERROR, "LFD", "Failed to load \"%s\" from \"%s\"", file, m_archivePath);
 	}
-	else
-	{
-		m_file.seek(m_fileList.entries[m_curFile].IX);
-	}
 	return m_curFile > -1 ? true : false;
 }
 
@@ -115,15 +114,12 @@ bool LfdArchive::openFile(u32 index)
 
 	m_curFile = s32(index);
 	m_fileOffset = 0;
-	m_file.open(m_archivePath, Stream::MODE_READ);
-	m_file.seek(m_fileList.entries[m_curFile].IX);
 	return true;
 }
 
 void LfdArchive::closeFile()
 {
 	m_curFile = -1;
-	m_file.close();
 }
 
 u32 LfdArchive::getFileIndex(const char* file)
@@ -176,8 +172,9 @@ size_t LfdArchive::readFile(void *data, size_t size)
 	if (size == 0) { size = m_fileList.entries[m_curFile].LENGTH; }
 	const size_t sizeToRead = std::min(size, (size_t)m_fileList.entries[m_curFile].LENGTH);
 
-	size_t bytesRead = m_file.readBuffer(data, (u32)sizeToRead);
-	m_fileOffset += (s32)sizeToRead;
+	// The stateful API is a thin wrapper over readFileAt().
+	const size_t bytesRead = readFileAt(u32(m_curFile), size_t(m_fileOffset), data, sizeToRead);
+	m_fileOffset += (s32)bytesRead;
 	return bytesRead;
 }
 
@@ -208,7 +205,6 @@ bool LfdArchive::seekFile(s32 offset, s32 origin)
 		return false;
 	}
 
-	m_file.seek(m_fileList.entries[m_curFile].IX + m_fileOffset);
 	return true;
 }
 
@@ -217,6 +213,18 @@ size_t LfdArchive::getLocInFile()
 	return m_fileOffset;
 }
 
+size_t LfdArchive::readFileAt(u32 index, size_t offset, void* dst, size_t size)
+{
+	if (!m_archiveOpen || index >= m_fileList.MASTERN) { return 0; }
+	return readArchiveAt(m_fileList.entries[index].IX, m_fileList.entries[index].LENGTH, offset, dst, size);
+}
+
+ArchiveFileView LfdArchive::getFileView(u32 index)
+{
+	if (!m_archiveOpen || index >= m_fileList.MASTERN) { return { nullptr, 0 }; }
+	return getMappedRange(m_fileList.entries[index].IX, m_fileList.entries[index].LENGTH);
+}
+
 // Directory
 u32 LfdArchive::getFileCount()
 {
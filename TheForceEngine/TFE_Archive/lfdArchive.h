@@ -12,7 +12,7 @@
 class LfdArchive : public Archive
 {
 public:
-	LfdArchive() : Archive(ARCHIVE_LFD), m_archiveOpen(false), m_curFile(-1) {}
+	LfdArchive() : Archive(ARCHIVE_LFD), m_archiveOpen(false), m_fileList{}, m_curFile(-1) {}
 	~LfdArchive() override;
 
 	// Archive
@@ -33,6 +33,8 @@ public:
 	size_t readFile(void *data, size_t size) override;
 	bool seekFile(s32 offset, s32 origin = SEEK_SET) override;
 	size_t getLocInFile() override;
+	size_t readFileAt(u32 index, size_t offset, void* dst, size_t size) override;
+	ArchiveFileView getFileView(u32 index) override;
 
 	// Directory
 	u32 getFileCount() override;
@@ -2,8 +2,12 @@
 #include <TFE_FileSystem/fileutil.h>
 #include <TFE_System/system.h>
 #include "zip/zip.h"
+#define MINIZ_HEADER_FILE_ONLY
+#define MINIZ_NO_ZLIB_COMPATIBLE_NAMES
+#include "zip/miniz.h"
 #include <assert.h>
 #include <string>
+#include <vector>
 #include <algorithm>
 #include <map>
 
@@ -12,11 +16,110 @@ namespace
 	const size_t c_blockShift = 8;	// 256 bytes.
 	const size_t c_blockSize = 1 << c_blockShift;
 
+	// Zip format constants.
+	const u32 c_localHeaderSig = 0x04034b50;
+	const u32 c_centralHeaderSig = 0x02014b50;
+	const u32 c_endOfDirSig = 0x06054b50;
+	const u32 c_zip64EndOfDirSig = 0x06064b50;
+	const u32 c_zip64LocatorSig = 0x07064b50;
+	const size_t c_localHeaderSize = 30;
+	const size_t c_centralHeaderSize = 46;
+	const size_t c_endOfDirSize = 22;
+	const size_t c_zip64EndOfDirSize = 56;
+	const size_t c_zip64LocatorSize = 20;
+	const size_t c_maxCommentSize = 0xffff;
+	const u16 c_zip64ExtraId = 0x0001;
+	const u16 c_methodStored = 0;
+	const u16 c_methodDeflate = 8;
+
+	// Compressed data is streamed in blocks of this size when the archive is not memory mapped.
+	const size_t c_inflateInputSize = 64 * 1024;
+
+	// Decompression state, allocated the first time a thread reads a deflated entry and reused for every read.
+	// The state is heap allocated so threads that never decompress do not pay for it, the owner frees it on thread exit.
+	struct InflateState
+	{
+		tinfl_decompressor decomp;
+		u8 dictionary[TINFL_LZ_DICT_SIZE];
+		u8 input[c_inflateInputSize];
+	};
+	struct InflateStateOwner
+	{
+		InflateState* state = nullptr;
+		~InflateStateOwner() { free(state); }
+	};
+	static thread_local InflateStateOwner s_inflateState;
+
+	InflateState* getInflateState()
+	{
+		if (!s_inflateState.state)
+		{
+			s_inflateState.state = (InflateState*)malloc(sizeof(InflateState));
+		}
+		return s_inflateState.state;
+	}
+
 	size_t roundBufferSize(size_t size)
 	{
 		size = (size + c_blockSize - 1) >> c_blockShift;
 		return size << c_blockShift;
 	}
+
+	u16 read16(const u8* data) { return u16(data[0]) | (u16(data[1]) << 8); }
+	u32 read32(const u8* data) { return u32(read16(data)) | (u32(read16(data + 2)) << 16); }
+	u64 read64(const u8* data) { return u64(read32(data)) | (u64(read32(data + 4)) << 32); }
+
+	// Table driven CRC-32 (slicing-by-4), miniz only provides the much slower nibble version.
+	struct Crc32Table
+	{
+		u32 table[4][256];
+
+		Crc32Table()
+		{
+			for (u32 i = 0; i < 256; i++)
+			{
+				u32 crc = i;
+				for (s32 b = 0; b < 8; b++)
+				{
+					crc = (crc >> 1) ^ ((crc & 1) ? 0xedb88320 : 0);
+				}
+				table[0][i] = crc;
+			}
+			for (u32 i = 0; i < 256; i++)
+			{
+				for (s32 t = 1; t < 4; t++)
+				{
+					table[t][i] = (table[t - 1][i] >> 8) ^ table[0][table[t - 1][i] & 0xff];
+				}
+			}
+		}
+	};
+	static const Crc32Table s_crc32;
+
+	u32 computeCrc32(const u8* data, size_t size)
+	{
+		u32 crc = 0xffffffff;
+		for (; size >= 4; size -= 4, data += 4)
+		{
+			crc ^= read32(data);
+			crc = s_crc32.table[3][crc & 0xff] ^ s_crc32.table[2][(crc >> 8) & 0xff] ^
+			      s_crc32.table[1][(crc >> 16) & 0xff] ^ s_crc32.table[0][crc >> 24];
+		}
+		for (; size > 0; size--, data++)
+		{
+			crc = (crc >> 8) ^ s_crc32.table[0][(crc ^ *data) & 0xff];
+		}
+		return ~crc;
+	}
+
+	void toUpperName(const char* name, std::string& key)
+	{
+		key = name;
+		for (size_t i = 0; i < key.length(); i++)
+		{
+			key[i] = toupper(key[i]);
+		}
+	}
 }
 
 ZipArchive::~ZipArchive()
@@ -35,129 +138,211 @@ bool ZipArchive::create(const char *archivePath)
 
 bool ZipArchive::open(const char *archivePath)
 {
-	m_curFile = INVALID_FILE;
+	close();
 	m_entryCount = 0;
 	m_fileOffset = 0;
-	m_tempBuffer = nullptr;
-	m_tempBufferSize = 0;
 
-	struct zip_t* zip = zip_open(archivePath, 0, 'r');
-	if (!zip)
+	// The archive stays open (or mapped) until close(), so reads do not need to reopen it or parse the directory again.
+	openArchiveData(archivePath);
+	if (!m_mapData && m_readHandle == INVALID_FILE_HANDLE)
 	{
 		TFE_System::logWrite(LOG_ERROR, "zipArchive", "Cannot open Zip Archive '%s'", archivePath);
 		return false;
 	}
 
-	// Read the directory.
-	m_entryCount = zip_total_entries(zip);
-	if (m_entryCount <= 0)
+	strcpy(m_archivePath, archivePath);
+	if (!readDirectory())
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+// Parse the central directory into the entry table.
+bool ZipArchive::readDirectory()
+{
+	const u64 archiveSize = getArchiveDataSize();
+	if (archiveSize < c_endOfDirSize)
+	{
+		TFE_System::logWrite(LOG_ERROR, "zipArchive", "Zip Archive '%s' is invalid.", m_archivePath);
+		return false;
+	}
+
+	// The end of directory record is at the end of the file, followed by an optional comment.
+	const size_t tailSize = size_t(std::min(archiveSize, u64(c_endOfDirSize + c_maxCommentSize)));
+	const u64 tailStart = archiveSize - tailSize;
+	std::vector<u8> tail(tailSize);
+	if (readArchiveAt(tailStart, tailSize, 0, tail.data(), tailSize) != tailSize)
+	{
+		TFE_System::logWrite(LOG_ERROR, "zipArchive", "Cannot read Zip Archive '%s'", m_archivePath);
+		return false;
+	}
+	s64 endOfDir = -1;
+	for (s64 i = s64(tailSize - c_endOfDirSize); i >= 0; i--)
+	{
+		if (read32(&tail[i]) == c_endOfDirSig)
+		{
+			endOfDir = i;
+			break;
+		}
+	}
+	if (endOfDir < 0)
+	{
+		TFE_System::logWrite(LOG_ERROR, "zipArchive", "Zip Archive '%s' is invalid, cannot find the central directory.", m_archivePath);
+		return false;
+	}
+
+	u64 entryCount = read16(&tail[endOfDir + 10]);
+	u64 dirSize = read32(&tail[endOfDir + 12]);
+	u64 dirOffset = read32(&tail[endOfDir + 16]);
+	if ((entryCount == 0xffff || dirSize == 0xffffffff || dirOffset == 0xffffffff) && endOfDir >= s64(c_zip64LocatorSize) &&
+		read32(&tail[endOfDir - c_zip64LocatorSize]) == c_zip64LocatorSig)
+	{
+		// Zip64 archive, the real values are stored in the Zip64 end of directory record.
+		u8 record[c_zip64EndOfDirSize];
+		const u64 recordOffset = read64(&tail[endOfDir - c_zip64LocatorSize + 8]);
+		if (readArchiveAt(recordOffset, c_zip64EndOfDirSize, 0, record, c_zip64EndOfDirSize) != c_zip64EndOfDirSize ||
+			read32(record) != c_zip64EndOfDirSig)
+		{
+			TFE_System::logWrite(LOG_ERROR, "zipArchive", "Zip Archive '%s' has an invalid Zip64 directory.", m_archivePath);
+			return false;
+		}
+		entryCount = read64(record + 32);
+		dirSize = read64(record + 40);
+		dirOffset = read64(record + 48);
+	}
+
+	if (entryCount == 0)
+	{
+		TFE_System::logWrite(LOG_ERROR, "zipArchive", "Zip Archive '%s' is empty.", m_archivePath);
+		return false;
+	}
+	if (dirOffset > archiveSize || dirSize > archiveSize - dirOffset || entryCount > dirSize / c_centralHeaderSize)
+	{
+		TFE_System::logWrite(LOG_ERROR, "zipArchive", "Zip Archive '%s' is invalid, the central directory is out of range.", m_archivePath);
+		return false;
+	}
+
+	std::vector<u8> directory((size_t)dirSize);
+	if (readArchiveAt(dirOffset, dirSize, 0, directory.data(), size_t(dirSize)) != dirSize)
 	{
-		TFE_System::logWrite(LOG_ERROR, "zipArchive", "Zip Archive '%s' is empty.", archivePath);
-		zip_close(zip);
+		TFE_System::logWrite(LOG_ERROR, "zipArchive", "Cannot read the central directory from archive '%s'", m_archivePath);
 		return false;
 	}
+
+	m_entryCount = s32(entryCount);
 	m_entries = new ZipEntry[m_entryCount];
+	m_entryMap.reserve(m_entryCount);
 
+	std::string key;
+	size_t pos = 0;
 	for (s32 i = 0; i < m_entryCount; i++)
 	{
-		if (zip_entry_openbyindex(zip, i) != 0)
+		const u8* header = &directory[pos];
+		if (pos + c_centralHeaderSize > directory.size() || read32(header) != c_centralHeaderSig)
 		{
-			TFE_System::logWrite(LOG_ERROR, "zipArchive", "Cannot read entry '%d' from archive '%s'", i, archivePath);
-			zip_close(zip);
+			TFE_System::logWrite(LOG_ERROR, "zipArchive", "Cannot read entry '%d' from archive '%s'", i, m_archivePath);
+			return false;
+		}
+		const size_t nameLen = read16(header + 28);
+		const size_t extraLen = read16(header + 30);
+		const size_t commentLen = read16(header + 32);
+		if (pos + c_centralHeaderSize + nameLen + extraLen + commentLen > directory.size())
+		{
+			TFE_System::logWrite(LOG_ERROR, "zipArchive", "Cannot read entry '%d' from archive '%s'", i, m_archivePath);
 			return false;
 		}
 
-		m_entries[i].isDir = (zip_entry_isdir(zip) == 1);
-		m_entries[i].name = zip_entry_name(zip);
-		m_entries[i].length = (size_t)zip_entry_size(zip);
-		zip_entry_close(zip);
-	}
-	zip_close(zip);
+		ZipEntry& entry = m_entries[i];
+		entry.method = read16(header + 10);
+		entry.checksum = read32(header + 16);
+		entry.compressedSize = read32(header + 20);
+		u64 length = read32(header + 24);
+		entry.headerOffset = read32(header + 42);
 
-	strcpy(m_archivePath, archivePath);
-	m_fileHandle = nullptr;
+		// Sizes and offsets that do not fit in 32 bits are stored in the Zip64 extra field, in this order.
+		const u8* extra = header + c_centralHeaderSize + nameLen;
+		for (size_t e = 0; e + 4 <= extraLen;)
+		{
+			const u16 id = read16(extra + e);
+			const size_t fieldLen = read16(extra + e + 2);
+			const u8* field = extra + e + 4;
+			const u8* fieldEnd = field + std::min(fieldLen, extraLen - e - 4);
+			if (id == c_zip64ExtraId)
+			{
+				if (length == 0xffffffff && field + 8 <= fieldEnd) { length = read64(field); field += 8; }
+				if (entry.compressedSize == 0xffffffff && field + 8 <= fieldEnd) { entry.compressedSize = read64(field); field += 8; }
+				if (entry.headerOffset == 0xffffffff && field + 8 <= fieldEnd) { entry.headerOffset = read64(field); }
+				break;
+			}
+			e += 4 + fieldLen;
+		}
+		entry.length = size_t(length);
+
+		// Match zip_entry_name(), which converts backslashes to forward slashes.
+		entry.name.assign((const char*)header + c_centralHeaderSize, nameLen);
+		std::replace(entry.name.begin(), entry.name.end(), '\\', '/');
+		const u32 externalAttr = read32(header + 38);
+		entry.isDir = (!entry.name.empty() && entry.name.back() == '/') || (externalAttr & 0x10);
+
+		// Keep the first entry with a given name, like the linear search this replaces.
+		toUpperName(entry.name.c_str(), key);
+		m_entryMap.insert({ key, u32(i) });
 
+		pos += c_centralHeaderSize + nameLen + extraLen + commentLen;
+	}
 	return true;
 }
 
 void ZipArchive::close()
 {
 	closeFile();
+	closeArchiveData();
 
 	delete[] m_entries;
 	m_entries = nullptr;
+	m_entryMap.clear();
+	m_entryCount = 0;
 	m_curFile = INVALID_FILE;
 }
 
 // File Access
 bool ZipArchive::openFile(const char *file)
 {
-	m_curFile = getFileIndex(file);
-	m_fileOffset = 0;
-	if (m_curFile != INVALID_FILE)
-	{
-		m_fileHandle = zip_open(m_archivePath, 0, 'r');
-		if (zip_entry_openbyindex((struct zip_t*)m_fileHandle, m_curFile) != 0)
-		{
-			TFE_System::logWrite(LOG_ERROR, "zipArchive", "Cannot open file '%s' from archive '%s'", file, m_archivePath);
-			m_curFile = INVALID_FILE;
-			zip_close((struct zip_t*)m_fileHandle);
-			m_fileHandle = nullptr;
-		}
-	}
-
-	// Make sure our temp buffer is large enough to hold the entry.
-	if (m_curFile != INVALID_FILE && m_tempBufferSize < m_entries[m_curFile].length)
+	const u32 index = getFileIndex(file);
+	if (index == INVALID_FILE)
 	{
-		m_tempBufferSize = roundBufferSize(m_entries[m_curFile].length);
-		m_tempBuffer = (u8*)realloc(m_tempBuffer, m_tempBufferSize);
+		TFE_System::logWrite(LOG_ERROR, "zipArchive", "Cannot open file '%s' from archive '%s'", file, m_archivePath);
+		m_curFile = INVALID_FILE;
+		return false;
 	}
-	m_entryRead = false;
-
-	return m_curFile != INVALID_FILE;
+	return openFile(index);
 }
 
 bool ZipArchive::openFile(u32 index)
 {
 	m_curFile = INVALID_FILE;
 	m_fileOffset = 0;
-	if (index <= (u32)m_entryCount)
-	{
-		// Open the system file.
-		m_fileHandle = zip_open(m_archivePath, 0, 'r');
-		// Open the file entry itself.
-		m_curFile = index;
-		if (zip_entry_openbyindex((struct zip_t*)m_fileHandle, index) != 0)
-		{
-			TFE_System::logWrite(LOG_ERROR, "zipArchive", "Cannot open file '%s' from archive '%s'", m_entries[index].name.c_str(), m_archivePath);
-			m_curFile = INVALID_FILE;
-			zip_close((struct zip_t*)m_fileHandle);
-			m_fileHandle = nullptr;
-		}
-	}
+	m_entryRead = false;
+	if (index >= (u32)m_entryCount) { return false; }
+
+	// The entry is decompressed when it is read, see readFileAt().
+	m_curFile = index;
 
 	// Make sure our temp buffer is large enough to hold the entry.
-	if (m_curFile != INVALID_FILE && m_tempBufferSize < m_entries[m_curFile].length)
+	if (m_tempBufferSize < m_entries[m_curFile].length)
 	{
 		m_tempBufferSize = roundBufferSize(m_entries[m_curFile].length);
 		m_tempBuffer = (u8*)realloc(m_tempBuffer, m_tempBufferSize);
 	}
-	m_entryRead = false;
-
-	return m_curFile != INVALID_FILE;
+	return true;
 }
 
 void ZipArchive::closeFile()
 {
-	if (m_fileHandle)
-	{
-		// Close the file entry.
-		zip_entry_close((struct zip_t*)m_fileHandle);
-		// Close the system file.
-		zip_close((struct zip_t*)m_fileHandle);
-		m_fileHandle = nullptr;
-	}
 	m_curFile = INVALID_FILE;
+	m_entryRead = false;
 }
 
 bool ZipArchive::fileExists(const char *file)
@@ -172,14 +357,10 @@ bool ZipArchive::fileExists(u32 index)
 
 u32 ZipArchive::getFileIndex(const char* file)
 {
-	for (s32 i = 0; i < m_entryCount; i++)
-	{
-		if (strcasecmp(file, m_entries[i].name.c_str()) == 0)
-		{
-			return i;
-		}
-	}
-	return INVALID_FILE;
+	std::string key;
+	toUpperName(file, key);
+	EntryMap::const_iterator iEntry = m_entryMap.find(key);
+	return iEntry != m_entryMap.end() ? iEntry->second : INVALID_FILE;
 }
 
 size_t ZipArchive::getFileLength()
@@ -199,12 +380,7 @@ size_t ZipArchive::readFile(void* data, size_t size)
 	if (m_fileOffset == 0 && sizeToRead == m_entries[m_curFile].length)
 	{
 		m_fileOffset += (s32)sizeToRead;
-		s64 actualSizeRead = zip_entry_noallocread((struct zip_t*)m_fileHandle, data, sizeToRead);
-		if (actualSizeRead <= 0)
-		{
-			return 0u;
-		}
-		return size_t(actualSizeRead);
+		return readFileAt(m_curFile, 0, data, sizeToRead);
 	}
 
 	// Otherwise go through the slower path - a one time decompression and read, followed
@@ -213,16 +389,18 @@ size_t ZipArchive::readFile(void* data, size_t size)
 	{
 		// Read the whole entry into temporary memory.
 		assert(m_tempBufferSize >= m_entries[m_curFile].length);
-		if (zip_entry_noallocread((struct zip_t*)m_fileHandle, m_tempBuffer, m_entries[m_curFile].length) <= 0)
+		if (readFileAt(m_curFile, 0, m_tempBuffer, m_entries[m_curFile].length) == 0)
 		{
 			return 0u;
 		}
 		m_entryRead = true;
 	}
 	// Then copy the section we want into the output.
-	memcpy(data, m_tempBuffer + m_fileOffset, sizeToRead);
-	m_fileOffset += (s32)sizeToRead;
-	return sizeToRead;
+	if (size_t(m_fileOffset) >= m_entries[m_curFile].length) { return 0u; }
+	const size_t bytesRead = std::min(sizeToRead, m_entries[m_curFile].length - size_t(m_fileOffset));
+	memcpy(data, m_tempBuffer + m_fileOffset, bytesRead);
+	m_fileOffset += (s32)bytesRead;
+	return bytesRead;
 }
 
 bool ZipArchive::seekFile(s32 offset, s32 origin)
@@ -259,6 +437,136 @@ size_t ZipArchive::getLocInFile()
 	return m_fileOffset;
 }
 
+size_t ZipArchive::readFileAt(u32 index, size_t offset, void* dst, size_t size)
+{
+	if (index >= (u32)m_entryCount || offset >= m_entries[index].length) { return 0u; }
+	const ZipEntry& entry = m_entries[index];
+	const size_t sizeToRead = std::min(size, entry.length - offset);
+
+	const u64 dataStart = getEntryDataOffset(entry);
+	if (dataStart == 0)
+	{
+		TFE_System::logWrite(LOG_ERROR, "zipArchive", "Cannot open file '%s' from archive '%s'", entry.name.c_str(), m_archivePath);
+		return 0u;
+	}
+
+	// Stored entries are read directly, at any offset.
+	if (entry.method == c_methodStored)
+	{
+		return readArchiveAt(dataStart, entry.length, offset, dst, sizeToRead);
+	}
+	else if (entry.method == c_methodDeflate)
+	{
+		return inflateEntry(entry, dataStart, offset, (u8*)dst, sizeToRead);
+	}
+	TFE_System::logWrite(LOG_ERROR, "zipArchive", "File '%s' in archive '%s' uses unsupported compression method %u", entry.name.c_str(), m_archivePath, entry.method);
+	return 0u;
+}
+
+ArchiveFileView ZipArchive::getFileView(u32 index)
+{
+	if (!m_mapData || index >= (u32)m_entryCount || m_entries[index].method != c_methodStored) { return { nullptr, 0 }; }
+	const u64 dataStart = getEntryDataOffset(m_entries[index]);
+	if (dataStart == 0) { return { nullptr, 0 }; }
+	return getMappedRange(dataStart, m_entries[index].length);
+}
+
+// Returns the offset of the entry data in the archive, or 0 if the local header is invalid.
+u64 ZipArchive::getEntryDataOffset(const ZipEntry& entry) const
+{
+	u8 header[c_localHeaderSize];
+	if (readArchiveAt(entry.headerOffset, c_localHeaderSize, 0, header, c_localHeaderSize) != c_localHeaderSize ||
+		read32(header) != c_localHeaderSig)
+	{
+		return 0;
+	}
+	return entry.headerOffset + c_localHeaderSize + read16(header + 26) + read16(header + 28);
+}
+
+// Decompress [offset, offset + size) of a deflated entry into 'dst', returns the number of bytes read.
+// Deflate streams can only be decoded from the start, but decoding stops once the requested range has been produced.
+size_t ZipArchive::inflateEntry(const ZipEntry& entry, u64 dataStart, size_t offset, u8* dst, size_t size) const
+{
+	InflateState* state = getInflateState();
+	if (!state) { return 0u; }
+	tinfl_init(&state->decomp);
+
+	// Mapped archives decompress straight from the mapping, otherwise the compressed data is read in blocks.
+	const u8* input = nullptr;
+	size_t inputAvail = 0;
+	u64 inputPos = 0;
+	if (m_mapData)
+	{
+		const ArchiveFileView view = getMappedRange(dataStart, entry.compressedSize);
+		if (!view.data) { return 0u; }
+		input = view.data;
+		inputAvail = view.size;
+		inputPos = entry.compressedSize;
+	}
+
+	// Reading the whole entry decompresses directly into 'dst', otherwise the data goes through the
+	// dictionary (a ring buffer) and the requested range is copied out.
+	const bool direct = (offset == 0 && size == entry.length);
+	u8* outStart = direct ? dst : state->dictionary;
+	const size_t outCapacity = direct ? size : TINFL_LZ_DICT_SIZE;
+	size_t outPos = 0;
+	size_t produced = 0;
+	const size_t end = offset + size;
+
+	tinfl_status status = TINFL_STATUS_NEEDS_MORE_INPUT;
+	while (produced < end)
+	{
+		if (inputAvail == 0 && inputPos < entry.compressedSize)
+		{
+			const size_t blockSize = size_t(std::min(u64(c_inflateInputSize), entry.compressedSize - inputPos));
+			if (FileUtil::readAt(m_readHandle, dataStart + inputPos, state->input, blockSize) != blockSize) { break; }
+			input = state->input;
+			inputAvail = blockSize;
+			inputPos += blockSize;
+		}
+
+		const bool moreInput = inputPos < entry.compressedSize;
+		size_t inSize = inputAvail;
+		size_t outSize = outCapacity - outPos;
+		status = tinfl_decompress(&state->decomp, input, &inSize, outStart, outStart + outPos, &outSize,
+			(direct ? TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF : 0) | (moreInput ? TINFL_FLAG_HAS_MORE_INPUT : 0));
+		input += inSize;
+		inputAvail -= inSize;
+
+		if (!direct)
+		{
+			// Copy the part of the new output that overlaps the requested range.
+			const size_t copyStart = std::max(produced, offset);
+			const size_t copyEnd = std::min(produced + outSize, end);
+			if (copyStart < copyEnd)
+			{
+				memcpy(dst + copyStart - offset, outStart + outPos + (copyStart - produced), copyEnd - copyStart);
+			}
+			outPos = (outPos + outSize) & (TINFL_LZ_DICT_SIZE - 1);
+		}
+		else
+		{
+			outPos += outSize;
+		}
+		produced += outSize;
+
+		if (status <= TINFL_STATUS_DONE || (inSize == 0 && outSize == 0)) { break; }
+	}
+
+	if (status < TINFL_STATUS_DONE || produced < end)
+	{
+		TFE_System::logWrite(LOG_ERROR, "zipArchive", "Cannot decompress file '%s' from archive '%s'", entry.name.c_str(), m_archivePath);
+		return 0u;
+	}
+	// The checksum covers the whole entry, so it can only be verified on full reads.
+	if (direct && computeCrc32(dst, size) != entry.checksum)
+	{
+		TFE_System::logWrite(LOG_ERROR, "zipArchive", "CRC mismatch reading file '%s' from archive '%s'", entry.name.c_str(), m_archivePath);
+		return 0u;
+	}
+	return size;
+}
+
 // Directory
 u32 ZipArchive::getFileCount()
 {
@@ -280,4 +588,4 @@ size_t ZipArchive::getFileLength(u32 index)
 // Edit
 void ZipArchive::addFile(const char* fileName, const char* filePath)
 {
-}
\ No newline at end of file
+}
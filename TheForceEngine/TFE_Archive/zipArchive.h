@@ -1,11 +1,12 @@
 #pragma once
 #include "archive.h"
 #include <string>
+#include <unordered_map>
 
 class ZipArchive : public Archive
 {
 public:
-	ZipArchive() : Archive(ARCHIVE_ZIP), m_entryCount(0), m_curFile(INVALID_FILE), m_entries(nullptr), m_fileHandle(nullptr) {}
+	ZipArchive() : Archive(ARCHIVE_ZIP), m_entryCount(0), m_curFile(INVALID_FILE), m_entries(nullptr), m_entryRead(false) {}
 	~ZipArchive() override;
 
 	// Archive
@@ -26,6 +27,9 @@ public:
 	size_t readFile(void *data, size_t size) override;
 	bool seekFile(s32 offset, s32 origin = SEEK_SET) override;
 	size_t getLocInFile() override;
+	size_t readFileAt(u32 index, size_t offset, void* dst, size_t size) override;
+	// Only stored (uncompressed) entries in a memory mapped archive have views.
+	ArchiveFileView getFileView(u32 index) override;
 
 	// Directory
 	u32 getFileCount() override;
@@ -40,13 +44,23 @@ private:
 	{
 		std::string name;
 		size_t length;
+		u64 compressedSize;
+		u64 headerOffset;	// Offset of the local header, the data follows the variable length header.
+		u32 checksum;		// CRC-32 of the uncompressed data.
+		u16 method;
 		bool isDir;
 	};
+	// Upper case entry name -> entry index.
+	typedef std::unordered_map<std::string, u32> EntryMap;
+
+	bool readDirectory();
+	u64 getEntryDataOffset(const ZipEntry& entry) const;
+	size_t inflateEntry(const ZipEntry& entry, u64 dataStart, size_t offset, u8* dst, size_t size) const;
 
 	s32 m_entryCount;
 	u32 m_curFile;
 	ZipEntry* m_entries;
-	void* m_fileHandle;
+	EntryMap m_entryMap;
 
 	u8* m_tempBuffer = nullptr;
 	size_t m_tempBufferSize = 0;
@@ -235,4 +235,5 @@ enum KEYWORD
 	KW_COUNT
 };
 
-extern KEYWORD getKeywordIndex(const char* keywordString);
\ No newline at end of file
+extern KEYWORD getKeywordIndex(const char* keywordString);
+extern void keyword_test();
\ No newline at end of file
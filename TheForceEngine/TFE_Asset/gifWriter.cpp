@@ -1,6 +1,7 @@
 #include "gifWriter.h"
 #include <TFE_System/system.h>
 #include <TFE_FileSystem/filestream.h>
+#include <TFE_FileSystem/filewriterAsync.h>
 #include <TFE_FileSystem/paths.h>
 #include <assert.h>
 #include <algorithm>
@@ -52,17 +53,10 @@ namespace TFE_GIF
 	bool write()
 	{
 		MsfGifResult result = msf_gif_end(&s_gifState);
-		
-		FileStream file;
-		if (!file.open(s_path, Stream::MODE_WRITE))
-		{
-			msf_gif_free(result);
-			return false;
-		}
-		file.writeBuffer(result.data, (u32)result.dataSize);
-		file.close();
 
+		// The data is copied, so it can be freed right away.
+		const bool queued = FileWriterAsync::writeFileToDisk(s_path, (const u8*)result.data, result.dataSize);
 		msf_gif_free(result);
-		return true;
+		return queued;
 	}
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <TFE_System/system.h>
 #include <TFE_Asset/assetSystem.h>
 #include <TFE_Archive/archive.h>
+#include <TFE_FileSystem/filewriterAsync.h>
 #include <TFE_FileSystem/memorystream.h>
 #include <assert.h>
 #include <algorithm>
@@ -21,6 +22,7 @@ namespace TFE_Image
 	typedef std::map<std::string, SDL_Surface*> ImageMap;
 	static ImageMap s_images;
 	static std::vector<u8> s_buffer;
+	static std::vector<u8> s_pngBuffer;
 
 	static SDL_Surface* convertToRGBA(SDL_Surface* src)
 	{
@@ -158,6 +160,40 @@ namespace TFE_Image
 		return dstBuffer;
 	}
 
+	//////////////////////////////////////////////////////
+	// Write-only RWops that appends to s_pngBuffer.
+	//////////////////////////////////////////////////////
+	static Sint64 SDLCALL _sdl_size_vector(SDL_RWops* context)
+	{
+		return Sint64(((std::vector<u8>*)context->hidden.unknown.data1)->size());
+	}
+
+	static Sint64 SDLCALL _sdl_seek_vector(SDL_RWops* context, Sint64 offset, int whence)
+	{
+		// Only reporting the current position is supported, which is always the end.
+		if (offset != 0 || whence != RW_SEEK_CUR) { return -1; }
+		return _sdl_size_vector(context);
+	}
+
+	static size_t SDLCALL _sdl_rop_vector(SDL_RWops* context, void* ptr, size_t size, size_t num)
+	{
+		return 0;
+	}
+
+	static size_t SDLCALL _sdl_wop_vector(SDL_RWops* context, const void* ptr, size_t size, size_t num)
+	{
+		std::vector<u8>* buffer = (std::vector<u8>*)context->hidden.unknown.data1;
+		const u8* src = (const u8*)ptr;
+		buffer->insert(buffer->end(), src, src + size * num);
+		return num;
+	}
+
+	static int SDLCALL _sdl_close_vector(SDL_RWops* context)
+	{
+		SDL_FreeRW(context);
+		return 0;
+	}
+
 	void writeImage(const char* path, u32 width, u32 height, u32* pixelData)
 	{
 		// TODO: This seems to be specific to the PBO/capture path, so the flip should really happen there.
@@ -171,10 +207,28 @@ namespace TFE_Image
 			TFE_System::logWrite(LOG_ERROR, "writeImage", "Saving PNG '%s' - cannot allocate surface", path);
 			return;
 		}
-		if (IMG_SavePNG(surf, path) != 0)
+		// Encode to memory and leave the file write to the I/O thread.
+		s_pngBuffer.clear();
+		SDL_RWops* pngOps = SDL_AllocRW();
+		if (pngOps)
+		{
+			pngOps->size  = _sdl_size_vector;
+			pngOps->seek  = _sdl_seek_vector;
+			pngOps->read  = _sdl_rop_vector;
+			pngOps->write = _sdl_wop_vector;
+			pngOps->close = _sdl_close_vector;
+			pngOps->type  = SDL_RWOPS_UNKNOWN;
+			pngOps->hidden.unknown.data1 = &s_pngBuffer;
+		}
+		if (!pngOps || IMG_SavePNG_RW(surf, pngOps, 1) != 0)
 		{
 			TFE_System::logWrite(LOG_ERROR, "writeImage", "Saving PNG '%s' failed with '%s'", path, SDL_GetError());
 		}
+		else
+		{
+			FileWriterAsync::writeFileToDisk(path, s_pngBuffer.data(), s_pngBuffer.size());
+		}
+		SDL_FreeSurface(surf);
 	}
 
 	//////////////////////////////////////////////////////
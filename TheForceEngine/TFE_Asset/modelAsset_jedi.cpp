@@ -162,7 +162,10 @@ namespace TFE_Model_Jedi
 	static ModelMap s_models[POOL_COUNT];
 	static ModelList s_modelList[POOL_COUNT];
 	static NameList s_modelNames[POOL_COUNT];
-	static std::vector<char> s_buffer;
+	static std::vector<u8> s_buffer;
+	// The model file being parsed, either in s_buffer or in a memory mapped archive.
+	static const char* s_modelData = nullptr;
+	static size_t s_modelSize = 0;
 
 	// Remove 3DO limits.
 	static std::vector<vec2> s_tmpVtx;
@@ -183,15 +186,11 @@ namespace TFE_Model_Jedi
 		{
 			return nullptr;
 		}
-		FileStream file;
-		if (!file.open(&filePath, Stream::MODE_READ))
+		s_modelData = (const char*)FileStream::readContentsView(&filePath, s_buffer, &s_modelSize);
+		if (!s_modelData)
 		{
 			return nullptr;
 		}
-		size_t len = file.getSize();
-		s_buffer.resize(len);
-		file.readBuffer(s_buffer.data(), u32(len));
-		file.close();
 			
 		s_memRegion = (pool == POOL_GAME) ? s_gameRegion : s_levelRegion;
 		JediModel* model = (JediModel*)model_alloc(sizeof(JediModel));
@@ -361,10 +360,34 @@ namespace TFE_Model_Jedi
 		polygon->indices = (s32*)model_alloc(vertexCount * sizeof(s32));
 	}
 	
+	// The vertex and polygon lines have the form " %d: <values>", these are parsed without sscanf() since
+	// they make up nearly all of the file. Return false if the line does not match, like sscanf() would.
+	bool parseIndexedInts(const char*& line, s32* values, s32 count)
+	{
+		s32 index;
+		if (!TFE_Parser::parseInt(line, &index) || !TFE_Parser::matchLiteral(line, ":")) { return false; }
+		for (s32 i = 0; i < count; i++)
+		{
+			if (!TFE_Parser::parseInt(line, &values[i])) { return false; }
+		}
+		return true;
+	}
+
+	bool parseIndexedFloats(const char* line, f32* values, s32 count)
+	{
+		s32 index;
+		if (!TFE_Parser::parseInt(line, &index) || !TFE_Parser::matchLiteral(line, ":")) { return false; }
+		for (s32 i = 0; i < count; i++)
+		{
+			if (!TFE_Parser::parseFloat(line, &values[i])) { return false; }
+		}
+		return true;
+	}
+
 	bool parseModel(JediModel* model, const char* name, AssetPool pool)
 	{
-		if (s_buffer.empty()) { return false; }
-		const size_t len = s_buffer.size();
+		if (!s_modelData || !s_modelSize) { return false; }
+		const size_t len = s_modelSize;
 
 		model->isBridge = 0;
 		model->vertexCount = 0;
@@ -393,8 +416,8 @@ namespace TFE_Model_Jedi
 
 		TFE_Parser parser;
 		size_t bufferPos = 0;
-		parser.init(s_buffer.data(), len);
-		const char* fileBuffer = s_buffer.data();
+		parser.init(s_modelData, len);
+		const char* fileBuffer = s_modelData;
 		parser.addCommentString("#");
 
 		// For now just do what the original code does.
@@ -584,16 +607,15 @@ namespace TFE_Model_Jedi
 					break;
 				}
 
-				s32 index;
-				f32 x, y, z;
-				if (sscanf(buffer, " %d: %f %f %f", &index, &x, &y, &z) != 4)
+				f32 pos[3];
+				if (!parseIndexedFloats(buffer, pos, 3))
 				{
 					nextLine = false;
 					break;
 				}
-				model->vertices[model->vertexCount].x = floatToFixed16(x);
-				model->vertices[model->vertexCount].y = floatToFixed16(y);
-				model->vertices[model->vertexCount].z = floatToFixed16(z);
+				model->vertices[model->vertexCount].x = floatToFixed16(pos[0]);
+				model->vertices[model->vertexCount].y = floatToFixed16(pos[1]);
+				model->vertices[model->vertexCount].z = floatToFixed16(pos[2]);
 				model->vertexCount++;
 			}
 
@@ -618,17 +640,19 @@ namespace TFE_Model_Jedi
 						break;
 					}
 
-					s32 num, a, b, c, color;
+					s32 values[4];
 					char shading[32];
-					if (sscanf(buffer, " %d: %d %d %d %d %s ", &num, &a, &b, &c, &color, shading) != 6)
+					const char* str = buffer;
+					if (!parseIndexedInts(str, values, 4) || !TFE_Parser::parseWord(str, shading, sizeof(shading)))
 					{
 						nextLine = false;
 						break;
 					}
 
-					a += vertexOffset;
-					b += vertexOffset;
-					c += vertexOffset;
+					const s32 a = values[0] + vertexOffset;
+					const s32 b = values[1] + vertexOffset;
+					const s32 c = values[2] + vertexOffset;
+					const s32 color = values[3];
 
 					JmPolygon* polygon = &model->polygons[model->polygonCount];
 					allocatePolygon(polygon, 3);
@@ -689,17 +713,19 @@ namespace TFE_Model_Jedi
 						break;
 					}
 
-					s32 num, a, b, c, d, color;
+					s32 values[5];
 					char shading[32];
-					if (sscanf(buffer, " %d: %d %d %d %d %d %s", &num, &a, &b, &c, &d, &color, shading) != 7)
+					const char* str = buffer;
+					if (!parseIndexedInts(str, values, 5) || !TFE_Parser::parseWord(str, shading, sizeof(shading)))
 					{
 						nextLine = false;
 						break;
 					}
-					a += vertexOffset;
-					b += vertexOffset;
-					c += vertexOffset;
-					d += vertexOffset;
+					const s32 a = values[0] + vertexOffset;
+					const s32 b = values[1] + vertexOffset;
+					const s32 c = values[2] + vertexOffset;
+					const s32 d = values[3] + vertexOffset;
+					const s32 color = values[4];
 
 					JmPolygon* polygon = &model->polygons[model->polygonCount];
 					allocatePolygon(polygon, 4);
@@ -789,14 +815,14 @@ namespace TFE_Model_Jedi
 						s_tmpVtx.resize(v * 2);
 					}
 
-					s32 num;
-					f32 x, y;
-					if (sscanf(buffer, " %d: %f %f", &num, &x, &y) != 3)
+					f32 uv[2];
+					if (!parseIndexedFloats(buffer, uv, 2))
 					{
 						// Handle buggy input data.
 						nextLine = false;
 						break;
 					}
+					f32 x = uv[0], y = uv[1];
 					// clamp texture coordinate range.
 					if (x < 0.0f) { x = 0.0f; }
 					if (y < 0.0f) { y = 0.0f; }
@@ -824,12 +850,14 @@ namespace TFE_Model_Jedi
 						buffer = parser.readLine(bufferPos, true);
 						if (!buffer) { break; }
 
-						s32 num, a, b, c;
-						if (sscanf(buffer, " %d: %d %d %d", &num, &a, &b, &c) != 4)
+						s32 index[3];
+						const char* str = buffer;
+						if (!parseIndexedInts(str, index, 3))
 						{
 							nextLine = false;
 							break;
 						}
+						const s32 a = index[0], b = index[1], c = index[2];
 
 						polygon->uv   = (vec2*)model_alloc(sizeof(vec2) * 3);
 						fixed16_16 texWidth  = intToFixed16(texture->uvWidth);
@@ -853,12 +881,14 @@ namespace TFE_Model_Jedi
 						buffer = parser.readLine(bufferPos, true);
 						if (!buffer) { break; }
 
-						s32 num, a, b, c, d;
-						if (sscanf(buffer, " %d: %d %d %d %d", &num, &a, &b, &c, &d) != 5)
+						s32 index[4];
+						const char* str = buffer;
+						if (!parseIndexedInts(str, index, 4))
 						{
 							nextLine = false;
 							break;
 						}
+						const s32 a = index[0], b = index[1], c = index[2], d = index[3];
 						polygon->uv = (vec2*)model_alloc(sizeof(vec2) * 4);
 						fixed16_16 texWidth = intToFixed16(texture->uvWidth);
 						fixed16_16 texHeight = intToFixed16(texture->uvHeight);
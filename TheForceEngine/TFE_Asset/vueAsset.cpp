@@ -115,25 +115,26 @@ namespace TFE_VueAsset
 			const char* line = parser.readLine(bufferPos);
 			if (!line) { break; }
 
-			TokenList tokens;
-			parser.tokenizeLine(line, tokens);
-			if (tokens.size() < 1) { continue; }
+			// A transform line has 14 tokens, anything past that is ignored.
+			TokenView tokens[16];
+			const s32 tokenCount = parser.tokenizeLine(line, tokens, 16);
+			if (tokenCount < 1) { continue; }
 
-			char* endPtr = nullptr;
-			if (strcasecmp("frame", tokens[0].c_str()) == 0)
+			if (TFE_Parser::tokenEquals(tokens[0], "frame"))
 			{
 				frameIndex++;
 				s32 frameId = frameIndex;
-				if (tokens.size() > 1u)
+				if (tokenCount > 1)
 				{
-					frameId = strtol(tokens[1].c_str(), &endPtr, 10);
+					const char* value = tokens[1].str;
+					if (!TFE_Parser::parseInt(value, &frameId)) { frameId = 0; }
 				}
 				// Are we allowed to skip frames?
 				assert(frameId == frameIndex);
 				transformIndex = 0;
 				frameCount++;
 			}
-			else if (strcasecmp("transform", tokens[0].c_str()) == 0)
+			else if (TFE_Parser::tokenEquals(tokens[0], "transform"))
 			{
 				// if no frame is specified, then assume that this is a frame.
 				if (frameIndex < 0)
@@ -141,34 +142,36 @@ namespace TFE_VueAsset
 					frameIndex++;
 					frameCount++;
 				}
-				assert(tokens.size() == 14u);
-				const char* transformName = tokens.size() > 1 ? tokens[1].c_str() : "";
+				assert(tokenCount == 14);
+				const TokenView transformName = tokenCount > 1 ? tokens[1] : TokenView{ "", 0 };
 				Mat3 rotScale = { 1, 0, 0, 0, 1, 0, 0, 0, 1 };
-				if (tokens.size() > 10)
+				if (tokenCount > 10)
 				{
 					for (u32 i = 0; i < 9; i++)
 					{
 						Vec3f& row = rotScale.m[i / 3];
-						row.m[i % 3] = (f32)strtod(tokens[2 + i].c_str(), &endPtr);
+						const char* value = tokens[2 + i].str;
+						if (!TFE_Parser::parseFloat(value, &row.m[i % 3])) { row.m[i % 3] = 0.0f; }
 					}
 				}
 				Vec3f translation = { 0 };
-				if (tokens.size() > 13)
+				if (tokenCount > 13)
 				{
 					for (u32 i = 0; i < 3; i++)
 					{
-						translation.m[i] = (f32)strtod(tokens[11 + i].c_str(), &endPtr);
+						const char* value = tokens[11 + i].str;
+						if (!TFE_Parser::parseFloat(value, &translation.m[i])) { translation.m[i] = 0.0f; }
 					}
 					translation.y = -translation.y;
 				}
 				
 				if (frameIndex == 0)
 				{
-					transformNames.push_back(transformName);
+					transformNames.push_back(std::string(transformName.str, transformName.len));
 				}
 				else
 				{
-					assert(strcasecmp(transformNames[transformIndex].c_str(), transformName) == 0);
+					assert(TFE_Parser::tokenEquals(transformName, transformNames[transformIndex].c_str()));
 				}
 				transforms.push_back({ rotScale, translation });
 				transformIndex++;
@@ -29,6 +29,9 @@
 #include <TFE_Jedi/Memory/list.h>
 #include <TFE_Jedi/Memory/allocator.h>
 #include <TFE_Jedi/Serialization/serialization.h>
+#include <TFE_Jedi/Renderer/rcommon.h>
+#include <TFE_Settings/settings.h>
+#include <TFE_System/profiler.h>
 
 using namespace TFE_Jedi;
 
@@ -40,6 +43,27 @@ namespace TFE_DarkForces
 	ActorInternalState s_istate = { 0 };
 	List* s_physicsActors = nullptr;
 
+	// Simulation LOD (TFE, see actor_getLodCategory()).
+	enum ActorLodCategory
+	{
+		ACTOR_LOD_IDLE = 0,		// waiting to be woken up, only the cheap visibility check runs.
+		ACTOR_LOD_FULL,			// updated every tick.
+		ACTOR_LOD_REDUCED,		// updated this tick with the accumulated delta time.
+		ACTOR_LOD_SKIPPED,		// update deferred.
+		ACTOR_LOD_COUNT
+	};
+
+	enum ActorLodConstants
+	{
+		ACTOR_LOD_DIST        = FIXED(120),	// actors closer than this always update at full rate.
+		ACTOR_LOD_INTERVAL    = 16,			// ticks between updates at reduced rate (~9 Hz).
+		ACTOR_LOD_ALERT_TIME  = 1456,		// ticks of full rate updates after being alerted or damaged (~10 seconds).
+		ACTOR_LOD_DRAW_FRAMES = 2,			// a sector drawn within this many frames counts as visible.
+	};
+
+	static JBool s_actorSimLod = JFALSE;
+	static s32 s_actorLodCount[ACTOR_LOD_COUNT] = { 0 };
+
 	///////////////////////////////////////////
 	// Shared State
 	///////////////////////////////////////////
@@ -172,6 +196,11 @@ namespace TFE_DarkForces
 		s_istate.actorDispatch = allocator_create(sizeof(ActorDispatch));
 		s_istate.actorTask = createSubTask("actor", actorLogicTaskFunc, actorLogicMsgFunc);
 		s_istate.actorPhysicsTask = createSubTask("physics", actorPhysicsTaskFunc);
+
+		TFE_COUNTER(s_actorLodCount[ACTOR_LOD_IDLE],    "Actors Idle");
+		TFE_COUNTER(s_actorLodCount[ACTOR_LOD_FULL],    "Actors Full Rate");
+		TFE_COUNTER(s_actorLodCount[ACTOR_LOD_REDUCED], "Actors Reduced Rate");
+		TFE_COUNTER(s_actorLodCount[ACTOR_LOD_SKIPPED], "Actors Skipped");
 	}
 
 	ActorDispatch* actor_createDispatch(SecObject* obj, LogicSetupFunc* setupFunc)
@@ -192,6 +221,8 @@ namespace TFE_DarkForces
 		dispatch->lastPlayerPos = { 0 };
 		dispatch->freeTask = nullptr;
 		dispatch->flags = 4;
+		dispatch->lodTick = 0;
+		dispatch->lodAlertTick = 0;
 
 		if (obj)
 		{
@@ -1875,6 +1906,11 @@ namespace TFE_DarkForces
 		ActorDispatch* dispatch = (ActorDispatch*)logic;
 		s_actorState.curLogic = (Logic*)logic;
 		SecObject* obj = s_actorState.curLogic->obj;
+		if (msg == MSG_WAKEUP || msg == MSG_DAMAGE || msg == MSG_EXPLOSION)
+		{
+			// Alerted actors go back to full rate simulation.
+			dispatch->lodAlertTick = s_curTick;
+		}
 		for (s32 i = 0; i < ACTOR_MAX_MODULES; i++)
 		{
 			ActorModule* module = dispatch->modules[ACTOR_MAX_MODULES - 1 - i];
@@ -2022,6 +2058,27 @@ namespace TFE_DarkForces
 		}
 	}
 
+	// Added for TFE: optional simulation LOD, disabled by default to keep vanilla behavior.
+	// Actors far from the player in sectors that were not drawn recently are updated every ACTOR_LOD_INTERVAL ticks
+	// with the accumulated delta time.
+	ActorLodCategory actor_getLodCategory(ActorDispatch* dispatch, SecObject* obj)
+	{
+		const Tick prevTick = dispatch->lodTick;
+		if (!s_actorSimLod || !s_playerObject || !prevTick || s_curTick - dispatch->lodAlertTick < ACTOR_LOD_ALERT_TIME)
+		{
+			return ACTOR_LOD_FULL;
+		}
+		if (obj->sector && s_drawFrame - obj->sector->prevDrawFrame2 <= ACTOR_LOD_DRAW_FRAMES)
+		{
+			return ACTOR_LOD_FULL;
+		}
+		if (distApprox(obj->posWS.x, obj->posWS.z, s_playerObject->posWS.x, s_playerObject->posWS.z) < ACTOR_LOD_DIST)
+		{
+			return ACTOR_LOD_FULL;
+		}
+		return (s_curTick - prevTick >= ACTOR_LOD_INTERVAL) ? ACTOR_LOD_REDUCED : ACTOR_LOD_SKIPPED;
+	}
+
 	void actorLogicTaskFunc(MessageType msg)
 	{
 		task_begin;
@@ -2030,12 +2087,18 @@ namespace TFE_DarkForces
 			entity_yield(TASK_NO_DELAY);
 			if (msg == MSG_RUN_TASK)
 			{
+				s_actorSimLod = TFE_Settings::actorSimLod() ? JTRUE : JFALSE;
+				memset(s_actorLodCount, 0, sizeof(s_actorLodCount));
+
 				ActorDispatch* dispatch = (ActorDispatch*)allocator_getHead(s_istate.actorDispatch);
 				while (dispatch)
 				{
 					SecObject* obj = dispatch->logic.obj;
 					const u32 flags = dispatch->flags;
-					if ((flags & 1) && (flags & 4))
+					const ActorLodCategory lod = ((flags & 1) && (flags & 4)) ? ACTOR_LOD_IDLE : actor_getLodCategory(dispatch, obj);
+					s_actorLodCount[lod]++;
+
+					if (lod == ACTOR_LOD_IDLE)
 					{
 						if (dispatch->nextTick < s_curTick)
 						{
@@ -2048,8 +2111,16 @@ namespace TFE_DarkForces
 							}
 						}
 					}
-					else
+					else if (lod != ACTOR_LOD_SKIPPED)
 					{
+						// At reduced rate the actor is updated using the time accumulated since its last update.
+						const fixed16_16 frameDeltaTime = s_deltaTime;
+						if (lod == ACTOR_LOD_REDUCED)
+						{
+							s_deltaTime = min(div16(intToFixed16(s_curTick - dispatch->lodTick), FIXED(TICKS_PER_SECOND)), MAX_DELTA_TIME);
+						}
+						dispatch->lodTick = s_curTick;
+
 						s_actorState.curLogic = (Logic*)dispatch;
 						s_actorState.curAnimation = nullptr;
 						for (s32 i = 0; i < ACTOR_MAX_MODULES; i++)
@@ -2080,6 +2151,7 @@ namespace TFE_DarkForces
 								}
 							}
 						}
+						s_deltaTime = frameDeltaTime;
 					}
 
 					dispatch = (ActorDispatch*)allocator_getNext(s_istate.actorDispatch);
@@ -124,6 +124,10 @@ struct ActorDispatch
 
 	Task* freeTask;
 	u32 flags;
+
+	// Added for TFE: simulation LOD state.
+	Tick lodTick;		// tick of the last update, used to accumulate delta time at reduced rate.
+	Tick lodAlertTick;	// tick of the last alert or damage message, which forces full rate for a while.
 };
 
 struct ActorState
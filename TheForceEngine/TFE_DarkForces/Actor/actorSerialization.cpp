@@ -77,6 +77,9 @@ namespace TFE_DarkForces
 		SERIALIZE(SaveVersionInit, dispatch->vel, {0});
 		SERIALIZE(SaveVersionInit, dispatch->lastPlayerPos, {0});
 		SERIALIZE(SaveVersionInit, dispatch->flags, 4);
+		// Older saves update the actor at full rate on the first frame, which restarts the LOD timing.
+		SERIALIZE(ObjState_ActorSimLod, dispatch->lodTick, 0);
+		SERIALIZE(ObjState_ActorSimLod, dispatch->lodAlertTick, 0);
 		// Animation Table.
 		s32 animTableIndex = -1;
 		if (serialization_getMode() == SMODE_WRITE)
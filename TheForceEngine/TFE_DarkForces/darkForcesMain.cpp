@@ -47,6 +47,7 @@
 #include <TFE_Archive/gobMemoryArchive.h>
 #include <TFE_Jedi/Level/rfont.h>
 #include <TFE_Jedi/Level/level.h>
+#include <TFE_Jedi/Level/levelPrefetch.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
 #include <TFE_Jedi/Task/task.h>
 #include <TFE_Jedi/Renderer/jediRenderer.h>
@@ -353,6 +354,9 @@ namespace TFE_DarkForces
 		lsystem_destroy();
 		bitmap_clearAll();
 		
+		// Stop the level prefetch before its data and the archives it reads from are freed.
+		level_prefetchCancel();
+
 		// Clear paths and archives.
 		TFE_Paths::clearSearchPaths();
 		TFE_Paths::clearLocalArchives();
@@ -616,6 +620,8 @@ namespace TFE_DarkForces
 				s32 skill;
 				JBool abort;
 				lmusic_reset();	// Fix a Dark Forces bug where music won't play when entering a cutscene again without restarting.
+				// TFE: Read the level files in the background while the briefing is displayed.
+				level_prefetchUpdate();
 				if (!missionBriefing_update(&skill, &abort))
 				{
 					missionBriefing_cleanup();
@@ -623,6 +629,7 @@ namespace TFE_DarkForces
 
 					if (abort)
 					{
+						level_prefetchCancel();
 						s_invalidLevelIndex = JTRUE;
 						s_runGameState.cutsceneIndex--;
 					}
@@ -760,6 +767,7 @@ namespace TFE_DarkForces
 					brief = &s_sharedState.briefingList.briefing[briefingIndex];
 					if (brief)
 					{
+						level_prefetch(levelName);
 						missionBriefing_start(brief->archive, brief->bgAnim, levelName, brief->palette, skill, &s_sharedState.langKeys);
 						s_runGameState.state = GSTATE_BRIEFING;
 					}
@@ -894,6 +902,8 @@ namespace TFE_DarkForces
 
 		strcpy(s_sharedState.customGobName, gobName);
 
+		// The mod may have been added to a search path after the file index was built.
+		TFE_Paths::invalidateFileIndex();
 		if (TFE_Paths::getFilePath(gobName, &archivePath))
 		{
 			// Is this really a gob?
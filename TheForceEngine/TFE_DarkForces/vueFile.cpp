@@ -0,0 +1,222 @@
+#include <cstring>
+
+#include "vueFile.h"
+#include <TFE_FileSystem/binaryCache.h>
+#include <TFE_FileSystem/filestream.h>
+#include <TFE_System/parser.h>
+#include <TFE_System/system.h>
+#include <algorithm>
+#include <vector>
+
+using namespace TFE_BinaryCache;
+
+namespace TFE_DarkForces
+{
+	enum VueCacheFileConst : u32
+	{
+		VueCacheSignature = BINARY_CACHE_SIG('V', 'U', 'E', 'C'),
+		VueCacheVersion   = 2,
+		VUE_MAX_LINE      = 4096,
+	};
+
+	enum VueCacheSection
+	{
+		VCS_NAMES = 0,
+		VCS_TRANSFORMS,
+		VCS_CAMERAS,
+		VCS_COUNT
+	};
+
+	struct VueFileParse
+	{
+		std::vector<VueTransformName> names;
+		std::vector<VueTransformDesc> transforms;
+		std::vector<VueCameraDesc> cameras;
+	};
+
+	// The last file read.
+	static VueFileDesc s_desc = {};
+	static u64 s_descHash = 0;
+	static bool s_descValid = false;
+	static VueFileParse s_parse;
+	static std::vector<u8> s_cacheData;
+	static std::vector<u8> s_sourceData;
+
+	void vue_getCachePath(const char* fileName, char* path)
+	{
+		snprintf(path, TFE_MAX_PATH, "%sVueCache/%s.vuc", TFE_Paths::getPath(PATH_PROGRAM_DATA), fileName);
+	}
+
+	u32 vue_addName(const char* name)
+	{
+		// VUE files only have a handful of transforms, listed in the same order every frame.
+		const u32 count = u32(s_parse.names.size());
+		for (u32 i = 0; i < count; i++)
+		{
+			if (strcasecmp(s_parse.names[i].name, name) == 0) { return i; }
+		}
+		VueTransformName entry = {};
+		strncpy(entry.name, name, VUE_NAME_LEN - 1);
+		s_parse.names.push_back(entry);
+		return count;
+	}
+
+	// Equivalent to reading the lines with TFE_Parser ("#" and "//" comments) and then using
+	// sscanf(line, "transform %s %f ...") and sscanf(line, "camera %f ..."), without the per character overhead.
+	void vue_parseFile(const char* data, size_t size)
+	{
+		s_parse.names.clear();
+		s_parse.transforms.clear();
+		s_parse.cameras.clear();
+
+		char line[VUE_MAX_LINE];
+		const char* end = data + size;
+		while (data < end)
+		{
+			const char* lineStart = data;
+			const char* contentEnd = nullptr;
+			for (; data < end && *data != '\n' && *data != '\r'; data++)
+			{
+				if (!contentEnd && (*data == '#' || (*data == '/' && data + 1 < end && data[1] == '/')))
+				{
+					contentEnd = data;
+				}
+			}
+			if (!contentEnd) { contentEnd = data; }
+			for (; data < end && (*data == '\n' || *data == '\r'); data++);
+
+			const size_t len = std::min(size_t(contentEnd - lineStart), size_t(VUE_MAX_LINE - 1));
+			if (len < 6) { continue; }
+			memcpy(line, lineStart, len);
+			line[len] = 0;
+
+			const char* str = line;
+			if (TFE_Parser::matchLiteral(str, "transform "))
+			{
+				char name[VUE_NAME_LEN];
+				VueTransformDesc transform;
+				if (!TFE_Parser::parseWord(str, name, VUE_NAME_LEN)) { continue; }
+
+				s32 i = 0;
+				for (; i < 12 && TFE_Parser::parseFloat(str, &transform.values[i]); i++);
+				if (i < 12) { continue; }
+
+				transform.name = vue_addName(name);
+				s_parse.transforms.push_back(transform);
+			}
+			else if (TFE_Parser::matchLiteral(str, "camera "))
+			{
+				VueCameraDesc camera;
+				s32 i = 0;
+				for (; i < 8 && TFE_Parser::parseFloat(str, &camera.values[i]); i++);
+				if (i < 8) { continue; }
+
+				s_parse.cameras.push_back(camera);
+			}
+		}
+
+		s_desc.nameCount      = u32(s_parse.names.size());
+		s_desc.names          = s_parse.names.data();
+		s_desc.transformCount = u32(s_parse.transforms.size());
+		s_desc.transforms     = s_parse.transforms.data();
+		s_desc.cameraCount    = u32(s_parse.cameras.size());
+		s_desc.cameras        = s_parse.cameras.data();
+	}
+
+	bool vue_readCache(const char* fileName, u64 sourceHash)
+	{
+		char path[TFE_MAX_PATH];
+		vue_getCachePath(fileName, path);
+
+		CacheSection sections[VCS_COUNT] =
+		{
+			{ nullptr, 0, sizeof(VueTransformName) },
+			{ nullptr, 0, sizeof(VueTransformDesc) },
+			{ nullptr, 0, sizeof(VueCameraDesc) },
+		};
+		if (!cache_read(path, VueCacheSignature, VueCacheVersion, sourceHash, sections, VCS_COUNT, s_cacheData))
+		{
+			return false;
+		}
+
+		// Pointer fixups.
+		VueFileDesc desc;
+		desc.nameCount      = sections[VCS_NAMES].count;
+		desc.names          = (const VueTransformName*)sections[VCS_NAMES].data;
+		desc.transformCount = sections[VCS_TRANSFORMS].count;
+		desc.transforms     = (const VueTransformDesc*)sections[VCS_TRANSFORMS].data;
+		desc.cameraCount    = sections[VCS_CAMERAS].count;
+		desc.cameras        = (const VueCameraDesc*)sections[VCS_CAMERAS].data;
+
+		// Make sure the names are terminated and the indices stay in range.
+		bool valid = true;
+		for (u32 i = 0; i < desc.nameCount && valid; i++)
+		{
+			valid = desc.names[i].name[VUE_NAME_LEN - 1] == 0;
+		}
+		for (u32 i = 0; i < desc.transformCount && valid; i++)
+		{
+			valid = desc.transforms[i].name < desc.nameCount;
+		}
+		if (!valid)
+		{
+			TFE_System::logWrite(LOG_WARNING, "Vue Cache", "Ignoring invalid cache '%s'.", path);
+			return false;
+		}
+		s_desc = desc;
+		return true;
+	}
+
+	void vue_writeCache(const char* fileName, u64 sourceHash)
+	{
+		const CacheSection sections[VCS_COUNT] =
+		{
+			{ s_desc.names,      s_desc.nameCount,      sizeof(VueTransformName) },
+			{ s_desc.transforms, s_desc.transformCount, sizeof(VueTransformDesc) },
+			{ s_desc.cameras,    s_desc.cameraCount,    sizeof(VueCameraDesc) },
+		};
+
+		char path[TFE_MAX_PATH];
+		vue_getCachePath(fileName, path);
+		cache_write(path, VueCacheSignature, VueCacheVersion, sourceHash, sections, VCS_COUNT);
+	}
+
+	JBool vue_readFile(const FilePath* filePath, const char* fileName, VueFileDesc* desc)
+	{
+		size_t size = 0;
+		const u8* data = FileStream::readContentsView(filePath, s_sourceData, &size);
+		if (!data || !size)
+		{
+			return JFALSE;
+		}
+
+		const u64 hash = cache_hash(data, size);
+		if (!s_descValid || s_descHash != hash)
+		{
+			if (!vue_readCache(fileName, hash))
+			{
+				vue_parseFile((const char*)data, size);
+				vue_writeCache(fileName, hash);
+			}
+			s_descHash = hash;
+			s_descValid = true;
+		}
+		// The source is no longer needed.
+		std::vector<u8>().swap(s_sourceData);
+
+		*desc = s_desc;
+		return JTRUE;
+	}
+
+	void vue_clearFileCache()
+	{
+		s_desc = {};
+		s_descHash = 0;
+		s_descValid = false;
+		std::vector<VueTransformName>().swap(s_parse.names);
+		std::vector<VueTransformDesc>().swap(s_parse.transforms);
+		std::vector<VueCameraDesc>().swap(s_parse.cameras);
+		std::vector<u8>().swap(s_cacheData);
+		std::vector<u8>().swap(s_sourceData);
+	}
+}  // namespace TFE_DarkForces
@@ -0,0 +1,53 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Dark Forces VUE File
+// Reads the transform and camera frames of VUE animation files.
+//
+// VUE files are text with a "transform <name> <12 floats>" or
+// "camera <8 floats>" line per frame, the large flythroughs have tens
+// of thousands of them. The lines are parsed once into a name table
+// and packed frames, which are also written to
+// PATH_PROGRAM_DATA/VueCache/ along with a hash of the source file so
+// later loads skip the text parsing. The last file read is kept in
+// memory since several objects usually share the same VUE.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_FileSystem/paths.h>
+
+namespace TFE_DarkForces
+{
+	enum VueFileConst
+	{
+		VUE_NAME_LEN = 32,
+	};
+
+	struct VueTransformName
+	{
+		char name[VUE_NAME_LEN];
+	};
+
+	struct VueTransformDesc
+	{
+		u32 name;					// Index into the name table.
+		f32 values[12];				// 3x3 rotation/scale followed by the offset, as listed in the file.
+	};
+
+	struct VueCameraDesc
+	{
+		f32 values[8];				// Position, target, roll and lens, as listed in the file.
+	};
+
+	struct VueFileDesc
+	{
+		u32 nameCount;
+		const VueTransformName* names;
+		u32 transformCount;
+		const VueTransformDesc* transforms;
+		u32 cameraCount;
+		const VueCameraDesc* cameras;
+	};
+
+	// Returns the frames of the VUE file, the description stays valid until the next call or vue_clearFileCache().
+	JBool vue_readFile(const FilePath* filePath, const char* fileName, VueFileDesc* desc);
+	void  vue_clearFileCache();
+}  // namespace TFE_DarkForces
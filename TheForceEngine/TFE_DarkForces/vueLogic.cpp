@@ -2,6 +2,7 @@
 #include <cmath>
 
 #include "vueLogic.h"
+#include "vueFile.h"
 #include "time.h"
 #include <TFE_Game/igame.h>
 #include <TFE_DarkForces/Actor/actor.h>
@@ -73,9 +74,6 @@ namespace TFE_DarkForces
 		};
 	}
 
-	static char* s_workBuffer = nullptr;
-	static size_t s_workBufferSize = 0;
-
 	JBool vueLogicSetupFunc(Logic* logic, KEYWORD key);
 	void vueLogicTaskFunc(MessageType msg);
 	void vueLogicCleanupFunc(Logic *logic);
@@ -208,31 +206,27 @@ namespace TFE_DarkForces
 		task_serializeState(stream, vueLogic->logic.task, vueLogic, vueLogic_serializeTaskLocalMemory);
 	}
 
-	void loadVueFile(Allocator* vueList, char* transformName, TFE_Parser* parser)
+	void loadVueFrames(Allocator* vueList, const char* transformName, const VueFileDesc* vue)
 	{
-		size_t bufferPos = 0;
 		if (!strcasecmp(transformName, "camera"))
 		{
-			while (1)
+			const VueCameraDesc* camera = vue->cameras;
+			for (u32 i = 0; i < vue->cameraCount; i++, camera++)
 			{
-				const char* line = parser->readLine(bufferPos);
-				if (!line) { break; }
+				// camera x1 z1 y1 x2 z2 y2 roll lens, the lens is unused.
+				const f32 x1 = camera->values[0], z1 = camera->values[1], y1 = -camera->values[2];
+				const f32 x2 = camera->values[3], z2 = camera->values[4];
+				const f32 r  = camera->values[6];
 
-				f32 x1, z1, y1, x2, z2, y2, r, lens;
-				if (sscanf(line, "camera %f %f %f %f %f %f %f %f", &x1, &z1, &y1, &x2, &z2, &y2, &r, &lens) == 8)
-				{
-					y1 = -y1;
-					y2 = -y2;
-					VueFrame* frame = (VueFrame*)allocator_newItem(vueList);
-					if (!frame)
-						return;
-					frame->offset.x = floatToFixed16(x1);
-					frame->offset.y = floatToFixed16(y1);
-					frame->offset.z = floatToFixed16(z1);
-					frame->yaw   = vec2ToAngle(floatToFixed16(x2 - x1), floatToFixed16(z2 - z1));
-					frame->pitch = 0;
-					frame->roll  = angle14_32(r * 16383.0f / 360.0f);
-				}
+				VueFrame* frame = (VueFrame*)allocator_newItem(vueList);
+				if (!frame)
+					return;
+				frame->offset.x = floatToFixed16(x1);
+				frame->offset.y = floatToFixed16(y1);
+				frame->offset.z = floatToFixed16(z1);
+				frame->yaw   = vec2ToAngle(floatToFixed16(x2 - x1), floatToFixed16(z2 - z1));
+				frame->pitch = 0;
+				frame->roll  = angle14_32(r * 16383.0f / 360.0f);
 			}
 		}
 		else
@@ -270,115 +264,63 @@ namespace TFE_DarkForces
 				return;
 			frame->flags = VFRAME_FIRST;
 
-			while (1)
+			// Find the matching transforms once, rather than comparing names for every frame.
+			std::vector<u8> nameMatch(vue->nameCount);
+			for (u32 i = 0; i < vue->nameCount; i++)
 			{
-				const char* line = parser->readLine(bufferPos);
-				if (!line)
-				{
-					break;
-				}
+				nameMatch[i] = transformName[0] == '*' || strcasecmp(vue->names[i].name, transformName) == 0;
+			}
+
+			const VueTransformDesc* transform = vue->transforms;
+			for (u32 t = 0; t < vue->transformCount; t++, transform++)
+			{
+				// Is this the correct transform?
+				if (!nameMatch[transform->name]) { continue; }
 
-				char name[32];
-				f32 f00, f01, f02, f03, f04, f05, f06, f07, f08, f09, f10, f11;
-				s32 count = sscanf(line, "transform %s %f %f %f %f %f %f %f %f %f %f %f %f", name, &f00, &f01, &f02, &f03, &f04, &f05, &f06, &f07, &f08, &f09, &f10, &f11);
-				if (count == 13)
+				frame = (VueFrame*)allocator_newItem(vueList);
+				if (!frame)
+					return;
+
+				// Rotation/Scale matrix.
+				const f32* values = transform->values;
+				fixed16_16 frameMtx[9];
+				for (s32 i = 0; i < 9; i++)
 				{
-					// Is this the correct transform?
-					if (transformName[0] == '*' || strcasecmp(name, transformName) == 0)
-					{
-						frame = (VueFrame*)allocator_newItem(vueList);
-						if (!frame)
-							return;
-
-						// Rotation/Scale matrix.
-						fixed16_16 frameMtx[9];
-						frameMtx[0] = floatToFixed16(f00);
-						frameMtx[1] = floatToFixed16(f01);
-						frameMtx[2] = floatToFixed16(f02);
-						frameMtx[3] = floatToFixed16(f03);
-						frameMtx[4] = floatToFixed16(f04);
-						frameMtx[5] = floatToFixed16(f05);
-						frameMtx[6] = floatToFixed16(f06);
-						frameMtx[7] = floatToFixed16(f07);
-						frameMtx[8] = floatToFixed16(f08);
-
-						// Transform to DF coordinate system.
-						fixed16_16 tempMtx[9];
-						mulMatrix3x3(mtx1, frameMtx, tempMtx);
-						mulMatrix3x3(tempMtx, mtx0, frame->mtx);
-
-						frame->offset.x =  floatToFixed16(f09);
-						frame->offset.y = -floatToFixed16(f11);
-						frame->offset.z =  floatToFixed16(f10);
-
-						frame->yaw = 8191;
-						frame->flags = 0;
-					}
+					frameMtx[i] = floatToFixed16(values[i]);
 				}
+
+				// Transform to DF coordinate system.
+				fixed16_16 tempMtx[9];
+				mulMatrix3x3(mtx1, frameMtx, tempMtx);
+				mulMatrix3x3(tempMtx, mtx0, frame->mtx);
+
+				frame->offset.x =  floatToFixed16(values[9]);
+				frame->offset.y = -floatToFixed16(values[11]);
+				frame->offset.z =  floatToFixed16(values[10]);
+
+				frame->yaw = 8191;
+				frame->flags = 0;
 			}
 		}
 	}
 
 	void vue_resetState()
 	{
-		s_workBufferSize = 0;
-		s_workBuffer = nullptr;
-	}
-		
-	char* allocateWorkBuffer(size_t size)
-	{
-		if (size > s_workBufferSize)
-		{
-			s_workBufferSize = size + 1024;
-			s_workBuffer = (char*)game_realloc(s_workBuffer, s_workBufferSize);
-		}
-		assert(s_workBuffer);
-		return s_workBuffer;
-	}
-
-	JBool createParserFromFile(FilePath* filePath, TFE_Parser* parser)
-	{
-		assert(filePath && parser);
-
-		FileStream file;
-		size_t size = 0;
-		char* buffer = nullptr;
-		if (file.open(filePath, Stream::MODE_READ))
-		{
-			size = file.getSize();
-			buffer = allocateWorkBuffer(size);
-			file.readBuffer(buffer, (u32)size);
-		}
-		file.close();
-
-		if (!buffer || !size)
-		{
-			return JFALSE;
-		}
-
-		parser->init(buffer, size);
-		parser->addCommentString("//");
-		parser->addCommentString("#");
-		return JTRUE;
+		vue_clearFileCache();
 	}
 
 	Allocator* key_loadVue(char* arg1, char* arg2, s32 isCamera)
 	{
 		FilePath filePath;
-		if (!TFE_Paths::getFilePath(arg1, &filePath))
-		{
-			TFE_System::logWrite(LOG_ERROR, "VUE", "key_loadVue: COULD NOT OPEN.");
-			return nullptr;
-		}
-		TFE_Parser parser;
-		if (!createParserFromFile(&filePath, &parser))
+		VueFileDesc vue;
+		if (!TFE_Paths::getFilePath(arg1, &filePath) || !vue_readFile(&filePath, arg1, &vue))
 		{
 			TFE_System::logWrite(LOG_ERROR, "VUE", "key_loadVue: COULD NOT OPEN.");
 			return nullptr;
 		}
 		
 		Allocator* vueList = allocator_create(sizeof(VueFrame));
-		loadVueFile(vueList, arg2, &parser);
+		loadVueFrames(vueList, arg2, &vue);
 		
 		return vueList;
 	}
@@ -386,19 +328,14 @@ namespace TFE_DarkForces
 	Allocator* key_appendVue(char* arg1, char* arg2, Allocator* frames)
 	{
 		FilePath filePath;
-		if (!TFE_Paths::getFilePath(arg1, &filePath))
-		{
-			TFE_System::logWrite(LOG_ERROR, "VUE", "key_appendVue: COULD NOT OPEN.");
-			return frames;
-		}
-		TFE_Parser parser;
-		if (!createParserFromFile(&filePath, &parser))
+		VueFileDesc vue;
+		if (!TFE_Paths::getFilePath(arg1, &filePath) || !vue_readFile(&filePath, arg1, &vue))
 		{
 			TFE_System::logWrite(LOG_ERROR, "VUE", "key_appendVue: COULD NOT OPEN.");
 			return frames;
 		}
 
-		loadVueFile(frames, arg2, &parser);
+		loadVueFrames(frames, arg2, &vue);
 		return frames;
 	}
 
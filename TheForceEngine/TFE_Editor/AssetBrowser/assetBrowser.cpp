@@ -2151,5 +2151,7 @@ namespace AssetBrowser
 				writeGpuTextureAsPng(sprite->texGpu, pngFile);
 			}
 		}
+		// The export path may also be a search path.
+		TFE_Paths::invalidateFileIndex();
 	}
 }
\ No newline at end of file
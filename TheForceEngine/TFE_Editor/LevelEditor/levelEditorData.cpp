@@ -1863,6 +1863,8 @@ namespace LevelEditor
 		osShellExecute(s_testAppPath, appDir, cmdLine, true);
 		// Then cleanup by deleting the test GOB.
 		FileUtil::deleteFile(gobPath);
+		// The exported files may be in a search path.
+		TFE_Paths::invalidateFileIndex();
 		
 		return true;
 	}
@@ -0,0 +1,167 @@
+#include <cstring>
+#include "binaryCache.h"
+#include "filestream.h"
+#include "fileutil.h"
+#include <TFE_System/system.h>
+#include <assert.h>
+
+namespace TFE_BinaryCache
+{
+	enum BinaryCacheConst : u32
+	{
+		CACHE_MAX_SECTIONS = 16,
+		CACHE_SECTION_ALIGN = 8,
+	};
+
+	struct CacheHeader
+	{
+		u32 signature;
+		u32 version;
+		u64 sourceHash;
+		u32 sectionCount;
+		u32 fileSize;
+		// Followed by 'sectionCount' CacheSectionHeaders.
+	};
+
+	struct CacheSectionHeader
+	{
+		u32 offset;			// From the start of the file.
+		u32 count;
+		u32 recordSize;
+	};
+
+	u64 cache_hash(const u8* data, size_t size)
+	{
+		// FNV-1a style, but consuming 8 bytes at a time.
+		const u64 prime = 0x100000001b3ull;
+		u64 hash = 0xcbf29ce484222325ull ^ u64(size);
+		size_t i = 0;
+		for (; i + 8 <= size; i += 8)
+		{
+			u64 word;
+			memcpy(&word, &data[i], 8);
+			hash = (hash ^ word) * prime;
+			hash ^= hash >> 29;
+		}
+		for (; i < size; i++)
+		{
+			hash = (hash ^ data[i]) * prime;
+		}
+		return hash;
+	}
+
+	bool cache_sectionValid(const CacheSectionHeader* section, u32 fileSize)
+	{
+		return section->offset <= fileSize && u64(section->count) * section->recordSize <= u64(fileSize - section->offset);
+	}
+
+	bool cache_read(const char* path, u32 signature, u32 version, u64 sourceHash, CacheSection* sections, u32 sectionCount, std::vector<u8>& buffer)
+	{
+		assert(sectionCount <= CACHE_MAX_SECTIONS);
+		FileStream file;
+		if (!file.open(path, Stream::MODE_READ))
+		{
+			return false;
+		}
+		const size_t size = file.getSize();
+		const size_t headerSize = sizeof(CacheHeader) + sizeof(CacheSectionHeader) * sectionCount;
+		if (size < headerSize)
+		{
+			file.close();
+			return false;
+		}
+		buffer.resize(size);
+		file.readBuffer(buffer.data(), u32(size));
+		file.close();
+
+		const u8* data = buffer.data();
+		CacheHeader header;
+		CacheSectionHeader sectionHeaders[CACHE_MAX_SECTIONS];
+		memcpy(&header, data, sizeof(CacheHeader));
+		memcpy(sectionHeaders, data + sizeof(CacheHeader), sizeof(CacheSectionHeader) * sectionCount);
+
+		bool sameLayout = header.signature == signature && header.version == version && header.sectionCount == sectionCount;
+		for (u32 i = 0; i < sectionCount && sameLayout; i++)
+		{
+			sameLayout = sectionHeaders[i].recordSize == sections[i].recordSize;
+		}
+		if (!sameLayout)
+		{
+			TFE_System::logWrite(LOG_WARNING, "Binary Cache", "Ignoring cache '%s', it was written by a different version.", path);
+			return false;
+		}
+		// The source was modified since the cache was written.
+		if (header.sourceHash != sourceHash)
+		{
+			return false;
+		}
+
+		bool valid = header.fileSize == size;
+		for (u32 i = 0; i < sectionCount && valid; i++)
+		{
+			valid = sectionHeaders[i].offset >= headerSize && cache_sectionValid(&sectionHeaders[i], header.fileSize);
+		}
+		if (!valid)
+		{
+			TFE_System::logWrite(LOG_WARNING, "Binary Cache", "Ignoring invalid cache '%s'.", path);
+			return false;
+		}
+
+		for (u32 i = 0; i < sectionCount; i++)
+		{
+			sections[i].data = data + sectionHeaders[i].offset;
+			sections[i].count = sectionHeaders[i].count;
+		}
+		return true;
+	}
+
+	bool cache_write(const char* path, u32 signature, u32 version, u64 sourceHash, const CacheSection* sections, u32 sectionCount)
+	{
+		assert(sectionCount <= CACHE_MAX_SECTIONS);
+		char dir[TFE_MAX_PATH];
+		FileUtil::getFilePath(path, dir);
+		if (!FileUtil::directoryExits(dir) && !FileUtil::makeDirectory(dir))
+		{
+			return false;
+		}
+
+		CacheHeader header = {};
+		header.signature    = signature;
+		header.version      = version;
+		header.sourceHash   = sourceHash;
+		header.sectionCount = sectionCount;
+
+		// Sections are padded so the records stay aligned when read in place.
+		CacheSectionHeader sectionHeaders[CACHE_MAX_SECTIONS];
+		u32 offset = u32(sizeof(CacheHeader) + sizeof(CacheSectionHeader) * sectionCount);
+		for (u32 i = 0; i < sectionCount; i++)
+		{
+			offset = (offset + CACHE_SECTION_ALIGN - 1) & ~(CACHE_SECTION_ALIGN - 1);
+			sectionHeaders[i].offset = offset;
+			sectionHeaders[i].count = sections[i].count;
+			sectionHeaders[i].recordSize = sections[i].recordSize;
+			offset += sections[i].count * sections[i].recordSize;
+		}
+		header.fileSize = offset;
+
+		FileStream file;
+		if (!file.open(path, Stream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_WARNING, "Binary Cache", "Cannot write '%s'.", path);
+			return false;
+		}
+		file.writeBuffer(&header, sizeof(CacheHeader));
+		file.writeBuffer(sectionHeaders, sizeof(CacheSectionHeader) * sectionCount);
+
+		const u8 padding[CACHE_SECTION_ALIGN] = { 0 };
+		u32 loc = u32(sizeof(CacheHeader) + sizeof(CacheSectionHeader) * sectionCount);
+		for (u32 i = 0; i < sectionCount; i++)
+		{
+			file.writeBuffer(padding, sectionHeaders[i].offset - loc);
+			file.writeBuffer(sections[i].data, sections[i].count * sections[i].recordSize);
+			loc = sectionHeaders[i].offset + sections[i].count * sections[i].recordSize;
+		}
+		file.close();
+		return true;
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Binary Cache
+// Shared file format for caches of parsed data, such as the level
+// geometry and VUE caches.
+//
+// A cache is a header followed by a list of sections, each an array
+// of fixed size records. It is read with one bulk read and the section
+// pointers point directly into the buffer. The cache is rejected if
+// the signature, version or source hash do not match, if the record
+// sizes differ from the current build or if any section is out of
+// range. Validating the contents of the records is up to the caller.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <vector>
+
+#define BINARY_CACHE_SIG(a, b, c, d) ((a) | (b)<<8 | (c)<<16 | (d)<<24)
+
+namespace TFE_BinaryCache
+{
+	struct CacheSection
+	{
+		const void* data;
+		u32 count;			// Number of records.
+		u32 recordSize;
+	};
+
+	// Hash of the source file, the cache is only used if it matches.
+	u64  cache_hash(const u8* data, size_t size);
+	// Read the cache at 'path' into 'buffer'. The record sizes of 'sections' must be set by the caller,
+	// on success the data and count of each section are filled in and point into 'buffer'.
+	// 'version' should be incremented whenever the parsing or the layout of the records change.
+	bool cache_read(const char* path, u32 signature, u32 version, u64 sourceHash, CacheSection* sections, u32 sectionCount, std::vector<u8>& buffer);
+	// Write the cache to 'path', creating the directory if required.
+	bool cache_write(const char* path, u32 signature, u32 version, u64 sourceHash, const CacheSection* sections, u32 sectionCount);
+}
@@ -0,0 +1,108 @@
+#include <cstring>
+#include "fileIndex.h"
+#include "fileutil.h"
+#include <TFE_Archive/archive.h>
+#include <unordered_map>
+#include <string>
+
+namespace TFE_FileIndex
+{
+	struct IndexEntry
+	{
+		Archive* archive;	// Owning archive or null for files on disk.
+		u32 index;			// File index in the archive or INVALID_FILE.
+		std::string path;	// Full path for files on disk.
+	};
+	// Upper case file name -> entry.
+	typedef std::unordered_map<std::string, IndexEntry> IndexMap;
+
+	static IndexMap s_index;
+
+	// Most names are short enough to fit in the small string buffer, so building the key does not allocate.
+	void makeKey(const char* fileName, std::string& key)
+	{
+		key = fileName;
+		for (size_t i = 0; i < key.length(); i++)
+		{
+			key[i] = toupper(key[i]);
+		}
+	}
+
+	void clear()
+	{
+		s_index.clear();
+	}
+
+	void addFile(const char* fileName, const char* filePath)
+	{
+		std::string key;
+		makeKey(fileName, key);
+		s_index.insert({ key, { nullptr, INVALID_FILE, filePath } });
+	}
+
+	void addDirectory(const char* dir)
+	{
+		FileList fileList;
+		FileUtil::readDirectoryFiles(dir, fileList);
+
+		const size_t count = fileList.size();
+		const std::string* file = fileList.data();
+		std::string path;
+		for (size_t i = 0; i < count; i++, file++)
+		{
+			path = dir;
+			path += *file;
+			addFile(file->c_str(), path.c_str());
+		}
+	}
+
+	void addArchive(Archive* archive)
+	{
+		if (!archive) { return; }
+
+		std::string key;
+		const u32 count = archive->getFileCount();
+		for (u32 i = 0; i < count; i++)
+		{
+			makeKey(archive->getFileName(i), key);
+			s_index.insert({ key, { archive, i, std::string() } });
+		}
+	}
+
+	void removeArchive(Archive* archive)
+	{
+		if (!archive) { return; }
+
+		std::string key;
+		const u32 count = archive->getFileCount();
+		for (u32 i = 0; i < count; i++)
+		{
+			makeKey(archive->getFileName(i), key);
+			IndexMap::iterator iEntry = s_index.find(key);
+			if (iEntry != s_index.end() && iEntry->second.archive == archive)
+			{
+				s_index.erase(iEntry);
+			}
+		}
+	}
+
+	bool find(const char* fileName, FilePath* outPath)
+	{
+		std::string key;
+		makeKey(fileName, key);
+		IndexMap::const_iterator iEntry = s_index.find(key);
+		if (iEntry == s_index.end()) { return false; }
+
+		const IndexEntry& entry = iEntry->second;
+		outPath->archive = entry.archive;
+		outPath->index = entry.index;
+		if (entry.archive) { outPath->path[0] = 0; }
+		else { strncpy(outPath->path, entry.path.c_str(), TFE_MAX_PATH); }
+		return true;
+	}
+
+	u32 getEntryCount()
+	{
+		return u32(s_index.size());
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// File Index
+// Case-insensitive hash of the files visible through TFE_Paths - file
+// mappings, the files in each search path and the contents of each
+// archive - so that TFE_Paths::getFilePath() does not have to probe
+// every search path and search every archive.
+//
+// Entries are added in priority order and an entry is never replaced
+// by a later one with the same name, so the first location wins just
+// like the search order in getFilePath().
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include "paths.h"
+
+namespace TFE_FileIndex
+{
+	void clear();
+
+	void addFile(const char* fileName, const char* filePath);
+	// Add every file in the directory (but not subdirectories).
+	void addDirectory(const char* dir);
+	void addArchive(Archive* archive);
+	// Remove the entries that reference the archive. Entries shadowed by the archive are not restored,
+	// so this is only correct for the lowest priority archive.
+	void removeArchive(Archive* archive);
+
+	bool find(const char* fileName, FilePath* outPath);
+	u32  getEntryCount();
+}
@@ -0,0 +1,218 @@
+#include <cstring>
+#include "filePrefetch.h"
+#include "fileutil.h"
+#include <TFE_Archive/archive.h>
+#include <TFE_System/jobSystem.h>
+#include <TFE_System/system.h>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <string>
+
+using namespace TFE_Jobs;
+
+namespace TFE_FilePrefetch
+{
+	enum PrefetchConst : u32
+	{
+		PREFETCH_MEMORY_BUDGET = 128u * 1024u * 1024u,	// Maximum amount of data held by the cache.
+		PREFETCH_PAGE_SIZE = 4096,
+	};
+
+	enum PrefetchState : u32
+	{
+		PREFETCH_PENDING = 0,
+		PREFETCH_READY,
+		PREFETCH_FAILED,
+	};
+
+	struct PrefetchEntry
+	{
+		Archive* archive;
+		u32 index;
+		std::string path;
+		FileHandle handle;				// Loose files are opened when queued, so their size counts against the budget.
+		bool mapped;					// The file is in a memory mapped archive, only its pages are touched.
+		std::atomic<u32> state;
+		JobCounter counter;				// So the loader only waits for this file.
+		std::vector<u8> data;
+	};
+
+	typedef std::map<std::pair<Archive*, u32>, PrefetchEntry*> ArchiveEntryMap;
+	typedef std::map<std::string, PrefetchEntry*> PathEntryMap;
+
+	static ArchiveEntryMap s_archiveEntries;
+	static PathEntryMap s_pathEntries;
+	static std::vector<PrefetchEntry*> s_entries;
+	static size_t s_budgetUsed = 0;
+	static PrefetchStats s_stats = {};
+
+	PrefetchEntry* findEntry(const FilePath* filePath)
+	{
+		if (s_entries.empty()) { return nullptr; }
+		if (filePath->archive)
+		{
+			ArchiveEntryMap::iterator iEntry = s_archiveEntries.find({ filePath->archive, filePath->index });
+			return iEntry != s_archiveEntries.end() ? iEntry->second : nullptr;
+		}
+		PathEntryMap::iterator iEntry = s_pathEntries.find(filePath->path);
+		return iEntry != s_pathEntries.end() ? iEntry->second : nullptr;
+	}
+
+	// Runs on a worker thread.
+	void prefetchJob(void* userData, u32 begin, u32 end)
+	{
+		PrefetchEntry* entry = (PrefetchEntry*)userData;
+		bool success = false;
+		if (entry->mapped)
+		{
+			// Fault in the pages so the loader does not stall on them later.
+			const ArchiveFileView view = entry->archive->getFileView(entry->index);
+			volatile u8 sum = 0;
+			for (size_t i = 0; i < view.size; i += PREFETCH_PAGE_SIZE)
+			{
+				sum += view.data[i];
+			}
+			success = view.data != nullptr;
+		}
+		else if (entry->archive)
+		{
+			const size_t size = entry->archive->getFileLength(entry->index);
+			entry->data.resize(size);
+			success = entry->archive->readFileAt(entry->index, 0, entry->data.data(), size) == size;
+		}
+		else
+		{
+			const size_t size = size_t(FileUtil::getHandleSize(entry->handle));
+			entry->data.resize(size);
+			success = FileUtil::readAt(entry->handle, 0, entry->data.data(), size) == size;
+			FileUtil::closeReadHandle(entry->handle);
+			entry->handle = INVALID_FILE_HANDLE;
+		}
+		entry->state.store(success ? PREFETCH_READY : PREFETCH_FAILED, std::memory_order_release);
+	}
+
+	bool prefetch_file(const FilePath* filePath)
+	{
+		if (!filePath->archive && !filePath->path[0]) { return false; }
+		if (findEntry(filePath)) { return false; }
+
+		size_t size = 0;
+		FileHandle handle = INVALID_FILE_HANDLE;
+		if (filePath->archive)
+		{
+			size = filePath->archive->getFileLength(filePath->index);
+		}
+		else
+		{
+			handle = FileUtil::openReadHandle(filePath->path);
+			if (handle == INVALID_FILE_HANDLE) { return false; }
+			size = size_t(FileUtil::getHandleSize(handle));
+		}
+		const bool mapped = filePath->archive && filePath->archive->getFileView(filePath->index).data;
+		if (!mapped && s_budgetUsed + size > PREFETCH_MEMORY_BUDGET)
+		{
+			if (handle != INVALID_FILE_HANDLE) { FileUtil::closeReadHandle(handle); }
+			return false;
+		}
+		PrefetchEntry* entry = new PrefetchEntry();
+		entry->archive = filePath->archive;
+		entry->index = filePath->index;
+		entry->path = filePath->archive ? "" : filePath->path;
+		entry->handle = handle;
+		entry->mapped = mapped;
+		entry->state.store(PREFETCH_PENDING, std::memory_order_relaxed);
+
+		// Refuse the prefetch rather than reading the file on the main thread if the job queue is full.
+		if (!jobs_trySubmit("File Prefetch", prefetchJob, entry, &entry->counter))
+		{
+			if (handle != INVALID_FILE_HANDLE) { FileUtil::closeReadHandle(handle); }
+			delete entry;
+			return false;
+		}
+		s_budgetUsed += mapped ? 0 : size;
+
+		s_entries.push_back(entry);
+		if (entry->archive) { s_archiveEntries[{ entry->archive, entry->index }] = entry; }
+		else { s_pathEntries[entry->path] = entry; }
+		s_stats.requested++;
+		s_stats.bytes += size;
+		return true;
+	}
+
+	bool prefetch_take(const FilePath* filePath, std::vector<u8>& buffer)
+	{
+		PrefetchEntry* entry = findEntry(filePath);
+		// Mapped files are read through the mapping.
+		if (!entry || entry->mapped) { return false; }
+
+		if (entry->state.load(std::memory_order_acquire) == PREFETCH_PENDING)
+		{
+			s_stats.waited++;
+			jobs_wait(&entry->counter);
+		}
+		if (entry->state.load(std::memory_order_acquire) != PREFETCH_READY) { return false; }
+
+		// The entry is left in place but empty, so the file is not queued again.
+		buffer.swap(entry->data);
+		std::vector<u8>().swap(entry->data);
+		entry->state.store(PREFETCH_FAILED, std::memory_order_relaxed);
+		s_budgetUsed -= std::min(s_budgetUsed, buffer.size());
+		s_stats.taken++;
+		return true;
+	}
+
+	bool prefetch_isPending(const FilePath* filePath)
+	{
+		PrefetchEntry* entry = findEntry(filePath);
+		return entry && entry->state.load(std::memory_order_acquire) == PREFETCH_PENDING;
+	}
+
+	const u8* prefetch_peek(const FilePath* filePath, size_t* size)
+	{
+		PrefetchEntry* entry = findEntry(filePath);
+		if (!entry || entry->state.load(std::memory_order_acquire) != PREFETCH_READY) { return nullptr; }
+		if (entry->mapped)
+		{
+			const ArchiveFileView view = entry->archive->getFileView(entry->index);
+			*size = view.size;
+			return view.data;
+		}
+		*size = entry->data.size();
+		return entry->data.data();
+	}
+
+	void prefetch_wait()
+	{
+		const size_t count = s_entries.size();
+		for (size_t i = 0; i < count; i++)
+		{
+			jobs_wait(&s_entries[i]->counter);
+		}
+	}
+
+	void prefetch_clear()
+	{
+		if (s_entries.empty()) { return; }
+		prefetch_wait();
+
+		TFE_System::logWrite(LOG_MSG, "Prefetch", "Prefetched %u files (%.1f KB), %u used, %u used before the read completed.",
+			s_stats.requested, f64(s_stats.bytes) / 1024.0, s_stats.taken, s_stats.waited);
+
+		const size_t count = s_entries.size();
+		for (size_t i = 0; i < count; i++)
+		{
+			delete s_entries[i];
+		}
+		s_entries.clear();
+		s_archiveEntries.clear();
+		s_pathEntries.clear();
+		s_budgetUsed = 0;
+		s_stats = {};
+	}
+
+	void prefetch_getStats(PrefetchStats* stats)
+	{
+		*stats = s_stats;
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// File Prefetch
+// Reads files on the job system ahead of time so that later loads do
+// not wait on the disk or on decompression.
+//
+// * Files are requested and consumed on the main thread, the reads
+//   happen on worker threads using Archive::readFileAt().
+// * FileStream::readContentsView() takes prefetched data, so loaders
+//   that use it benefit without changes and still decode the data on
+//   the main thread, in the same order as before.
+// * Files in memory mapped archives are not copied, the prefetch only
+//   touches their pages.
+// * Prefetched data must be cleared before archives are closed, see
+//   TFE_Paths::clearLocalArchives().
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include "paths.h"
+#include <vector>
+
+namespace TFE_FilePrefetch
+{
+	struct PrefetchStats
+	{
+		u32 requested;		// Files queued since the last clear.
+		u32 taken;			// Prefetched files that were used.
+		u32 waited;			// Files that were used before the read completed.
+		size_t bytes;		// Bytes read (or touched) by the prefetch.
+	};
+
+	// Queue a read, returns false if the file is already queued, the memory budget is used up or the job queue is full.
+	bool prefetch_file(const FilePath* filePath);
+	// If the file was prefetched, move its contents into 'buffer' (waiting for that read only, if required) and return true.
+	bool prefetch_take(const FilePath* filePath, std::vector<u8>& buffer);
+	// Returns true while the read for the file is queued or running.
+	bool prefetch_isPending(const FilePath* filePath);
+	// Returns the contents of a file whose read has completed, without removing it. Null if not queued or still pending.
+	const u8* prefetch_peek(const FilePath* filePath, size_t* size);
+	// Wait for all outstanding reads.
+	void prefetch_wait();
+	// Wait for all outstanding reads and free any data that was not taken.
+	void prefetch_clear();
+
+	void prefetch_getStats(PrefetchStats* stats);
+}
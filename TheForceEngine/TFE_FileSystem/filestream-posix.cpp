@@ -1,4 +1,5 @@
 #include "filestream.h"
+#include "filePrefetch.h"
 #include "fileutil.h"
 #include "paths.h"
 #include <TFE_Archive/archive.h>
@@ -28,11 +29,15 @@ FileStream::FileStream() : Stream()
 	m_file = nullptr;
 	m_archive = nullptr;
 	m_mode = MODE_INVALID;
+	m_buffer = nullptr;
+	m_bufferSize = 0;
+	resetBuffer();
 }
 
 FileStream::~FileStream()
 {
 	close();
+	setBuffered(0);
 }
 
 bool FileStream::exists(const char *filename)
@@ -48,6 +53,7 @@ bool FileStream::open(const char *filename, AccessMode mode)
 
 	if (!filename || 1 > strlen(filename))
 		return false;
+	resetBuffer();
 
 	memset(fn, 0, TFE_MAX_PATH);
 	strcpy(fn, filename);
@@ -83,6 +89,7 @@ bool FileStream::open(const FilePath *filePath, AccessMode mode)
 
 		if (filePath->index < 0)
 			return false;
+		resetBuffer();
 		m_mode = mode;
 		m_file = nullptr;
 		m_archive = filePath->archive;
@@ -95,6 +102,7 @@ bool FileStream::open(const FilePath *filePath, AccessMode mode)
 void FileStream::close()
 {
 	if (m_file) {
+		flushWriteBuffer();
 		fclose(m_file);
 		m_file = nullptr;
 	} else if (m_archive) {
@@ -102,6 +110,7 @@ void FileStream::close()
 		m_archive = nullptr;
 	}
 	m_mode = MODE_INVALID;
+	resetBuffer();
 }
 
 u32 FileStream::readContents(const char *filePath, void **output)
@@ -165,9 +174,40 @@ u32 FileStream::readContents(const FilePath *filePath, void *output, size_t size
 	return 0;
 }
 
+const u8* FileStream::readContentsView(const FilePath *filePath, std::vector<u8> &buffer, size_t *size)
+{
+	// Use the data if it was read ahead of time.
+	if (TFE_FilePrefetch::prefetch_take(filePath, buffer)) {
+		*size = buffer.size();
+		return buffer.data();
+	}
+
+	if (filePath->archive) {
+		const ArchiveFileView view = filePath->archive->getFileView(filePath->index);
+		if (view.data) {
+			*size = view.size;
+			return view.data;
+		}
+	}
+
+	*size = 0;
+	FileStream file;
+	if (!file.open(filePath, MODE_READ))
+		return nullptr;
+
+	*size = file.getSize();
+	buffer.resize(*size);
+	file.readBuffer(buffer.data(), (u32)*size);
+	file.close();
+	return buffer.data();
+}
+
 //derived from Stream
 bool FileStream::seek(s32 offset, Origin origin/*=ORIGIN_START*/)
 {
+	if (m_buffer && isOpen())
+		return seekBuffered(offset, origin);
+
 	const s32 forigin[] = { SEEK_SET, SEEK_END, SEEK_CUR };
 	if (m_file) {
 		return fseek(m_file, offset, forigin[origin]) == 0;
@@ -182,6 +222,9 @@ size_t FileStream::getLoc(void)
 	if (!m_file && !m_archive)
 		return 0;
 
+	if (m_buffer)
+		return getLocBuffered();
+
 	if (m_file)
 		return ftell(m_file);
 
@@ -213,7 +256,11 @@ bool FileStream::isOpen(void) const
 u32 FileStream::readBuffer(void *ptr, u32 size, u32 count)
 {
 	assert(m_mode == MODE_READ || m_mode == MODE_READWRITE);
-	if (m_file) {
+	if (m_buffer) {
+		// Whole elements, like fread().
+		const u32 bytesRead = readBuffered(ptr, size * count);
+		return size ? bytesRead - bytesRead % size : 0;
+	} else if (m_file) {
 		// fread() returns the number of *elements* read, but we want the number of bytes read.
 		return (u32)fread(ptr, size, count, m_file) * size;
 	} else if (m_archive) {
@@ -225,7 +272,9 @@ u32 FileStream::readBuffer(void *ptr, u32 size, u32 count)
 void FileStream::writeBuffer(const void *ptr, u32 size, u32 count)
 {
 	assert(m_mode == MODE_WRITE || m_mode == MODE_READWRITE);
-	if (m_file) {
+	if (m_buffer && m_file) {
+		writeBuffered(ptr, size * count);
+	} else if (m_file) {
 		fwrite(ptr, size, count, m_file);
 	}
 }
@@ -242,13 +291,14 @@ void FileStream::writeString(const char *fmt, ...)
 		va_end(arg);
 
 		const size_t len = strlen(tmpStr);
-		fwrite(tmpStr, len, 1, m_file);
+		writeBuffer(tmpStr, u32(len));
 	}
 }
 
 void FileStream::flush()
 {
 	if (m_file) {
+		flushWriteBuffer();
 		fflush(m_file);
 	}
 }
@@ -279,10 +329,10 @@ void FileStream::writeString(const std::string *ptr, u32 count)
 	for (u32 s=0; s<count; s++) {
 		s_workBufferU32[s] = (u32)ptr[s].length();
 	}
-	fwrite(s_workBufferU32, sizeof(u32), count, m_file);
+	writeBuffer(s_workBufferU32, sizeof(u32), count);
 
 	//then write the string data.
 	for (u32 s=0; s<count; s++) {
-		fwrite(ptr[s].data(), 1, s_workBufferU32[s], m_file);
+		writeBuffer(ptr[s].data(), 1, s_workBufferU32[s]);
 	}
 }
@@ -1,4 +1,5 @@
 #include "filestream.h"
+#include "filePrefetch.h"
 #include <TFE_Archive/archive.h>
 #include <cassert>
 #include <cstring>
@@ -15,11 +16,15 @@ FileStream::FileStream() : Stream()
 	m_file = nullptr;
 	m_archive = nullptr;
 	m_mode = MODE_INVALID;
+	m_buffer = nullptr;
+	m_bufferSize = 0;
+	resetBuffer();
 }
 
 FileStream::~FileStream()
 {
 	close();
+	setBuffered(0);
 }
 
 bool FileStream::exists(const char* filename)
@@ -33,6 +38,7 @@ bool FileStream::exists(const char* filename)
 bool FileStream::open(const char* filename, AccessMode mode)
 {
 	const char* modeStrings[] = { "rb", "wb", "rb+" };
+	resetBuffer();
 	m_file = fopen(filename, modeStrings[mode]);
 	m_mode = mode;
 
@@ -47,6 +53,7 @@ bool FileStream::open(const FilePath* filePath, AccessMode mode)
 		assert(mode == Stream::MODE_READ);
 
 		if (filePath->index < 0) { return false; }
+		resetBuffer();
 		m_mode = mode;
 		m_file = nullptr;
 		m_archive = filePath->archive;
@@ -65,6 +72,7 @@ void FileStream::close()
 	{
 		if (m_mode == MODE_WRITE || m_mode == MODE_READWRITE) 
 		{ 
+			flushWriteBuffer();
 			fflush(m_file); 
 		}
 
@@ -77,6 +85,7 @@ void FileStream::close()
 		m_archive = nullptr;
 	}
 	m_mode = MODE_INVALID;
+	resetBuffer();
 }
 
 u32 FileStream::readContents(const char* filePath, void** output)
@@ -144,9 +153,44 @@ u32 FileStream::readContents(const FilePath* filePath, void* output, size_t size
 	return 0;
 }
 
+const u8* FileStream::readContentsView(const FilePath* filePath, std::vector<u8>& buffer, size_t* size)
+{
+	// Use the data if it was read ahead of time.
+	if (TFE_FilePrefetch::prefetch_take(filePath, buffer))
+	{
+		*size = buffer.size();
+		return buffer.data();
+	}
+	if (filePath->archive)
+	{
+		const ArchiveFileView view = filePath->archive->getFileView(filePath->index);
+		if (view.data)
+		{
+			*size = view.size;
+			return view.data;
+		}
+	}
+
+	*size = 0;
+	FileStream file;
+	if (!file.open(filePath, MODE_READ))
+	{
+		return nullptr;
+	}
+	*size = file.getSize();
+	buffer.resize(*size);
+	file.readBuffer(buffer.data(), (u32)*size);
+	file.close();
+	return buffer.data();
+}
+
 //derived from Stream
 bool FileStream::seek(s32 offset, Origin origin/*=ORIGIN_START*/)
 {
+	if (m_buffer && isOpen())
+	{
+		return seekBuffered(offset, origin);
+	}
 	const s32 forigin[] = { SEEK_SET, SEEK_END, SEEK_CUR };
 	if (m_file)
 	{
@@ -165,6 +209,10 @@ size_t FileStream::getLoc()
 	{
 		return 0;
 	}
+	if (m_buffer)
+	{
+		return getLocBuffered();
+	}
 	if (m_file)
 	{
 		return ftell(m_file);
@@ -202,7 +250,13 @@ bool FileStream::isOpen() const
 u32 FileStream::readBuffer(void* ptr, u32 size, u32 count)
 {
 	assert(m_mode == MODE_READ || m_mode == MODE_READWRITE);
-	if (m_file)
+	if (m_buffer)
+	{
+		// Whole elements, like fread().
+		const u32 bytesRead = readBuffered(ptr, size * count);
+		return size ? bytesRead - bytesRead % size : 0;
+	}
+	else if (m_file)
 	{
 		// fread() returns the number of *elements* read, but we want the number of bytes read.
 		return (u32)fread(ptr, size, count, m_file) * size;
@@ -217,7 +271,11 @@ u32 FileStream::readBuffer(void* ptr, u32 size, u32 count)
 void FileStream::writeBuffer(const void* ptr, u32 size, u32 count)
 {
 	assert(m_mode == MODE_WRITE || m_mode == MODE_READWRITE);
-	if (m_file)
+	if (m_buffer && m_file)
+	{
+		writeBuffered(ptr, size * count);
+	}
+	else if (m_file)
 	{
 		fwrite(ptr, size, count, m_file);
 	}
@@ -236,7 +294,7 @@ void FileStream::writeString(const char* fmt, ...)
 		va_end(arg);
 
 		const size_t len = strlen(tmpStr);
-		fwrite(tmpStr, len, 1, m_file);
+		writeBuffer(tmpStr, u32(len));
 	}
 }
 
@@ -244,6 +302,7 @@ void FileStream::flush()
 {
 	if (m_file)
 	{
+		flushWriteBuffer();
 		fflush(m_file);
 	}
 }
@@ -276,11 +335,11 @@ void FileStream::writeString(const std::string* ptr, u32 count)
 	{
 		s_workBufferU32[s] = (u32)ptr[s].length();
 	}
-	fwrite(s_workBufferU32, sizeof(u32), count, m_file);
+	writeBuffer(s_workBufferU32, sizeof(u32), count);
 
 	//then write the string data.
 	for (u32 s=0; s<count; s++)
 	{
-		fwrite(ptr[s].data(), 1, s_workBufferU32[s], m_file);
+		writeBuffer(ptr[s].data(), 1, s_workBufferU32[s]);
 	}
 }
@@ -2,6 +2,8 @@
 #include <TFE_FileSystem/stream.h>
 #include <TFE_FileSystem/paths.h>
 #include <cassert>
+#include <cstring>
+#include <vector>
 
 ////////////////////////////////////////////////////
 // TODO: FileStream directly accesses arhive data.
@@ -11,6 +13,13 @@ class Archive;
 
 class FileStream : public Stream
 {
+public:
+	enum FileStreamBufferSize : u32
+	{
+		FS_BUFFER_MIN     = 64u * 1024u,
+		FS_BUFFER_DEFAULT = 64u * 1024u,
+		FS_BUFFER_MAX     = 1024u * 1024u,
+	};
 public:
 	FileStream();
 	~FileStream();
@@ -24,6 +33,9 @@ public:
 	static u32 readContents(const char* filePath, void* output, size_t size);
 	static u32 readContents(const FilePath* filePath, void** output);
 	static u32 readContents(const FilePath* filePath, void* output, size_t size);
+	// Returns the file contents without copying if the file is in a memory mapped archive, otherwise the
+	// file is read into 'buffer'. The data is read-only and valid until the archive is closed or 'buffer' changes.
+	static const u8* readContentsView(const FilePath* filePath, std::vector<u8>& buffer, size_t* size);
 	
 	//derived functions.
 	bool seek(s32 offset, Origin origin=ORIGIN_START) override;
@@ -33,6 +45,13 @@ public:
 
 	void flush();
 
+	// Buffered mode: reads are served from a read-ahead buffer and writes are gathered until the buffer is full,
+	// so the many small reads and writes issued by serialization become a memcpy. Reads and writes larger than the
+	// buffer go straight to the file. The size is clamped to [FS_BUFFER_MIN, FS_BUFFER_MAX], 0 disables buffering.
+	// The setting persists across open() and close(), and may be changed while the file is open.
+	void setBuffered(u32 bufferSize = FS_BUFFER_DEFAULT);
+	bool isBuffered() const { return m_buffer != nullptr; }
+
 	void read(s8*  ptr, u32 count=1) override { readType(ptr, count); }
 	void read(u8*  ptr, u32 count=1) override { readType(ptr, count); }
 	void read(s16* ptr, u32 count=1) override { readType(ptr, count); }
@@ -66,6 +85,14 @@ private:
 	void readType(T* ptr, u32 count)
 	{
 		assert(m_mode == MODE_READ || m_mode == MODE_READWRITE);
+		const u32 size = u32(sizeof(T)) * count;
+		// Fast path: the data is already in the read-ahead buffer.
+		if (size <= m_readEnd - m_readPos)
+		{
+			memcpy(ptr, m_buffer + m_readPos, size);
+			m_readPos += size;
+			return;
+		}
 		readBuffer(ptr, sizeof(T), count);
 	}
 
@@ -74,14 +101,41 @@ private:
 	{
 		assert(m_mode == MODE_WRITE || m_mode == MODE_READWRITE);
 		assert(m_file);	// TODO: Add Archive support.
-		fwrite(ptr, sizeof(T), count, m_file);
+		const u32 size = u32(sizeof(T)) * count;
+		// Fast path: there is room left in the write buffer.
+		if (size <= m_writeEnd - m_writePos)
+		{
+			memcpy(m_buffer + m_writePos, ptr, size);
+			m_writePos += size;
+			return;
+		}
+		writeBuffer(ptr, sizeof(T), count);
 	}
 
 	void readString(std::string* ptr, u32 count);
 	void writeString(const std::string* ptr, u32 count);
 
+	// Buffered mode, shared by all platforms (filestreamBuffered.cpp).
+	void   resetBuffer();
+	u32    readBuffered(void* ptr, u32 size);
+	void   writeBuffered(const void* ptr, u32 size);
+	bool   flushWriteBuffer();
+	bool   seekBuffered(s32 offset, Origin origin);
+	size_t getLocBuffered() const { return m_bufferLoc + m_readPos + m_writePos; }
+	size_t readRaw(void* ptr, size_t size);
+	bool   seekRaw(s32 offset, s32 origin);
+	size_t getLocRaw();
+
 private:
 	FILE*    m_file;
 	Archive* m_archive;
 	AccessMode m_mode;
+
+	u8*    m_buffer;
+	u32    m_bufferSize;
+	size_t m_bufferLoc;		// File location of the start of the buffer.
+	u32    m_readPos;		// Read-ahead data is [m_readPos, m_readEnd), both are 0 unless reading.
+	u32    m_readEnd;
+	u32    m_writePos;		// Pending writes are [0, m_writePos), m_writeEnd is the buffer size while writing and 0 otherwise.
+	u32    m_writeEnd;
 };
@@ -0,0 +1,222 @@
+#include "filestream.h"
+#include <TFE_Archive/archive.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdio.h>
+#include <stdlib.h>
+
+//////////////////////////////////////////////////////////////////////
+// Buffered mode, shared by filestream.cpp and filestream-posix.cpp.
+// The buffer is either idle, holding read-ahead data or holding
+// pending writes:
+//   Idle:    the file location is m_bufferLoc.
+//   Reading: the file location is m_bufferLoc + m_readEnd.
+//   Writing: the file location is m_bufferLoc.
+// stdio requires a seek when switching between reading and writing,
+// so the file is moved to m_bufferLoc whenever the direction changes.
+//////////////////////////////////////////////////////////////////////
+
+void FileStream::setBuffered(u32 bufferSize)
+{
+	if (bufferSize)
+	{
+		bufferSize = std::min(std::max(bufferSize, u32(FS_BUFFER_MIN)), u32(FS_BUFFER_MAX));
+	}
+	if (bufferSize == m_bufferSize)
+	{
+		return;
+	}
+
+	// Move the file to the logical location, so the stream can continue without the old buffer.
+	if (m_buffer)
+	{
+		flushWriteBuffer();
+		if (isOpen())
+		{
+			seekRaw(s32(m_bufferLoc + m_readPos), SEEK_SET);
+		}
+		free(m_buffer);
+	}
+
+	m_buffer = bufferSize ? (u8*)malloc(bufferSize) : nullptr;
+	m_bufferSize = m_buffer ? bufferSize : 0;
+	resetBuffer();
+	if (m_buffer && isOpen())
+	{
+		m_bufferLoc = getLocRaw();
+	}
+}
+
+void FileStream::resetBuffer()
+{
+	m_bufferLoc = 0;
+	m_readPos = 0;
+	m_readEnd = 0;
+	m_writePos = 0;
+	m_writeEnd = 0;
+}
+
+u32 FileStream::readBuffered(void* ptr, u32 size)
+{
+	assert(m_buffer);
+	// Switching from writing to reading.
+	if (m_writeEnd)
+	{
+		flushWriteBuffer();
+		seekRaw(s32(m_bufferLoc), SEEK_SET);
+	}
+
+	u8* dst = (u8*)ptr;
+	u32 bytesRead = 0;
+	while (bytesRead < size)
+	{
+		const u32 available = m_readEnd - m_readPos;
+		if (available)
+		{
+			const u32 copySize = std::min(available, size - bytesRead);
+			memcpy(dst + bytesRead, m_buffer + m_readPos, copySize);
+			m_readPos += copySize;
+			bytesRead += copySize;
+			continue;
+		}
+
+		// The buffer has been consumed.
+		m_bufferLoc += m_readEnd;
+		m_readPos = 0;
+		m_readEnd = 0;
+
+		// Large reads skip the extra copy.
+		const u32 remaining = size - bytesRead;
+		if (remaining >= m_bufferSize)
+		{
+			const size_t rawRead = readRaw(dst + bytesRead, remaining);
+			m_bufferLoc += rawRead;
+			bytesRead += u32(rawRead);
+			break;
+		}
+
+		m_readEnd = u32(readRaw(m_buffer, m_bufferSize));
+		if (!m_readEnd)
+		{
+			break;
+		}
+	}
+	return bytesRead;
+}
+
+void FileStream::writeBuffered(const void* ptr, u32 size)
+{
+	assert(m_buffer && m_file);
+	// Switching from reading to writing, the file may be ahead of the logical location.
+	if (!m_writeEnd)
+	{
+		if (m_mode == MODE_READWRITE)
+		{
+			m_bufferLoc += m_readPos;
+			seekRaw(s32(m_bufferLoc), SEEK_SET);
+		}
+		m_readPos = 0;
+		m_readEnd = 0;
+		m_writeEnd = m_bufferSize;
+	}
+	if (size > m_writeEnd - m_writePos)
+	{
+		flushWriteBuffer();
+		m_writeEnd = m_bufferSize;
+		// Large writes skip the extra copy.
+		if (size >= m_bufferSize)
+		{
+			m_bufferLoc += fwrite(ptr, 1, size, m_file);
+			return;
+		}
+	}
+	memcpy(m_buffer + m_writePos, ptr, size);
+	m_writePos += size;
+}
+
+bool FileStream::flushWriteBuffer()
+{
+	bool success = true;
+	if (m_writePos && m_file)
+	{
+		const size_t written = fwrite(m_buffer, 1, m_writePos, m_file);
+		m_bufferLoc += written;
+		success = written == m_writePos;
+	}
+	m_writePos = 0;
+	m_writeEnd = 0;
+	return success;
+}
+
+bool FileStream::seekBuffered(s32 offset, Origin origin)
+{
+	// Seeking within the read-ahead data only moves the read position.
+	if (m_readEnd && origin != ORIGIN_END)
+	{
+		const s64 target = origin == ORIGIN_START ? s64(offset) : s64(getLocBuffered()) + offset;
+		if (target >= s64(m_bufferLoc) && target <= s64(m_bufferLoc + m_readEnd))
+		{
+			m_readPos = u32(target - s64(m_bufferLoc));
+			return true;
+		}
+	}
+
+	// The file location is ahead of the logical location while reading.
+	if (origin == ORIGIN_CURRENT)
+	{
+		offset = s32(getLocBuffered() + offset);
+		origin = ORIGIN_START;
+	}
+	flushWriteBuffer();
+	m_readPos = 0;
+	m_readEnd = 0;
+
+	const s32 forigin[] = { SEEK_SET, SEEK_END, SEEK_CUR };
+	const bool success = seekRaw(offset, forigin[origin]);
+	m_bufferLoc = getLocRaw();
+	return success;
+}
+
+size_t FileStream::readRaw(void* ptr, size_t size)
+{
+	if (!size)
+	{
+		return 0;
+	}
+	if (m_file)
+	{
+		return fread(ptr, 1, size, m_file);
+	}
+	else if (m_archive)
+	{
+		return m_archive->readFile(ptr, size);
+	}
+	return 0;
+}
+
+bool FileStream::seekRaw(s32 offset, s32 origin)
+{
+	if (m_file)
+	{
+		return fseek(m_file, offset, origin) == 0;
+	}
+	else if (m_archive)
+	{
+		return m_archive->seekFile(offset, origin);
+	}
+	return false;
+}
+
+size_t FileStream::getLocRaw()
+{
+	if (m_file)
+	{
+		return ftell(m_file);
+	}
+	else if (m_archive)
+	{
+		return m_archive->getLocInFile();
+	}
+	return 0;
+}
@@ -7,6 +7,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #include <TFE_System/system.h>
@@ -58,6 +59,27 @@ namespace FileUtil
 		closedir(d);
 	}
 
+	void readDirectoryFiles(const char *dir, FileList& fileList)
+	{
+		char buf[PATH_MAX];
+		struct dirent *de;
+		struct stat st;
+		DIR *d;
+
+		// Search directories that do not exist are skipped silently, like the Windows version.
+		d = opendir(dir);
+		if (!d)
+			return;
+
+		while (NULL != (de = readdir(d))) {
+			snprintf(buf, PATH_MAX - 1, "%s%s", dir, de->d_name);
+			if (stat(buf, &st) || !S_ISREG(st.st_mode))
+				continue;
+			fileList.push_back(string(de->d_name));
+		}
+		closedir(d);
+	}
+
 	void readSubdirectories(const char *dir, FileList& dirList)
 	{
 		char *dn, fp[PATH_MAX];
@@ -421,4 +443,89 @@ namespace FileUtil
 			strcpy(outPath, srcPath);
 		}
 	}
+
+	bool mapFile(const char *path, MappedFile *file)
+	{
+		file->data = nullptr;
+		file->size = 0;
+
+		int fd = open(path, O_RDONLY);
+		if ((fd < 0) && (errno == ENOENT)) {
+			char *fn = findFileNoCase(path);
+			if (fn) {
+				fd = open(fn, O_RDONLY);
+				free(fn);
+			}
+		}
+		if (fd < 0)
+			return false;
+
+		struct stat st;
+		if (fstat(fd, &st) || st.st_size <= 0) {
+			close(fd);
+			return false;
+		}
+
+		// the mapping stays valid after the descriptor is closed.
+		void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (data == MAP_FAILED)
+			return false;
+
+		file->data = (const u8 *)data;
+		file->size = (size_t)st.st_size;
+		return true;
+	}
+
+	void unmapFile(MappedFile *file)
+	{
+		if (file->data)
+			munmap((void *)file->data, file->size);
+		file->data = nullptr;
+		file->size = 0;
+	}
+
+	FileHandle openReadHandle(const char *path)
+	{
+		int fd = open(path, O_RDONLY);
+		if ((fd < 0) && (errno == ENOENT)) {
+			char *fn = findFileNoCase(path);
+			if (fn) {
+				fd = open(fn, O_RDONLY);
+				free(fn);
+			}
+		}
+		return (fd < 0) ? INVALID_FILE_HANDLE : (FileHandle)fd;
+	}
+
+	void closeReadHandle(FileHandle handle)
+	{
+		if (handle != INVALID_FILE_HANDLE)
+			close((int)handle);
+	}
+
+	size_t readAt(FileHandle handle, u64 offset, void *dst, size_t size)
+	{
+		if (handle == INVALID_FILE_HANDLE)
+			return 0;
+
+		size_t total = 0;
+		while (total < size) {
+			ssize_t ret = pread((int)handle, (u8 *)dst + total, size - total, (off_t)(offset + total));
+			if ((ret < 0) && (errno == EINTR))
+				continue;
+			if (ret <= 0)
+				break;
+			total += (size_t)ret;
+		}
+		return total;
+	}
+
+	u64 getHandleSize(FileHandle handle)
+	{
+		struct stat st;
+		if ((handle == INVALID_FILE_HANDLE) || (fstat((int)handle, &st) != 0))
+			return 0;
+		return (u64)st.st_size;
+	}
 }
@@ -30,6 +30,26 @@ namespace FileUtil
 		}
 	}
 
+	void readDirectoryFiles(const char* dir, FileList& fileList)
+	{
+		char searchStr[TFE_MAX_PATH];
+		_finddata_t fileInfo;
+
+		sprintf(searchStr, "%s*", dir);
+		intptr_t hFile = _findfirst(searchStr, &fileInfo);
+		if (hFile != -1)
+		{
+			do
+			{
+				if (!(fileInfo.attrib & _A_SUBDIR))
+				{
+					fileList.push_back( string(fileInfo.name) );
+				}
+			} while ( _findnext(hFile, &fileInfo) == 0 );
+			_findclose(hFile);
+		}
+	}
+
 	void readSubdirectories(const char* dir, FileList& dirList)
 	{
 		#ifdef _WIN32
@@ -341,4 +361,96 @@ namespace FileUtil
 			strcpy(outPath, srcPath);
 		}
 	}
+
+	bool mapFile(const char* path, MappedFile* file)
+	{
+		file->data = nullptr;
+		file->size = 0;
+
+		HANDLE fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(fileHandle, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(fileHandle);
+			return false;
+		}
+
+		// The view keeps a reference to the mapping, so both handles can be closed once it exists.
+		HANDLE mapping = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+		CloseHandle(fileHandle);
+		if (!mapping)
+		{
+			return false;
+		}
+		void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		if (!data)
+		{
+			return false;
+		}
+
+		file->data = (const u8*)data;
+		file->size = size_t(size.QuadPart);
+		return true;
+	}
+
+	void unmapFile(MappedFile* file)
+	{
+		if (file->data)
+		{
+			UnmapViewOfFile(file->data);
+		}
+		file->data = nullptr;
+		file->size = 0;
+	}
+
+	FileHandle openReadHandle(const char* path)
+	{
+		HANDLE fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		return fileHandle == INVALID_HANDLE_VALUE ? INVALID_FILE_HANDLE : FileHandle(fileHandle);
+	}
+
+	void closeReadHandle(FileHandle handle)
+	{
+		if (handle == INVALID_FILE_HANDLE) { return; }
+		CloseHandle(HANDLE(handle));
+	}
+
+	size_t readAt(FileHandle handle, u64 offset, void* dst, size_t size)
+	{
+		if (handle == INVALID_FILE_HANDLE) { return 0; }
+
+		size_t totalRead = 0;
+		while (totalRead < size)
+		{
+			// The offset is passed with each read, the file pointer is not used.
+			OVERLAPPED overlapped = {};
+			const u64 readOffset = offset + totalRead;
+			overlapped.Offset     = DWORD(readOffset);
+			overlapped.OffsetHigh = DWORD(readOffset >> 32ull);
+
+			// Windows.h defines min(), so clamp explicitly.
+			const size_t remaining = size - totalRead;
+			const DWORD sizeToRead = DWORD(remaining < 0x40000000 ? remaining : 0x40000000);
+			DWORD bytesRead = 0;
+			if (!ReadFile(HANDLE(handle), (u8*)dst + totalRead, sizeToRead, &bytesRead, &overlapped) || bytesRead == 0)
+			{
+				break;
+			}
+			totalRead += bytesRead;
+		}
+		return totalRead;
+	}
+
+	u64 getHandleSize(FileHandle handle)
+	{
+		LARGE_INTEGER size;
+		if (handle == INVALID_FILE_HANDLE || !GetFileSizeEx(HANDLE(handle), &size)) { return 0; }
+		return u64(size.QuadPart);
+	}
 }
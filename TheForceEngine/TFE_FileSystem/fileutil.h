@@ -6,9 +6,22 @@
 using namespace std;
 typedef vector<string> FileList;
 
+// Read-only handle for positional reads, see FileUtil::openReadHandle().
+typedef intptr_t FileHandle;
+#define INVALID_FILE_HANDLE intptr_t(-1)
+
+// Read-only view of an entire file mapped into memory.
+struct MappedFile
+{
+	const u8* data;
+	size_t size;
+};
+
 namespace FileUtil
 {
 	void readDirectory(const char* dir, const char* ext, FileList& fileList);
+	// All regular files in 'dir', without subdirectories.
+	void readDirectoryFiles(const char* dir, FileList& fileList);
 	bool makeDirectory(const char* dir);
 	void getCurrentDirectory(char* dir);
 	void getExecutionDirectory(char* dir);
@@ -32,4 +45,17 @@ namespace FileUtil
 
 	void replaceExtension(const char* srcPath, const char* newExt, char* outPath);
 	void stripExtension(const char* srcPath, char* outPath);
+
+	// Map the whole file read-only, returns false if the file cannot be mapped (including empty files).
+	// The file must not be written while it is mapped.
+	bool mapFile(const char* path, MappedFile* file);
+	void unmapFile(MappedFile* file);
+
+	// Positional reads do not use or change a shared file position, so multiple threads can read
+	// from the same handle at once. Returns INVALID_FILE_HANDLE on failure.
+	FileHandle openReadHandle(const char* path);
+	void closeReadHandle(FileHandle handle);
+	// Read 'size' bytes starting at 'offset', returns the number of bytes read.
+	size_t readAt(FileHandle handle, u64 offset, void* dst, size_t size);
+	u64  getHandleSize(FileHandle handle);
 }
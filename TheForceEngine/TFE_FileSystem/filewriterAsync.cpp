@@ -1,99 +1,294 @@
+#include <cstring>
 #include "filewriterAsync.h"
+#include "paths.h"
+#include <TFE_System/profiler.h>
+#include <SDL.h>
 #include <assert.h>
 #include <stdio.h>
-#include <stdarg.h>
+#include <algorithm>
+#include <deque>
+#include <string>
 #include <vector>
 
 #ifdef _WIN32
-#define WIN32_LEAN_AND_MEAN 1
-#include <Windows.h>
+#include <io.h>
+#else
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace FileUtil
+{
+	extern char* findFileNoCase(const char *fn);
+}
 #endif
 
 namespace FileWriterAsync
 {
-#ifdef _WIN32
-	#define MAX_REQUEST_COUNT 32
-
 	struct WriteRequest
 	{
+		std::string path;
 		std::vector<u8> buffer;
-		OVERLAPPED file;
+		AsyncFileSyncPolicy syncPolicy;
 
 		FileWriteCompletionCallback callback;
 		void* userData;
+		size_t bytesWritten;
+		u32 errorCode;
 	};
-	WriteRequest s_requests[MAX_REQUEST_COUNT];
-	s32 s_freeRequests[MAX_REQUEST_COUNT];
-	s32 s_processRequest[MAX_REQUEST_COUNT];
 
-	std::atomic<s32> s_requestCount = 0;
-	std::atomic<s32> s_freeRequestCount = 0;
-	std::atomic<s32> s_processRequestCount = 0;
+	// Shared with the I/O thread, guarded by s_mutex.
+	static std::deque<WriteRequest*> s_queue;
+	static std::vector<WriteRequest*> s_completed;
+	static u32 s_requestsInFlight = 0;		// Queued or being written.
+	static size_t s_bytesInFlight = 0;
+	static bool s_quit = false;
 
-	void CALLBACK fileWrittenCallback(DWORD dwErrorCode, DWORD dwBytesTransferred, LPOVERLAPPED lpOverlapped)
+	static SDL_mutex* s_mutex = nullptr;
+	static SDL_cond* s_workCond = nullptr;	// Signaled when a write is queued or on shutdown.
+	static SDL_cond* s_doneCond = nullptr;	// Signaled when a write finishes.
+	static SDL_Thread* s_thread = nullptr;
+
+	// Main thread only.
+	static std::vector<WriteRequest*> s_callbacks;
+	static s32 s_queueDepth = 0;
+	static s32 s_bytesInFlightCounter = 0;
+
+	void writeRequest(WriteRequest* request)
 	{
-		// Note that this won't be called unless the calling thread is waiting in an "alertable" state.
-		const size_t id = (size_t)lpOverlapped->hEvent;
-		WriteRequest& request = s_requests[id];
+		char path[TFE_MAX_PATH];
+		strncpy(path, request->path.c_str(), TFE_MAX_PATH - 1);
+		path[TFE_MAX_PATH - 1] = 0;
+	#ifndef _WIN32
+		// Relative paths are relative to the system paths, see FileStream::open().
+		if (path[0] != '/') { TFE_Paths::mapSystemPath(path); }
+	#endif
 
-		if (dwErrorCode == 0 && request.callback)	// Success
+		request->bytesWritten = 0;
+		FILE* file = fopen(path, "wb");
+	#ifndef _WIN32
+		// Try a matching file name with a different case, like FileStream::open().
+		if (!file && errno == ENOENT)
 		{
-			request.callback(size_t(dwBytesTransferred), request.userData, u32(dwErrorCode));
+			char* pathNoCase = FileUtil::findFileNoCase(path);
+			if (pathNoCase)
+			{
+				file = fopen(pathNoCase, "wb");
+				free(pathNoCase);
+			}
 		}
-		else if (request.callback)  // Failure
+	#endif
+		if (!file)
 		{
-			request.callback(0, request.userData, u32(dwErrorCode));
+			request->errorCode = AFW_ERROR_OPEN;
+			return;
 		}
 
-		request.buffer.clear();
-		s_freeRequests[s_freeRequestCount++] = id;
+		const size_t size = request->buffer.size();
+		request->bytesWritten = size ? fwrite(request->buffer.data(), 1, size, file) : 0;
+		request->errorCode = request->bytesWritten == size ? AFW_SUCCESS : AFW_ERROR_WRITE;
+		if (fflush(file) != 0 && request->errorCode == AFW_SUCCESS)
+		{
+			request->errorCode = AFW_ERROR_WRITE;
+		}
+		if (request->syncPolicy == AFW_SYNC_FILE && request->errorCode == AFW_SUCCESS)
+		{
+		#ifdef _WIN32
+			const bool synced = _commit(_fileno(file)) == 0;
+		#else
+			const bool synced = fsync(fileno(file)) == 0;
+		#endif
+			if (!synced) { request->errorCode = AFW_ERROR_SYNC; }
+		}
+		if (fclose(file) != 0 && request->errorCode == AFW_SUCCESS)
+		{
+			request->errorCode = AFW_ERROR_WRITE;
+		}
 	}
 
-	bool writeFileToDisk(const char* path, u8* data, size_t dataSize, FileWriteCompletionCallback completionCallback, void* userData)
+	int ioThreadFunc(void* userData)
 	{
-		size_t index = 0;
-		if (s_freeRequestCount)
+		SDL_LockMutex(s_mutex);
+		while (1)
 		{
-			index = s_freeRequests[s_freeRequestCount - 1];
-			s_freeRequestCount--;
+			while (s_queue.empty() && !s_quit)
+			{
+				SDL_CondWait(s_workCond, s_mutex);
+			}
+			// Queued writes are always finished, even when shutting down.
+			if (s_queue.empty()) { break; }
+
+			WriteRequest* request = s_queue.front();
+			s_queue.pop_front();
+			SDL_UnlockMutex(s_mutex);
+
+			writeRequest(request);
+
+			SDL_LockMutex(s_mutex);
+			s_requestsInFlight--;
+			s_bytesInFlight -= request->buffer.size();
+			std::vector<u8>().swap(request->buffer);
+			s_completed.push_back(request);
+			SDL_CondBroadcast(s_doneCond);
 		}
-		else if (s_requestCount < MAX_REQUEST_COUNT)
+		SDL_UnlockMutex(s_mutex);
+		return 0;
+	}
+
+	bool init()
+	{
+		if (s_thread) { return true; }
+
+		s_quit = false;
+		s_mutex = SDL_CreateMutex();
+		s_workCond = SDL_CreateCond();
+		s_doneCond = SDL_CreateCond();
+		if (s_mutex && s_workCond && s_doneCond)
 		{
-			index = s_requestCount;
-			s_requestCount++;
+			s_thread = SDL_CreateThread(ioThreadFunc, "TFE_FileWriter", nullptr);
 		}
-		else
+		if (!s_thread)
 		{
+			TFE_System::logWrite(LOG_ERROR, "AsyncFileWrite", "Cannot create the I/O thread: %s, files will be written immediately.", SDL_GetError());
+			shutdown();
 			return false;
 		}
 
-		WriteRequest* request = &s_requests[index];
-		request->buffer.resize(dataSize);
-		memcpy(request->buffer.data(), data, dataSize);
+		TFE_COUNTER(s_queueDepth, "Async Write Queue Depth");
+		TFE_COUNTER(s_bytesInFlightCounter, "Async Write Bytes In Flight");
+		return true;
+	}
 
-		request->callback = completionCallback;
-		request->userData = userData;
+	void shutdown()
+	{
+		if (s_thread)
+		{
+			SDL_LockMutex(s_mutex);
+			s_quit = true;
+			SDL_CondSignal(s_workCond);
+			SDL_UnlockMutex(s_mutex);
+
+			SDL_WaitThread(s_thread, nullptr);
+			s_thread = nullptr;
+		}
+		// Call the remaining callbacks.
+		update();
+
+		if (s_doneCond) { SDL_DestroyCond(s_doneCond); }
+		if (s_workCond) { SDL_DestroyCond(s_workCond); }
+		if (s_mutex) { SDL_DestroyMutex(s_mutex); }
+		s_doneCond = nullptr;
+		s_workCond = nullptr;
+		s_mutex = nullptr;
+	}
 
-		HANDLE hFile = CreateFile(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_FLAG_OVERLAPPED, NULL);
-		if (hFile == INVALID_HANDLE_VALUE)
+	void completeRequest(WriteRequest* request)
+	{
+		if (request->errorCode != AFW_SUCCESS && request->errorCode != AFW_SUPERSEDED)
 		{
-			TFE_System::logWrite(LOG_ERROR, "AsyncFileWrite", "Cannot create file handle for: %s", path);
-			return false;
+			TFE_System::logWrite(LOG_ERROR, "AsyncFileWrite", "Cannot write file: %s (error %u)", request->path.c_str(), request->errorCode);
+		}
+		if (request->callback)
+		{
+			request->callback(request->bytesWritten, request->userData, request->errorCode);
+		}
+		delete request;
+	}
+
+	void update()
+	{
+		if (!s_mutex) { return; }
+
+		SDL_LockMutex(s_mutex);
+		s_callbacks.swap(s_completed);
+		s_queueDepth = s32(s_requestsInFlight);
+		s_bytesInFlightCounter = s32(s_bytesInFlight);
+		SDL_UnlockMutex(s_mutex);
+
+		// Callbacks are called without holding the lock, so they may queue more writes.
+		const size_t count = s_callbacks.size();
+		for (size_t i = 0; i < count; i++)
+		{
+			completeRequest(s_callbacks[i]);
 		}
+		s_callbacks.clear();
+	}
 
-		memset(&request->file, 0, sizeof(OVERLAPPED));
-		request->file.Offset = 0;
-		request->file.OffsetHigh = 0;
-		request->file.hEvent = HANDLE(index);
+	void flush()
+	{
+		if (!s_thread) { return; }
 
-		if (!WriteFileEx(hFile, request->buffer.data(), DWORD(dataSize), &request->file, fileWrittenCallback))
+		SDL_LockMutex(s_mutex);
+		while (s_requestsInFlight)
 		{
-			TFE_System::logWrite(LOG_ERROR, "AsyncFileWrite", "Cannot write file: %s", path);
-			return false;
+			SDL_CondWait(s_doneCond, s_mutex);
 		}
+		SDL_UnlockMutex(s_mutex);
+		update();
+	}
+
+	bool writeFileToDisk(const char* path, const u8* data, size_t dataSize, FileWriteCompletionCallback completionCallback, void* userData, AsyncFileSyncPolicy syncPolicy)
+	{
+		if (!path || !path[0] || (!data && dataSize)) { return false; }
+
+		WriteRequest* request = new WriteRequest();
+		request->path = path;
+		request->buffer.assign(data, data + dataSize);
+		request->syncPolicy = syncPolicy;
+		request->callback = completionCallback;
+		request->userData = userData;
+		request->bytesWritten = 0;
+		request->errorCode = AFW_SUCCESS;
+
+		if (!s_thread)
+		{
+			writeRequest(request);
+			const bool success = request->errorCode == AFW_SUCCESS;
+			completeRequest(request);
+			return success;
+		}
+
+		SDL_LockMutex(s_mutex);
+		while (1)
+		{
+			// Coalesce with a queued write to the same file, only the newest data needs to be written.
+			// The queue is searched again after waiting, since the I/O thread may have started the older write.
+			size_t index = 0;
+			while (index < s_queue.size() && s_queue[index]->path != request->path) { index++; }
+			if (index < s_queue.size())
+			{
+				WriteRequest* superseded = s_queue[index];
+				// The replacement data counts against the byte limit, unless it is the only write in flight.
+				const size_t bytesInFlight = s_bytesInFlight - superseded->buffer.size() + dataSize;
+				if (s_requestsInFlight > 1 && bytesInFlight > AFW_MAX_BYTES_IN_FLIGHT)
+				{
+					SDL_CondWait(s_doneCond, s_mutex);
+					continue;
+				}
+				// Keep the stricter sync policy, so a save is still flushed if a newer write does not ask for it.
+				request->syncPolicy = std::max(request->syncPolicy, superseded->syncPolicy);
+				s_queue[index] = request;
+				s_bytesInFlight = bytesInFlight;
 
-		CloseHandle(hFile);
+				std::vector<u8>().swap(superseded->buffer);
+				superseded->errorCode = AFW_SUPERSEDED;
+				s_completed.push_back(superseded);
+				break;
+			}
+
+			// Wait for space, a single write larger than the byte limit is allowed once the queue is empty.
+			if (s_requestsInFlight >= AFW_MAX_QUEUE_DEPTH || (s_requestsInFlight && s_bytesInFlight + dataSize > AFW_MAX_BYTES_IN_FLIGHT))
+			{
+				SDL_CondWait(s_doneCond, s_mutex);
+				continue;
+			}
+			s_queue.push_back(request);
+			s_requestsInFlight++;
+			s_bytesInFlight += dataSize;
+			SDL_CondSignal(s_workCond);
+			break;
+		}
+		SDL_UnlockMutex(s_mutex);
 		return true;
 	}
-#endif
 };
@@ -1,15 +1,55 @@
 #pragma once
+//////////////////////////////////////////////////////////////////////
+// Asynchronous File Writer
+// Writes whole files on a dedicated I/O thread so screenshots, saves
+// and GIF recordings do not stall the frame.
+//
+// * The data is copied when the write is queued.
+// * The queue is bounded by request count and bytes in flight, a
+//   write that does not fit waits for earlier writes to finish.
+// * A queued write to the same path as a newer write is dropped, its
+//   callback is called with AFW_SUPERSEDED. The newer write keeps the
+//   stricter of the two sync policies.
+// * Completion callbacks are called on the main thread from update()
+//   or flush(), failures are logged.
+// * Before init() or if the I/O thread cannot be started, files are
+//   written immediately.
+//////////////////////////////////////////////////////////////////////
 #include <TFE_System/system.h>
 
-// TODO: Flesh out error codes.
 enum AsyncFileWriteCodes
 {
 	AFW_SUCCESS = 0,
+	AFW_SUPERSEDED,		// A newer write to the same path was queued before this one started.
+	AFW_ERROR_OPEN,
+	AFW_ERROR_WRITE,
+	AFW_ERROR_SYNC,
+};
+
+enum AsyncFileSyncPolicy
+{
+	AFW_SYNC_NONE = 0,	// Leave flushing to the OS, used for screenshots and recordings.
+	AFW_SYNC_FILE,		// Flush the file to the device before completing, used for saves.
 };
 
 typedef void(*FileWriteCompletionCallback)(size_t bytesWritten, void* userData, u32 errorCode);
 
 namespace FileWriterAsync
 {
-	bool writeFileToDisk(const char* path, u8* data, size_t dataSize, FileWriteCompletionCallback completionCallback = nullptr, void* userData = nullptr);
+	enum AsyncFileWriterConst : u32
+	{
+		AFW_MAX_QUEUE_DEPTH    = 32,
+		AFW_MAX_BYTES_IN_FLIGHT = 256u * 1024u * 1024u,
+	};
+
+	bool init();
+	// Finish any queued writes and stop the I/O thread.
+	void shutdown();
+	// Call once per frame on the main thread, calls the completion callbacks and updates the profiler counters.
+	void update();
+	// Wait for all queued writes to finish and call their callbacks, such as before reading a file back.
+	void flush();
+
+	bool writeFileToDisk(const char* path, const u8* data, size_t dataSize, FileWriteCompletionCallback completionCallback = nullptr,
+		void* userData = nullptr, AsyncFileSyncPolicy syncPolicy = AFW_SYNC_NONE);
 };
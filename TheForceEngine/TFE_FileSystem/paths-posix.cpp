@@ -3,6 +3,8 @@
 #include "paths.h"
 #include "fileutil.h"
 #include "filestream.h"
+#include "fileIndex.h"
+#include "filePrefetch.h"
 #include <TFE_System/system.h>
 #include <TFE_Archive/archive.h>
 #include <algorithm>
@@ -26,6 +28,7 @@ namespace TFE_Paths
 	static std::deque<Archive*> s_localArchives;
 	static std::deque<std::string> s_searchPaths;
 	static std::deque<FileMapping> s_fileMappings;
+	static bool s_fileIndexDirty = true;
 	static std::deque<std::string> s_systemPaths;	// TFE Support data paths
 
 	bool isPortableInstall();
@@ -209,6 +212,7 @@ namespace TFE_Paths
 			}
 		}
 		s_searchPaths.push_back(workpath);
+		s_fileIndexDirty = true;
 	}
 
 	void addSearchPathToHead(const char *fullPath)
@@ -227,19 +231,24 @@ namespace TFE_Paths
 			}
 		}
 		s_searchPaths.push_front(workpath);
+		s_fileIndexDirty = true;
 	}
 
 	void clearSearchPaths(void)
 	{
 		s_searchPaths.clear();
 		s_fileMappings.clear();
+		s_fileIndexDirty = true;
 	}
 
 	void clearLocalArchives(void)
 	{
+		// Prefetch reads must complete before the archives are freed.
+		TFE_FilePrefetch::prefetch_clear();
 		std::for_each(s_localArchives.begin(), s_localArchives.end(),
 				[](Archive *a) { Archive::freeArchive(a); });
 		s_localArchives.clear();
+		s_fileIndexDirty = true;
 	}
 
 	// Add a single file that can be referenced by 'fileName' even though the real name may be different.
@@ -255,6 +264,7 @@ namespace TFE_Paths
 
 		FileMapping mapping = { fileNameLC, filePathFixed };
 		s_fileMappings.push_back(mapping);
+		s_fileIndexDirty = true;
 	}
 
 	void addLocalSearchPath(const char *locpath)
@@ -287,61 +297,104 @@ namespace TFE_Paths
 	void addLocalArchiveToFront(Archive *a)
 	{
 		s_localArchives.push_front(a);
+		s_fileIndexDirty = true;
 	}
 
 	void removeFirstArchive(void)
 	{
 		s_localArchives.pop_front();
+		s_fileIndexDirty = true;
 	}
 
+	// Archives are frequently added to the end of the list and removed again (menus, cutscenes), since the
+	// last archive has the lowest priority the index can be updated in place instead of being rebuilt.
 	void addLocalArchive(Archive *a)
 	{
 		s_localArchives.push_back(a);
+		if (!s_fileIndexDirty)
+			TFE_FileIndex::addArchive(a);
 	}
 
 	void removeLastArchive(void)
 	{
+		Archive *a = s_localArchives.back();
 		s_localArchives.pop_back();
+		if (s_fileIndexDirty)
+			return;
+
+		// Entries are only safe to remove if the archive is not also referenced from elsewhere in the list.
+		if (std::find(s_localArchives.begin(), s_localArchives.end(), a) == s_localArchives.end())
+			TFE_FileIndex::removeArchive(a);
+		else
+			s_fileIndexDirty = true;
+	}
+
+	void invalidateFileIndex(void)
+	{
+		s_fileIndexDirty = true;
+	}
+
+	// Add everything in search order: file mappings, then search paths, then archives.
+	void rebuildFileIndex(void)
+	{
+		TFE_FileIndex::clear();
+		for (auto it = s_fileMappings.begin(); it != s_fileMappings.end(); it++)
+			TFE_FileIndex::addFile(it->fileName.c_str(), it->realPath.c_str());
+		for (auto it = s_searchPaths.begin(); it != s_searchPaths.end(); it++)
+			TFE_FileIndex::addDirectory(it->c_str());
+		for (auto it = s_localArchives.begin(); it != s_localArchives.end(); it++)
+			TFE_FileIndex::addArchive(*it);
+		s_fileIndexDirty = false;
+	}
+
+	bool isFileMapping(const char *fileName)
+	{
+		for (auto it = s_fileMappings.begin(); it != s_fileMappings.end(); it++) {
+			if (strcasecmp(it->fileName.c_str(), fileName) == 0)
+				return true;
+		}
+		return false;
 	}
 
 	bool getFilePath(const char *fileName, FilePath *outPath)
 	{
 		char fullname[TFE_MAX_PATH];
+		bool indexed;
 
 		outPath->archive = nullptr;
 		outPath->index = INVALID_FILE;
 		outPath->path[0] = 0;
 
-		// Search for any filemappings.
-		// This is usually only used with mods and usually limited to 0-3 files.
-		for (auto it = s_fileMappings.begin(); it != s_fileMappings.end(); it++) {
-			if (0 == strcasecmp(it->fileName.c_str(), fileName)) {
-				strcpy(outPath->path, it->realPath.c_str());
-				return true;
-			}
-		}
+		if (s_fileIndexDirty)
+			rebuildFileIndex();
 
-		// Search in the local search paths before local archives: s_searchPaths.
-		for (auto it = s_searchPaths.begin(); it != s_searchPaths.end(); it++) {
-			sprintf(fullname, "%s%s", it->c_str(), fileName);
-			if (FileUtil::existsNoCase(fullname)) {
-				strncpy(outPath->path, fullname, TFE_MAX_PATH);
-				return true;
-			}
+		indexed = TFE_FileIndex::find(fileName, outPath);
+		// The index is built from directory listings, so a file removed since then is resolved again from a new index.
+		// File mappings are returned as is, like before the index.
+		if (indexed && !outPath->archive && !FileUtil::existsNoCase(outPath->path) && !isFileMapping(fileName)) {
+			outPath->path[0] = 0;
+			rebuildFileIndex();
+			indexed = TFE_FileIndex::find(fileName, outPath);
 		}
 
-		// Then archives: s_localArchives.
-		for (auto it = s_localArchives.begin(); it != s_localArchives.end(); it++) {
-			u32 index = (*it)->getFileIndex(fileName);
-			if (index != INVALID_FILE) {
-				outPath->archive = *it;
-				outPath->index = index;
-				return true;
+		// Files on disk always take priority over archives, so a file in the index is the final result.
+		if (indexed && !outPath->archive)
+			return true;
+
+		// Names with a relative path (such as "LFD/file.lfd") are not part of the search path listings,
+		// so look for them in the search paths before using an archive entry.
+		if (strchr(fileName, '/') || strchr(fileName, '\\')) {
+			for (auto it = s_searchPaths.begin(); it != s_searchPaths.end(); it++) {
+				sprintf(fullname, "%s%s", it->c_str(), fileName);
+				if (FileUtil::existsNoCase(fullname)) {
+					outPath->archive = nullptr;
+					outPath->index = INVALID_FILE;
+					strncpy(outPath->path, fullname, TFE_MAX_PATH);
+					return true;
+				}
 			}
 		}
-
-		// Finally admit defeat.
-		return false;
+		return indexed;
 	}
 
 	// Return true if we want to use a "portable" install - 
@@ -2,8 +2,11 @@
 #include "paths.h"
 #include "fileutil.h"
 #include "filestream.h"
+#include "fileIndex.h"
+#include "filePrefetch.h"
 #include <TFE_System/system.h>
 #include <TFE_Archive/archive.h>
+#include <algorithm>
 #include <string>
 
 #ifdef _WIN32
@@ -31,6 +34,7 @@ namespace TFE_Paths
 	static std::vector<Archive*> s_localArchives;
 	static std::vector<std::string> s_searchPaths;
 	static std::vector<FileMapping> s_fileMappings;
+	static bool s_fileIndexDirty = true;
 
 	bool insertString(char* text, const char* newFragment, const char* pattern);
 	bool isPortableInstall();
@@ -200,6 +204,7 @@ namespace TFE_Paths
 			}
 
 			s_searchPaths.push_back(fullPath);
+			s_fileIndexDirty = true;
 		}
 	}
 
@@ -219,6 +224,7 @@ namespace TFE_Paths
 			}
 
 			s_searchPaths.insert(s_searchPaths.begin(), fullPath);
+			s_fileIndexDirty = true;
 		}
 	}
 
@@ -226,10 +232,14 @@ namespace TFE_Paths
 	{
 		s_searchPaths.clear();
 		s_fileMappings.clear();
+		s_fileIndexDirty = true;
 	}
 
 	void clearLocalArchives()
 	{
+		// Prefetch reads must complete before the archives are freed.
+		TFE_FilePrefetch::prefetch_clear();
+
 		const size_t count = s_localArchives.size();
 		Archive** archive = s_localArchives.data();
 		for (size_t i = 0; i < count; i++)
@@ -237,6 +247,7 @@ namespace TFE_Paths
 			Archive::freeArchive(archive[i]);
 		}
 		s_localArchives.clear();
+		s_fileIndexDirty = true;
 	}
 
 	// Add a single file that can be referenced by 'fileName' even though the real name may be different.
@@ -252,6 +263,7 @@ namespace TFE_Paths
 
 		FileMapping mapping = { fileNameLC, filePathFixed };
 		s_fileMappings.push_back(mapping);
+		s_fileIndexDirty = true;
 	}
 
 	void addLocalSearchPath(const char* localSearchPath)
@@ -284,78 +296,141 @@ namespace TFE_Paths
 	void addLocalArchiveToFront(Archive* archive)
 	{
 		s_localArchives.insert(s_localArchives.begin(), archive);
+		s_fileIndexDirty = true;
 	}
 
 	void removeFirstArchive()
 	{
 		s_localArchives.erase(s_localArchives.begin());
+		s_fileIndexDirty = true;
 	}
 
+	// Archives are frequently added to the end of the list and removed again (menus, cutscenes), since the
+	// last archive has the lowest priority the index can be updated in place instead of being rebuilt.
 	void addLocalArchive(Archive* archive)
 	{
 		s_localArchives.push_back(archive);
+		if (!s_fileIndexDirty)
+		{
+			TFE_FileIndex::addArchive(archive);
+		}
 	}
 
 	void removeLastArchive()
 	{
+		Archive* archive = s_localArchives.back();
 		s_localArchives.pop_back();
+		if (!s_fileIndexDirty)
+		{
+			// Entries are only safe to remove if the archive is not also referenced from elsewhere in the list.
+			if (std::find(s_localArchives.begin(), s_localArchives.end(), archive) == s_localArchives.end())
+			{
+				TFE_FileIndex::removeArchive(archive);
+			}
+			else
+			{
+				s_fileIndexDirty = true;
+			}
+		}
 	}
 
-	bool getFilePath(const char* fileName, FilePath* outPath)
+	void invalidateFileIndex()
 	{
-		outPath->archive = nullptr;
-		outPath->index = INVALID_FILE;
-		outPath->path[0] = 0;
+		s_fileIndexDirty = true;
+	}
 
-		// Search for any filemappings.
-		// This is usually only used with mods and usually limited to 0-3 files.
-		const size_t mappingCount  = s_fileMappings.size();
+	// Add everything in search order: file mappings, then search paths, then archives.
+	void rebuildFileIndex()
+	{
+		TFE_FileIndex::clear();
+
+		const size_t mappingCount = s_fileMappings.size();
 		const FileMapping* mapping = s_fileMappings.data();
 		for (size_t i = 0; i < mappingCount; i++, mapping++)
 		{
-			// Early out if the first character doesn't match to avoid testing the entire string.
-			if (mapping->fileName[0] == tolower(fileName[0]) && strcasecmp(mapping->fileName.c_str(), fileName) == 0)
-			{
-				strcpy(outPath->path, mapping->realPath.c_str());
-				return true;
-			}
+			TFE_FileIndex::addFile(mapping->fileName.c_str(), mapping->realPath.c_str());
 		}
 
-		// Search in the local search paths before local archives: s_searchPaths.
 		const size_t pathCount = s_searchPaths.size();
 		const std::string* localPath = s_searchPaths.data();
 		for (size_t i = 0; i < pathCount; i++, localPath++)
 		{
-			char fullName[TFE_MAX_PATH];
-			sprintf(fullName, "%s%s", localPath->c_str(), fileName);
-
-			FileStream file;
-			if (file.exists(fullName))
-			{
-				strncpy(outPath->path, fullName, TFE_MAX_PATH);
-				return true;
-			}
+			TFE_FileIndex::addDirectory(localPath->c_str());
 		}
 
-		// Then archives: s_localArchives.
 		const size_t archiveCount = s_localArchives.size();
 		Archive** archive = s_localArchives.data();
 		for (size_t i = 0; i < archiveCount; i++, archive++)
 		{
-			if (!(*archive)) { continue; }	// Avoid crashing if an archive is null.
+			TFE_FileIndex::addArchive(*archive);
+		}
+		s_fileIndexDirty = false;
+	}
 
-			u32 index = (*archive)->getFileIndex(fileName);
-			if (index != INVALID_FILE)
+	bool isFileMapping(const char* fileName)
+	{
+		const size_t mappingCount = s_fileMappings.size();
+		const FileMapping* mapping = s_fileMappings.data();
+		for (size_t i = 0; i < mappingCount; i++, mapping++)
+		{
+			if (strcasecmp(mapping->fileName.c_str(), fileName) == 0)
 			{
-				outPath->archive = *archive;
-				outPath->index = index;
 				return true;
 			}
 		}
-
-		// Finally admit defeat.
 		return false;
 	}
+
+	bool getFilePath(const char* fileName, FilePath* outPath)
+	{
+		outPath->archive = nullptr;
+		outPath->index = INVALID_FILE;
+		outPath->path[0] = 0;
+
+		if (s_fileIndexDirty)
+		{
+			rebuildFileIndex();
+		}
+
+		bool indexed = TFE_FileIndex::find(fileName, outPath);
+		// The index is built from directory listings, so a file removed since then is resolved again from a new index.
+		// File mappings are returned as is, like before the index.
+		if (indexed && !outPath->archive && !FileUtil::exists(outPath->path) && !isFileMapping(fileName))
+		{
+			outPath->path[0] = 0;
+			rebuildFileIndex();
+			indexed = TFE_FileIndex::find(fileName, outPath);
+		}
+
+		// Files on disk always take priority over archives, so a file in the index is the final result.
+		if (indexed && !outPath->archive)
+		{
+			return true;
+		}
+
+		// Names with a relative path (such as "LFD/file.lfd") are not part of the search path listings,
+		// so look for them in the search paths before using an archive entry.
+		if (strchr(fileName, '/') || strchr(fileName, '\\'))
+		{
+			const size_t pathCount = s_searchPaths.size();
+			const std::string* localPath = s_searchPaths.data();
+			for (size_t i = 0; i < pathCount; i++, localPath++)
+			{
+				char fullName[TFE_MAX_PATH];
+				sprintf(fullName, "%s%s", localPath->c_str(), fileName);
+
+				FileStream file;
+				if (file.exists(fullName))
+				{
+					outPath->archive = nullptr;
+					outPath->index = INVALID_FILE;
+					strncpy(outPath->path, fullName, TFE_MAX_PATH);
+					return true;
+				}
+			}
+		}
+		return indexed;
+	}
 		
 	bool insertString(char* text, const char* newFragment, const char* pattern)
 	{
@@ -52,7 +52,10 @@ namespace TFE_Paths
 	void removeLastArchive();
 	void addLocalArchiveToFront(Archive* archive);
 	void removeFirstArchive();
+	// Lookups go through a hashed index of the search paths and archives, which is updated when they change.
 	bool getFilePath(const char* fileName, FilePath* path);
+	// Rebuild the index on the next lookup, call this if files are added to or removed from a search path.
+	void invalidateFileIndex();
 
 	// Add a single file that can be referenced by 'fileName' even though the real name may be different.
 	void addSingleFilePath(const char* fileName, const char* filePath);
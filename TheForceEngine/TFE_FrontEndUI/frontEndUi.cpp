@@ -1,6 +1,7 @@
 #include "frontEndUi.h"
 #include "console.h"
 #include "profilerView.h"
+#include "memoryView.h"
 #include "modLoader.h"
 #include <TFE_A11y/accessibility.h>
 #include <TFE_Audio/audioSystem.h>
@@ -303,6 +304,7 @@ namespace TFE_FrontEndUI
 	{
 		TFE_Console::init();
 		TFE_ProfilerView::init();
+		TFE_MemoryView::init();
 	}
 
 	void init()
@@ -380,6 +382,7 @@ namespace TFE_FrontEndUI
 		delete[] s_creditsDisplayStr;
 		TFE_Console::destroy();
 		TFE_ProfilerView::destroy();
+		TFE_MemoryView::destroy();
 
 		s_aboutDisplayStr   = nullptr;
 		s_manualDisplayStr  = nullptr;
@@ -473,6 +476,12 @@ namespace TFE_FrontEndUI
 		TFE_ProfilerView::enable(!isEnabled);
 	}
 
+	void toggleMemoryView()
+	{
+		bool isEnabled = TFE_MemoryView::isEnabled();
+		TFE_MemoryView::enable(!isEnabled);
+	}
+
 	void showNoGameDataUI()
 	{
 		char settingsPath[TFE_MAX_PATH];
@@ -571,6 +580,10 @@ namespace TFE_FrontEndUI
 		{
 			TFE_ProfilerView::update();
 		}
+		if (TFE_MemoryView::isEnabled())
+		{
+			TFE_MemoryView::update();
+		}
 		if (noGameData)
 		{
 			s_subUI = FEUI_CONFIG;
@@ -1198,6 +1211,12 @@ namespace TFE_FrontEndUI
 			gameSettings->df_solidWallFlagFix = solidWallFlagFix;
 		}
 
+		bool actorSimLod = gameSettings->df_actorSimLod;
+		if (ImGui::Checkbox("Reduce update rate of distant, unseen enemies (non-vanilla)", &actorSimLod))
+		{
+			gameSettings->df_actorSimLod = actorSimLod;
+		}
+
 		if (s_drawNoGameDataMsg)
 		{
 			ImGui::Separator();
@@ -66,5 +66,6 @@ namespace TFE_FrontEndUI
 	bool getCanSave();
 
 	void toggleProfilerView();
+	void toggleMemoryView();
 	void drawFps(s32 windowWidth);
 }
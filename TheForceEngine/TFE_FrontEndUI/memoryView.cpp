@@ -0,0 +1,158 @@
+#include "memoryView.h"
+#include "console.h"
+#include <TFE_System/system.h>
+#include <TFE_FileSystem/paths.h>
+#include <TFE_Memory/allocTracker.h>
+#include <TFE_Ui/ui.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace TFE_Memory;
+
+namespace TFE_MemoryView
+{
+	enum SortMode
+	{
+		SORT_LIVE = 0,
+		SORT_PEAK,
+		SORT_ALLOCS_PER_FRAME,
+		SORT_COUNT
+	};
+
+	static bool s_open = false;
+	static s32 s_sortMode = SORT_LIVE;
+	static std::vector<AllocTagStats> s_stats;
+	static std::vector<u32> s_rootOrder;
+
+	void c_memView(const ConsoleArgList& args)
+	{
+		enable(!isEnabled());
+	}
+
+	void c_memDump(const ConsoleArgList& args)
+	{
+		dumpCsv();
+	}
+
+	bool init()
+	{
+		CCMD("memView", c_memView, 0, "Toggle the memory view, which shows allocations by tag.");
+		CCMD("memDump", c_memDump, 0, "Write the allocation stats of each tag to allocStats.csv in the user documents folder.");
+		return true;
+	}
+
+	void destroy()
+	{
+		s_stats.clear();
+		s_rootOrder.clear();
+	}
+
+	bool dumpCsv()
+	{
+		char path[TFE_MAX_PATH];
+		TFE_Paths::appendPath(PATH_USER_DOCUMENTS, "allocStats.csv", path);
+		return allocTracker_writeCsv(path);
+	}
+
+	s64 getSortKey(const AllocTagStats& stats)
+	{
+		switch (s_sortMode)
+		{
+			case SORT_PEAK: return stats.peakBytes;
+			case SORT_ALLOCS_PER_FRAME: return stats.allocsLastFrame;
+		}
+		return stats.liveBytes;
+	}
+
+	f64 toKB(s64 bytes)
+	{
+		return f64(bytes) / 1024.0;
+	}
+
+	void drawTag(u32 tag)
+	{
+		const AllocTagStats& stats = s_stats[tag];
+		ImGui::Text("%s", stats.name);
+		ImGui::SameLine(f32(220));
+		ImGui::Text("%10.1f", toKB(stats.liveBytes)); ImGui::SameLine(f32(310));
+		ImGui::Text("%8lld", (long long)stats.liveCount); ImGui::SameLine(f32(390));
+		ImGui::Text("%10.1f", toKB(stats.peakBytes)); ImGui::SameLine(f32(480));
+		ImGui::Text("%6u", stats.allocsLastFrame); ImGui::SameLine(f32(550));
+		ImGui::Text("%10.1f", toKB((s64)stats.bytesLastFrame)); ImGui::SameLine(f32(640));
+		ImGui::Text("%10llu", (unsigned long long)stats.totalAllocs);
+
+		// Children are listed, unsorted, below their parent.
+		const u32 count = (u32)s_stats.size();
+		for (u32 c = 0; c < count; c++)
+		{
+			if (s_stats[c].parent != tag) { continue; }
+			ImGui::Indent();
+			drawTag(c);
+			ImGui::Unindent();
+		}
+	}
+
+	void update()
+	{
+		if (!s_open) { return; }
+
+		ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f), ImGuiCond_FirstUseEver);
+		ImGui::SetNextWindowSize(ImVec2(800, 600), ImGuiCond_FirstUseEver);
+		ImGui::Begin("Memory View", &s_open);
+
+		AllocTotals totals;
+		allocTracker_getTotals(&totals);
+		ImGui::Text("Live %0.1fKB   Peak %0.1fKB   Allocations last frame %u (%0.1fKB)", toKB(totals.liveBytes), toKB(totals.peakBytes),
+			totals.allocsLastFrame, toKB((s64)totals.bytesLastFrame));
+
+		ImGui::Text("Sort by"); ImGui::SameLine();
+		ImGui::RadioButton("Live", &s_sortMode, SORT_LIVE); ImGui::SameLine();
+		ImGui::RadioButton("Peak", &s_sortMode, SORT_PEAK); ImGui::SameLine();
+		ImGui::RadioButton("Allocs/Frame", &s_sortMode, SORT_ALLOCS_PER_FRAME); ImGui::SameLine(f32(640));
+		if (ImGui::Button("Dump CSV"))
+		{
+			dumpCsv();
+		}
+		ImGui::Separator();
+
+		const u32 count = allocTracker_getTagCount();
+		s_stats.resize(count);
+		s_rootOrder.clear();
+		for (u32 i = 0; i < count; i++)
+		{
+			allocTracker_getTagStats(i, &s_stats[i]);
+			if (s_stats[i].parent == ALLOC_TAG_NONE) { s_rootOrder.push_back(i); }
+		}
+		std::stable_sort(s_rootOrder.begin(), s_rootOrder.end(), [](u32 a, u32 b)
+		{
+			return getSortKey(s_stats[a]) > getSortKey(s_stats[b]);
+		});
+
+		ImGui::Text("Tag"); ImGui::SameLine(f32(220));
+		ImGui::Text("  Live (KB)"); ImGui::SameLine(f32(310));
+		ImGui::Text("   Count"); ImGui::SameLine(f32(390));
+		ImGui::Text("  Peak (KB)"); ImGui::SameLine(f32(480));
+		ImGui::Text("Allocs"); ImGui::SameLine(f32(550));
+		ImGui::Text("Frame (KB)"); ImGui::SameLine(f32(640));
+		ImGui::Text("     Total");
+		ImGui::Separator();
+
+		for (size_t i = 0; i < s_rootOrder.size(); i++)
+		{
+			drawTag(s_rootOrder[i]);
+		}
+
+		ImGui::End();
+	}
+
+	bool isEnabled()
+	{
+		return s_open;
+	}
+
+	void enable(bool enable)
+	{
+		s_open = enable;
+	}
+}
@@ -0,0 +1,21 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Memory View
+// Shows the allocation tracker counters per tag, with the option
+// to dump them to a CSV file.
+//////////////////////////////////////////////////////////////////////
+
+#include <TFE_System/types.h>
+
+namespace TFE_MemoryView
+{
+	bool init();
+	void destroy();
+
+	void update();
+	bool isEnabled();
+	void enable(bool enable);
+
+	// Write the current allocation stats to 'allocStats.csv' in the user documents folder.
+	bool dumpCsv();
+}
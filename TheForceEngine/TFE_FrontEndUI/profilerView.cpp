@@ -1,4 +1,5 @@
 #include "profilerView.h"
+#include "memoryView.h"
 #include <TFE_Input/input.h>
 #include <TFE_RenderBackend/renderBackend.h>
 #include <TFE_System/system.h>
@@ -9,6 +10,8 @@
 #include <TFE_Ui/ui.h>
 #include <TFE_Ui/markdown.h>
 #include <TFE_System/parser.h>
+#include <TFE_Memory/frameArena.h>
+#include <TFE_System/jobSystem.h>
 
 #include <algorithm>
 
@@ -32,6 +35,16 @@ namespace TFE_ProfilerView
 		ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
 		ImGui::SetNextWindowSize(ImVec2(800, 768));
 		ImGui::Begin("Profiler View", &s_open);
+		if (ImGui::Button("Memory View"))
+		{
+			TFE_MemoryView::enable(!TFE_MemoryView::isEnabled());
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Job Benchmark"))
+		{
+			// Results are written to the log.
+			TFE_Jobs::jobs_benchmark();
+		}
 
 		ImGui::LabelText("##Label", "Counters");
 		ImGui::Separator();
@@ -46,6 +59,45 @@ namespace TFE_ProfilerView
 		}
 		ImGui::Unindent();
 
+		ImGui::Spacing();
+		ImGui::LabelText("##Label", "Frame Arenas");
+		ImGui::Separator();
+		u32 arenaCount = TFE_Memory::frameArena_getCount();
+		ImGui::Indent();
+		for (u32 a = 0; a < arenaCount; a++)
+		{
+			TFE_Memory::FrameArenaStats stats;
+			if (!TFE_Memory::frameArena_getStats(a, &stats)) { continue; }
+			ImGui::Text("%s", stats.name); ImGui::SameLine(80);
+			ImGui::Text("Frame %6.1fKB  Peak %6.1fKB  Capacity %6.1fKB  Overflows %u", f64(stats.frameHighWater) / 1024.0,
+				f64(stats.highWater) / 1024.0, f64(stats.capacity) / 1024.0, stats.overflowCount);
+		}
+		ImGui::Unindent();
+
+		ImGui::Spacing();
+		ImGui::LabelText("##Label", "Job Threads");
+		ImGui::Separator();
+		u32 threadCount = TFE_Jobs::jobs_getThreadCount();
+		ImGui::Indent();
+		for (u32 t = 0; t < threadCount; t++)
+		{
+			TFE_Jobs::JobThreadStats stats;
+			if (!TFE_Jobs::jobs_getThreadStats(t, &stats)) { continue; }
+			ImGui::Text("%s", stats.name); ImGui::SameLine(80);
+			ImGui::Text("Jobs %5u  Steals %5u  Busy %0.3fms", stats.jobCount, stats.stealCount, stats.busyMs);
+
+			ImGui::Indent();
+			for (u32 z = 0; z < stats.zoneCount; z++)
+			{
+				TFE_Jobs::JobZoneStats zone;
+				if (!TFE_Jobs::jobs_getZoneStats(t, z, &zone)) { continue; }
+				ImGui::Text("%0.3fms", zone.timeMs); ImGui::SameLine(f32(128));
+				ImGui::Text("%s (%u)", zone.name, zone.jobCount);
+			}
+			ImGui::Unindent();
+		}
+		ImGui::Unindent();
+
 		ImGui::Spacing();
 		ImGui::LabelText("##Label", "Zones");
 		ImGui::Separator();
@@ -29,6 +29,17 @@ void displayMemoryUsage(const ConsoleArgList& args)
 	sprintf(res, "Level    | %11zu | %16zu | %11zu | %9zu", region_getMemoryUsed(s_levelRegion), region_getMemoryCapacity(s_levelRegion), blockCount, blockSize);
 	TFE_Console::addToHistory(res);
 	TFE_Console::addToHistory("-------------------------------------------------------------------");
+
+	MemoryRegionStats stats;
+	TFE_Console::addToHistory("Region   | Allocations | Free Ranges | Largest Free | Fragmentation");
+	TFE_Console::addToHistory("-------------------------------------------------------------------");
+	region_getStats(s_gameRegion, &stats);
+	sprintf(res, "Game     | %11u | %11u | %12zu | %12.1f%%", stats.allocCount, stats.freeRanges, stats.largestFree, stats.fragmentation * 100.0f);
+	TFE_Console::addToHistory(res);
+	region_getStats(s_levelRegion, &stats);
+	sprintf(res, "Level    | %11u | %11u | %12zu | %12.1f%%", stats.allocCount, stats.freeRanges, stats.largestFree, stats.fragmentation * 100.0f);
+	TFE_Console::addToHistory(res);
+	TFE_Console::addToHistory("-------------------------------------------------------------------");
 }
 
 void game_init()
@@ -55,6 +66,9 @@ void game_clearLevelData()
 
 IGame* createGame(GameID id)
 {
+	// Mods and other files may have been added or removed since the file index was built.
+	TFE_Paths::invalidateFileIndex();
+
 	IGame* game = nullptr;
 	switch (id)
 	{
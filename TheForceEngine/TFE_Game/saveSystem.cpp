@@ -3,6 +3,8 @@
 #include <TFE_System/system.h>
 #include <TFE_Settings/gameSourceData.h>
 #include <TFE_FileSystem/fileutil.h>
+#include <TFE_FileSystem/filewriterAsync.h>
+#include <TFE_FileSystem/memorystream.h>
 
 #include <TFE_RenderBackend/renderBackend.h>
 #include <TFE_Asset/imageAsset.h>
@@ -35,6 +37,10 @@ namespace TFE_SaveSystem
 
 	static u32* s_imageBuffer[2] = { nullptr, nullptr };
 	static size_t s_imageBufferSize[2] = { 0 };
+	// The save is serialized to memory and written to disk on the I/O thread.
+	static MemoryStream s_saveStream;
+	// Set by test_saveRoundTrip() so the next load is timed.
+	static bool s_timeNextLoad = false;
 
 	void saveHeader(Stream* stream, const char* saveName)
 	{
@@ -159,6 +165,8 @@ namespace TFE_SaveSystem
 	void populateSaveDirectory(std::vector<SaveHeader>& dir)
 	{
 		dir.clear();
+		// Make sure saves that are still being written are listed.
+		FileWriterAsync::flush();
 		FileList fileList;
 		FileUtil::readDirectory(s_gameSavePath, "tfe", fileList);
 		size_t saveCount = fileList.size();
@@ -192,12 +200,16 @@ namespace TFE_SaveSystem
 		sprintf(filePath, "%s%s", s_gameSavePath, filename);
 
 		bool ret = false;
-		FileStream stream;
-		if (stream.open(filePath, Stream::MODE_WRITE))
+		s_saveStream.clear();
+		if (s_saveStream.open(Stream::MODE_WRITE))
 		{
-			saveHeader(&stream, saveName);
-			ret = s_game->serializeGameState(&stream, filename, true);
-			stream.close();
+			saveHeader(&s_saveStream, saveName);
+			ret = s_game->serializeGameState(&s_saveStream, filename, true);
+			s_saveStream.close();
+		}
+		if (ret)
+		{
+			ret = FileWriterAsync::writeFileToDisk(filePath, (const u8*)s_saveStream.data(), s_saveStream.getSize(), nullptr, nullptr, AFW_SYNC_FILE);
 		}
 		return ret;
 	}
@@ -206,28 +218,64 @@ namespace TFE_SaveSystem
 	{
 		char filePath[TFE_MAX_PATH];
 		sprintf(filePath, "%s%s", s_gameSavePath, filename);
+		FileWriterAsync::flush();
 
+		const u64 start = TFE_System::getCurrentTimeInTicks();
 		bool ret = false;
 		FileStream stream;
 		if (stream.open(filePath, Stream::MODE_READ))
 		{
+			// The game state is read a few bytes at a time.
+			stream.setBuffered(FileStream::FS_BUFFER_MAX);
 			SaveHeader header;
 			loadHeader(&stream, &header, filename);
 			ret = s_game->serializeGameState(&stream, filename, false);
 			stream.close();
 		}
+		if (s_timeNextLoad)
+		{
+			TFE_System::logWrite(LOG_MSG, "Save Test", "Load '%s': %.3f ms.", filename,
+				1000.0 * TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - start));
+			s_timeNextLoad = false;
+		}
 		return ret;
 	}
 
+	// Test, not called by the engine: save the current game, wait for the file to be written and then load it
+	// back through the normal load request, logging the time taken by each step.
+	// Uncomment the call in update() to run it after a quick save.
+	void test_saveRoundTrip()
+	{
+		const char* filename = "roundtrip.tfe";
+		u64 start = TFE_System::getCurrentTimeInTicks();
+		if (!saveGame(filename, "Round Trip Test"))
+		{
+			TFE_System::logWrite(LOG_ERROR, "Save Test", "Cannot save '%s'.", filename);
+			return;
+		}
+		const f64 saveMs = 1000.0 * TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - start);
+
+		start = TFE_System::getCurrentTimeInTicks();
+		FileWriterAsync::flush();
+		const f64 writeMs = 1000.0 * TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - start);
+		TFE_System::logWrite(LOG_MSG, "Save Test", "Save '%s': %.1f KB, serialized in %.3f ms, written in %.3f ms.",
+			filename, f64(s_saveStream.getSize()) / 1024.0, saveMs, writeMs);
+
+		s_timeNextLoad = true;
+		postLoadRequest(filename);
+	}
+
 	bool loadGameHeader(const char* filename, SaveHeader* header)
 	{
 		char filePath[TFE_MAX_PATH];
 		sprintf(filePath, "%s%s", s_gameSavePath, filename);
+		FileWriterAsync::flush();
 
 		bool ret = false;
 		FileStream stream;
 		if (stream.open(filePath, Stream::MODE_READ))
 		{
+			stream.setBuffered();
 			loadHeader(&stream, header, filename);
 			strcpy(header->fileName, filename);
 			stream.close();
@@ -324,6 +372,8 @@ namespace TFE_SaveSystem
 		else if (inputMapping_getActionState(IAS_QUICK_SAVE) == STATE_PRESSED && canSave)
 		{
 			saveGame(c_quickSaveName, "Quicksave");
+			// Uncomment to time a save and load round trip of the current game.
+			// test_saveRoundTrip();
 			lastState = 1;
 		}
 		else if (inputMapping_getActionState(IAS_QUICK_LOAD) == STATE_PRESSED && !lastState)
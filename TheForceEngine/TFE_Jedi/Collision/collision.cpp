@@ -1,3 +1,4 @@
+#include <cstring>
 #include "collision.h"
 #include <TFE_Jedi/Level/levelData.h>
 #include <TFE_Jedi/Level/rsector.h>
@@ -6,6 +7,8 @@
 #include <TFE_Jedi/Level/rtexture.h>
 #include <TFE_Jedi/Math/core_math.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
+#include <TFE_Game/igame.h>
+#include <TFE_System/system.h>
 // Merge player collision into collision
 #include <TFE_DarkForces/playerCollision.h>
 using namespace TFE_DarkForces;
@@ -134,6 +137,7 @@ namespace TFE_Jedi
 	IntersectionResult pathIntersectsWall(ColPath* path, RWall* wall);
 	vec2_fixed* computeIntersectPos();
 	SecObject* internal_getObjectCollision();
+	static void wallGrid_getCell(const SectorWallGrid* grid, fixed16_16 x, fixed16_16 z, s32* cellX, s32* cellZ);
 			
 	////////////////////////////////////////////////////////
 	// API Implementation
@@ -149,50 +153,108 @@ namespace TFE_Jedi
 		return s_col_hitDist;
 	}
 
-	RWall* collision_pathWallCollision(RSector* sector)
+	// Test s_col_path against a single wall, updating the closest hit.
+	static void collision_pathWallTest(RWall* wall, RWall** hitWall)
 	{
-		RWall* wall = sector->walls;
-		s32 count = sector->wallCount;
-		RWall* hitWall = nullptr;
-		s_col_hitDist = c_maxCollisionDist;
-		for (s32 i = 0; i < sector->wallCount; i++, wall++)
+		if (s_collisionFrameWall == wall->collisionFrame)
 		{
-			if (s_collisionFrameWall == wall->collisionFrame)
+			return;
+		}
+
+		// returns INTERSECT if s_col_path intersects wall, else returns NO_INTERSECT
+		IntersectionResult intersect = pathIntersectsWall(&s_col_path, wall);
+		if (intersect == INTERSECT)
+		{
+			vec2_fixed* pos = computeIntersectPos();
+			if (pos->x != s_col_path.x0 || pos->z != s_col_path.z0)
 			{
-				continue;
-			}
+				fixed16_16 dx = s_col_path.x1 - s_col_path.x0;
+				fixed16_16 dz = s_col_path.z1 - s_col_path.z0;
 
-			// returns INTERSECT if s_col_path intersects wall, else returns NO_INTERSECT
-			IntersectionResult intersect = pathIntersectsWall(&s_col_path, wall);
+				// Essentially a dot product with the (negative) wall normal, which given the wall direction (dir), normal = (-dir.z, dir.x), negative = (dir.z, -dir.x)
+				// So (dx, dz).(dir.z, -dir.x) = dx*dir.z - dz*dir.x
+				// If the path and the wall are parallel or facing opposite directions (i.e. the object is moving away), then there is no intersection.
+				if (mul16(dx, wall->wallDir.z) - mul16(dz, wall->wallDir.x) >= 0)
+				{
+					intersect = NO_INTERSECT;
+				}
+			}
 			if (intersect == INTERSECT)
 			{
-				vec2_fixed* pos = computeIntersectPos();
-				if (pos->x != s_col_path.x0 || pos->z != s_col_path.z0)
+				fixed16_16 dist = distApprox(s_col_path.x0, s_col_path.z0, pos->x, pos->z);
+				if (dist < s_col_hitDist)
 				{
-					fixed16_16 dx = s_col_path.x1 - s_col_path.x0;
-					fixed16_16 dz = s_col_path.z1 - s_col_path.z0;
+					s_col_hitX = pos->x;
+					s_col_hitZ = pos->z;
+					s_col_hitDist = dist;
+					*hitWall = wall;
+				}
+			}
+		}
+	}
 
-					// Essentially a dot product with the (negative) wall normal, which given the wall direction (dir), normal = (-dir.z, dir.x), negative = (dir.z, -dir.x)
-					// So (dx, dz).(dir.z, -dir.x) = dx*dir.z - dz*dir.x
-					// If the path and the wall are parallel or facing opposite directions (i.e. the object is moving away), then there is no intersection.
-					if (mul16(dx, wall->wallDir.z) - mul16(dz, wall->wallDir.x) >= 0)
+	RWall* collision_pathWallCollision(RSector* sector)
+	{
+		RWall* hitWall = nullptr;
+		s_col_hitDist = c_maxCollisionDist;
+
+		SectorWallGrid* grid = sector->wallCount >= COL_WALL_GRID_MIN_WALLS ? collision_getWallGrid(sector) : nullptr;
+		if (grid)
+		{
+			// Only test walls in the cells overlapped by the path bounds.
+			// Candidates are gathered into a bit mask so they are still tested in wall order, which keeps tie breaking identical.
+			s32 cx0, cz0, cx1, cz1;
+			wallGrid_getCell(grid, min(s_col_path.x0, s_col_path.x1), min(s_col_path.z0, s_col_path.z1), &cx0, &cz0);
+			wallGrid_getCell(grid, max(s_col_path.x0, s_col_path.x1), max(s_col_path.z0, s_col_path.z1), &cx1, &cz1);
+
+			s32 minWord = grid->maskWords, maxWord = -1;
+			for (s32 z = cz0; z <= cz1; z++)
+			{
+				for (s32 x = cx0; x <= cx1; x++)
+				{
+					const s32 cell = z * grid->width + x;
+					for (s32 i = grid->cellStart[cell]; i < grid->cellStart[cell + 1]; i++)
 					{
-						intersect = NO_INTERSECT;
+						const s32 wallIndex = grid->cellWalls[i];
+						const s32 word = wallIndex >> 5;
+						grid->wallMask[word] |= 1u << (wallIndex & 31);
+						minWord = min(minWord, word);
+						maxWord = max(maxWord, word);
 					}
 				}
-				if (intersect == INTERSECT)
+			}
+			if (grid->movedCount)
+			{
+				for (s32 w = 0; w < grid->maskWords; w++)
+				{
+					grid->wallMask[w] |= grid->movedMask[w];
+				}
+				minWord = 0;
+				maxWord = grid->maskWords - 1;
+			}
+
+			for (s32 w = minWord; w <= maxWord; w++)
+			{
+				u32 bits = grid->wallMask[w];
+				grid->wallMask[w] = 0;
+				for (s32 wallIndex = w << 5; bits; bits >>= 1, wallIndex++)
 				{
-					fixed16_16 dist = distApprox(s_col_path.x0, s_col_path.z0, pos->x, pos->z);
-					if (dist < s_col_hitDist)
+					if (bits & 1)
 					{
-						s_col_hitX = pos->x;
-						s_col_hitZ = pos->z;
-						s_col_hitDist = dist;
-						hitWall = wall;
+						collision_pathWallTest(&sector->walls[wallIndex], &hitWall);
 					}
 				}
 			}
 		}
+		else
+		{
+			RWall* wall = sector->walls;
+			for (s32 i = 0; i < sector->wallCount; i++, wall++)
+			{
+				collision_pathWallTest(wall, &hitWall);
+			}
+		}
+
 		if (hitWall)
 		{
 			hitWall->collisionFrame = s_collisionFrameWall;
@@ -368,7 +430,7 @@ namespace TFE_Jedi
 		s_colObjZ0 = interval->z0;
 		s_colObjZ1 = interval->z1;
 		s_colObjInterval = interval;
-		s_colObjList = sector->objectList;
+		s_colObjList = sector->objectsDense;
 		s_colObjCount = sector->objectCount;
 		s_colObjMove = interval->move;
 		s_colObjDirX = interval->dirX;
@@ -473,14 +535,11 @@ namespace TFE_Jedi
 			// End of checks to pull out of the loop.
 			/////////////////////////////////////////////
 
-			s32 objCapacity = curSector->objectCapacity;
 			s32 objCount = curSector->objectCount;
-			for (s32 objListIndex = 0, objIndex = 0; objIndex < objCount && objListIndex < objCapacity; objListIndex++)
+			SecObject** objList = curSector->objectsDense;
+			for (s32 objIndex = 0; objIndex < objCount; objIndex++)
 			{
-				SecObject* obj = curSector->objectList[objListIndex];
-				if (!obj) { continue; }
-
-				objIndex++;
+				SecObject* obj = objList[objIndex];
 				if (skipObj && skipObj == obj) { continue; }
 				if (!(obj->entityFlags & entityFlags)) { continue; }
 				if (obj->posWS.x < x0 || obj->posWS.x > x1 || obj->posWS.z < z0 || obj->posWS.z > z1 || obj->posWS.y < y0 || obj->posWS.y > y1)
@@ -947,15 +1006,173 @@ namespace TFE_Jedi
 		return &s_col_intersectPos;
 	}
 
+	////////////////////////////////////////////////////////
+	// Wall Grid
+	// Added for TFE: sectors with many walls get a coarse
+	// grid of wall indices, built on demand. Walls that
+	// move are tracked in 'movedMask' and the grid is
+	// rebuilt once they have stopped moving.
+	////////////////////////////////////////////////////////
+	static void wallGrid_getCell(const SectorWallGrid* grid, fixed16_16 x, fixed16_16 z, s32* cellX, s32* cellZ)
+	{
+		*cellX = clamp((x - grid->boundsMin.x) / grid->cellSize.x, 0, grid->width  - 1);
+		*cellZ = clamp((z - grid->boundsMin.z) / grid->cellSize.z, 0, grid->height - 1);
+	}
+
+	static void wallGrid_getWallCells(const SectorWallGrid* grid, const RWall* wall, s32* cx0, s32* cz0, s32* cx1, s32* cz1)
+	{
+		const vec2_fixed* w0 = wall->w0;
+		const vec2_fixed* w1 = wall->w1;
+		wallGrid_getCell(grid, min(w0->x, w1->x), min(w0->z, w1->z), cx0, cz0);
+		wallGrid_getCell(grid, max(w0->x, w1->x), max(w0->z, w1->z), cx1, cz1);
+	}
+
+	void collision_wallGridMoveVertex(RWall* wall)
+	{
+		RSector* sector = wall->sector;
+		SectorWallGrid* grid = sector->wallGrid;
+		if (!grid) { return; }
+
+		// The previous wall ends at 'w0', so it has moved as well.
+		const s32 prevIndex = wall->id == 0 ? sector->wallCount - 1 : wall->id - 1;
+		const s32 wallIndex[] = { wall->id, prevIndex };
+		for (s32 i = 0; i < 2; i++)
+		{
+			const u32 bit = 1u << (wallIndex[i] & 31);
+			u32* word = &grid->movedMask[wallIndex[i] >> 5];
+			if (!(*word & bit))
+			{
+				*word |= bit;
+				grid->movedCount++;
+			}
+		}
+		grid->moveTick = s_curTick;
+	}
+
+	SectorWallGrid* collision_getWallGrid(RSector* sector)
+	{
+		SectorWallGrid* prevGrid = sector->wallGrid;
+		if (prevGrid && (!prevGrid->movedCount || s_curTick - prevGrid->moveTick < COL_WALL_GRID_SETTLE_TICKS))
+		{
+			return prevGrid;
+		}
+
+		// Compute the bounds from both wall vertices, since the walls may have moved since the sector bounds were computed.
+		const s32 wallCount = sector->wallCount;
+		RWall* wall = sector->walls;
+		vec2_fixed boundsMin = *wall->w0;
+		vec2_fixed boundsMax = *wall->w0;
+		for (s32 i = 0; i < wallCount; i++, wall++)
+		{
+			boundsMin.x = min(boundsMin.x, min(wall->w0->x, wall->w1->x));
+			boundsMin.z = min(boundsMin.z, min(wall->w0->z, wall->w1->z));
+			boundsMax.x = max(boundsMax.x, max(wall->w0->x, wall->w1->x));
+			boundsMax.z = max(boundsMax.z, max(wall->w0->z, wall->w1->z));
+		}
+
+		// Roughly two walls per cell on average.
+		const s32 dim = clamp(s32(sqrtf(f32(wallCount) * 0.5f)), 2, COL_WALL_GRID_MAX_DIM);
+		const s32 cellCount = dim * dim;
+
+		// First pass: count the number of cell entries.
+		SectorWallGrid tmp;
+		tmp.boundsMin = boundsMin;
+		tmp.width = dim;
+		tmp.height = dim;
+		tmp.cellSize.x = max((boundsMax.x - boundsMin.x) / dim + 1, 1);
+		tmp.cellSize.z = max((boundsMax.z - boundsMin.z) / dim + 1, 1);
+
+		s32 entryCount = 0;
+		wall = sector->walls;
+		for (s32 i = 0; i < wallCount; i++, wall++)
+		{
+			s32 cx0, cz0, cx1, cz1;
+			wallGrid_getWallCells(&tmp, wall, &cx0, &cz0, &cx1, &cz1);
+			entryCount += (cx1 - cx0 + 1) * (cz1 - cz0 + 1);
+		}
+
+		// Allocate the grid as a single block, reusing the previous grid if it is large enough.
+		const s32 maskWords = (wallCount + 31) >> 5;
+		const u32 size = u32(sizeof(SectorWallGrid) + sizeof(s32) * (cellCount + 1 + entryCount) + sizeof(u32) * maskWords * 2);
+		SectorWallGrid* grid = prevGrid;
+		if (prevGrid && prevGrid->allocSize < size)
+		{
+			level_free(prevGrid);
+			grid = nullptr;
+		}
+		if (!grid)
+		{
+			grid = (SectorWallGrid*)level_alloc(size);
+			tmp.allocSize = size;
+		}
+		else
+		{
+			tmp.allocSize = grid->allocSize;
+		}
+		*grid = tmp;
+		grid->cellStart = (s32*)(grid + 1);
+		grid->cellWalls = grid->cellStart + cellCount + 1;
+		grid->wallMask = (u32*)(grid->cellWalls + entryCount);
+		grid->movedMask = grid->wallMask + maskWords;
+		grid->maskWords = maskWords;
+		grid->movedCount = 0;
+		grid->moveTick = 0;
+		memset(grid->cellStart, 0, sizeof(s32) * (cellCount + 1));
+		memset(grid->wallMask, 0, sizeof(u32) * maskWords * 2);
+
+		// Second pass: count the walls per cell and convert to start offsets.
+		wall = sector->walls;
+		for (s32 i = 0; i < wallCount; i++, wall++)
+		{
+			s32 cx0, cz0, cx1, cz1;
+			wallGrid_getWallCells(grid, wall, &cx0, &cz0, &cx1, &cz1);
+			for (s32 z = cz0; z <= cz1; z++)
+			{
+				for (s32 x = cx0; x <= cx1; x++)
+				{
+					grid->cellStart[z * dim + x + 1]++;
+				}
+			}
+		}
+		for (s32 c = 0; c < cellCount; c++)
+		{
+			grid->cellStart[c + 1] += grid->cellStart[c];
+		}
+
+		// Third pass: fill in the wall indices, in wall order per cell.
+		wall = sector->walls;
+		for (s32 i = 0; i < wallCount; i++, wall++)
+		{
+			s32 cx0, cz0, cx1, cz1;
+			wallGrid_getWallCells(grid, wall, &cx0, &cz0, &cx1, &cz1);
+			for (s32 z = cz0; z <= cz1; z++)
+			{
+				for (s32 x = cx0; x <= cx1; x++)
+				{
+					const s32 cell = z * dim + x;
+					grid->cellWalls[grid->cellStart[cell]++] = i;
+				}
+			}
+		}
+		// Filling advanced each start to the next cell's start, so shift them back.
+		for (s32 c = cellCount; c > 0; c--)
+		{
+			grid->cellStart[c] = grid->cellStart[c - 1];
+		}
+		grid->cellStart[0] = 0;
+
+		sector->wallGrid = grid;
+		return grid;
+	}
+
 	// This seems to get the first collision hit, regardless if it is the closest.
 	// This means projectile/object collisions may get wonky with a high time interval (low framerate).
 	SecObject* internal_getObjectCollision()
 	{
+		// TFE: The dense object list has no holes.
 		for (; s_colObjCount > 0; s_colObjList++)
 		{
 			SecObject* obj = *s_colObjList;
-			if (!obj) { continue; }
-
 			s_colObjCount--;
 			if (!obj->worldWidth || obj == s_colObjPrev) { continue; }
 
@@ -1099,6 +1316,36 @@ namespace TFE_Jedi
 		return true;
 	}
 
+	// Determine which part of the wall was hit (sign, top, bottom, mid or transparent mid).
+	static void rayCast_wallHit(RayHitInfo* outRayHit, RSector* sector, RWall* wall, fixed16_16 hitX, fixed16_16 hitZ, fixed16_16 y)
+	{
+		outRayHit->hit = RHit_WallMid;
+		outRayHit->sector = sector;
+		outRayHit->wall = wall;
+		if (wall->signTex && *wall->signTex)
+		{
+			fixed16_16 distFromW0 = vec2Length(wall->w0->x - hitX, wall->w0->z - hitZ);
+			if (hitSign(wall, distFromW0, y))
+			{
+				outRayHit->hit = RHit_WallSign;
+				return;
+			}
+		}
+
+		if (wall->nextSector && wall->nextSector->ceilingHeight > sector->ceilingHeight && y < wall->nextSector->ceilingHeight)
+		{
+			outRayHit->hit = RHit_WallTop;
+		}
+		else if (wall->nextSector && wall->nextSector->floorHeight < sector->floorHeight && y > wall->nextSector->floorHeight)
+		{
+			outRayHit->hit = RHit_WallBot;
+		}
+		else if (wall->nextSector) // Is this a transparent mid texture?
+		{
+			outRayHit->hit = RHit_WallMid_Trans;
+		}
+	}
+
 	RayHitInfo collision_rayCast3d(RSector* sector, vec3_fixed p0, vec3_fixed p1, bool stopAtMidTex)
 	{
 		RayHitInfo outRayHit = { RHit_None, nullptr, nullptr };
@@ -1189,38 +1436,315 @@ namespace TFE_Jedi
 			// Wall Hit!
 			else
 			{
-				outRayHit.hit = RHit_WallMid;
-				if (wall->signTex && *wall->signTex)
+				rayCast_wallHit(&outRayHit, sector, wall, p1.x, p1.z, y);
+				break;
+			}
+		}
+		return outRayHit;
+	}
+
+	struct RayBatchState
+	{
+		RSector* sector;
+		// Portals crossed so far, they and their mirrors are skipped in later sectors.
+		// collision_rayCast3d() does the same by marking them with the wall collision frame.
+		RWall* crossed[COL_MAX_BATCH_CROSSED];
+		s32 crossedCount;
+		RWall* hitWall;
+		fixed16_16 hitDist;
+		vec2_fixed hitPos;
+		f32 scaleXZ;
+		JBool first;
+		JBool done;
+		JBool overflow;		// Crossed too many portals, the ray is cast with collision_rayCast3d() instead.
+	};
+
+	static JBool rayCastBatch_wasCrossed(const RayBatchState* ray, const RWall* wall)
+	{
+		for (s32 i = 0; i < ray->crossedCount; i++)
+		{
+			if (wall == ray->crossed[i] || wall == ray->crossed[i]->mirrorWall)
+			{
+				return JTRUE;
+			}
+		}
+		return JFALSE;
+	}
+
+	// Test one sector worth of walls against every ray in the group.
+	// This matches collision_pathWallCollision() for each ray, but each wall is only fetched once for the whole group.
+	static void rayCastBatch_sectorWalls(RSector* sector, const s32* group, s32 groupCount, RayBatchState* state, const vec3_fixed* p0, const vec3_fixed* p1)
+	{
+		for (s32 r = 0; r < groupCount; r++)
+		{
+			state[group[r]].hitWall = nullptr;
+			state[group[r]].hitDist = c_maxCollisionDist;
+		}
+
+		RWall* wall = sector->walls;
+		for (s32 i = 0; i < sector->wallCount; i++, wall++)
+		{
+			for (s32 r = 0; r < groupCount; r++)
+			{
+				const s32 index = group[r];
+				RayBatchState* ray = &state[index];
+				if (rayCastBatch_wasCrossed(ray, wall))
+				{
+					continue;
+				}
+
+				s_col_path.x0 = p0[index].x;
+				s_col_path.z0 = p0[index].z;
+				s_col_path.x1 = p1[index].x;
+				s_col_path.z1 = p1[index].z;
+				if (pathIntersectsWall(&s_col_path, wall) != INTERSECT)
+				{
+					continue;
+				}
+
+				vec2_fixed* pos = computeIntersectPos();
+				if (pos->x != s_col_path.x0 || pos->z != s_col_path.z0)
 				{
-					fixed16_16 distFromW0 = vec2Length(wall->w0->x - p1.x, wall->w0->z - p1.z);
-					if (hitSign(wall, distFromW0, y))
+					fixed16_16 dx = s_col_path.x1 - s_col_path.x0;
+					fixed16_16 dz = s_col_path.z1 - s_col_path.z0;
+					// Moving away from the wall, see collision_pathWallCollision().
+					if (mul16(dx, wall->wallDir.z) - mul16(dz, wall->wallDir.x) >= 0)
 					{
-						outRayHit.hit = RHit_WallSign;
-						outRayHit.sector = sector;
-						outRayHit.wall = wall;
-						break;
+						continue;
 					}
 				}
 
-				if (wall->nextSector && wall->nextSector->ceilingHeight > sector->ceilingHeight && y < wall->nextSector->ceilingHeight)
+				fixed16_16 dist = distApprox(s_col_path.x0, s_col_path.z0, pos->x, pos->z);
+				if (dist < ray->hitDist)
 				{
-					outRayHit.hit = RHit_WallTop;
+					ray->hitPos = *pos;
+					ray->hitDist = dist;
+					ray->hitWall = wall;
 				}
-				else if (wall->nextSector && wall->nextSector->floorHeight < sector->floorHeight && y > wall->nextSector->floorHeight)
+			}
+		}
+	}
+
+	// Advance a single ray after its walls have been tested, returns JFALSE once the ray is resolved.
+	static JBool rayCastBatch_step(RayBatchState* ray, vec3_fixed p0, vec3_fixed p1, bool stopAtMidTex, RayHitInfo* outRayHit)
+	{
+		RSector* sector = ray->sector;
+		RWall* wall = ray->hitWall;
+		if (ray->first)
+		{
+			ray->first = JFALSE;
+			// No walls are hit, so just test against the floor and ceiling in the current sector.
+			if (!wall)
+			{
+				if (p1.y >= sector->floorHeight)
 				{
-					outRayHit.hit = RHit_WallBot;
+					outRayHit->hit = RHit_Floor;
+					outRayHit->sector = sector;
 				}
-				else if (wall->nextSector) // Is this a transparent mid texture?
+				else if (p1.y <= sector->ceilingHeight)
 				{
-					outRayHit.hit = RHit_WallMid_Trans;
+					outRayHit->hit = RHit_Ceiling;
+					outRayHit->sector = sector;
 				}
+				return JFALSE;
+			}
 
-				outRayHit.sector = sector;
-				outRayHit.wall = wall;
-				break;
+			const vec2_float offset = { fixed16ToFloat(p1.x) - fixed16ToFloat(p0.x),
+										fixed16ToFloat(p1.z) - fixed16ToFloat(p0.z) };
+			const f32 lenXZ = sqrtf(offset.x * offset.x + offset.z * offset.z);
+			if (lenXZ < FLT_EPSILON) { return JFALSE; }
+			ray->scaleXZ = 1.0f / lenXZ;
+		}
+		if (!wall) { return JFALSE; }
+
+		fixed16_16 bot, top;
+		if (wall->nextSector && (!(wall->flags1 & WF1_ADJ_MID_TEX) || !stopAtMidTex))
+		{
+			wall_getOpeningHeightRange(wall, &top, &bot);
+			// Determine if the ray trivially passes through.
+			if (p0.y <= bot && p0.y >= top && p1.y <= bot && p1.y >= top)
+			{
+				if (ray->crossedCount >= COL_MAX_BATCH_CROSSED)
+				{
+					ray->overflow = JTRUE;
+					return JFALSE;
+				}
+				ray->sector = wall->nextSector;
+				ray->crossed[ray->crossedCount++] = wall;
+				return JTRUE;
 			}
 		}
-		return outRayHit;
+		else
+		{
+			bot = -SEC_SKY_HEIGHT;
+			top = SEC_SKY_HEIGHT;
+		}
+
+		const vec3_fixed hitPos = { ray->hitPos.x, p1.y, ray->hitPos.z };
+		const fixed16_16 y = computeYIntersect(p0, hitPos, ray->scaleXZ);
+		if (y >= sector->floorHeight)
+		{
+			outRayHit->hit = RHit_Floor;
+			outRayHit->sector = sector;
+			return JFALSE;
+		}
+		else if (y <= sector->ceilingHeight)
+		{
+			outRayHit->hit = RHit_Ceiling;
+			outRayHit->sector = sector;
+			return JFALSE;
+		}
+
+		// Check to see if it can pass through the opening.
+		if (y <= bot && y >= top)
+		{
+			if (ray->crossedCount >= COL_MAX_BATCH_CROSSED)
+			{
+				ray->overflow = JTRUE;
+				return JFALSE;
+			}
+			ray->sector = wall->nextSector;
+			ray->crossed[ray->crossedCount++] = wall;
+			return JTRUE;
+		}
+		rayCast_wallHit(outRayHit, sector, wall, hitPos.x, hitPos.z, y);
+		return JFALSE;
+	}
+
+	// Cast 'count' rays that all start in 'sector', writing the results to outHits[].
+	// Rays that are in the same sector are traced together so each portal and wall list is only walked once per group.
+	// Each ray skips the same walls as collision_rayCast3d(), see collision_rayBatchTest().
+	void collision_rayCast3dBatch(RSector* sector, s32 count, const vec3_fixed* p0, const vec3_fixed* p1, bool stopAtMidTex, RayHitInfo* outHits)
+	{
+		RayBatchState state[COL_MAX_BATCH_RAYS];
+		s32 active[COL_MAX_BATCH_RAYS];
+		s32 group[COL_MAX_BATCH_RAYS];
+
+		for (s32 base = 0; base < count; base += COL_MAX_BATCH_RAYS)
+		{
+			const s32 batchCount = min(count - base, COL_MAX_BATCH_RAYS);
+			const vec3_fixed* batchP0 = &p0[base];
+			const vec3_fixed* batchP1 = &p1[base];
+			RayHitInfo* batchOut = &outHits[base];
+
+			s32 activeCount = 0;
+			for (s32 i = 0; i < batchCount; i++)
+			{
+				batchOut[i] = { RHit_None, nullptr, nullptr };
+				state[i].sector = sector;
+				state[i].crossedCount = 0;
+				state[i].hitWall = nullptr;
+				state[i].first = JTRUE;
+				state[i].done = JFALSE;
+				state[i].overflow = JFALSE;
+				state[i].scaleXZ = 0.0f;
+
+				// Rays without horizontal movement never hit walls.
+				if (batchP0[i].x == batchP1[i].x && batchP0[i].z == batchP1[i].z)
+				{
+					rayCastBatch_step(&state[i], batchP0[i], batchP1[i], stopAtMidTex, &batchOut[i]);
+					continue;
+				}
+				active[activeCount++] = i;
+			}
+
+			while (activeCount)
+			{
+				// Gather every active ray in the same sector as the first one.
+				RSector* curSector = state[active[0]].sector;
+				s32 groupCount = 0;
+				for (s32 i = 0; i < activeCount; i++)
+				{
+					if (state[active[i]].sector == curSector)
+					{
+						group[groupCount++] = active[i];
+					}
+				}
+
+				rayCastBatch_sectorWalls(curSector, group, groupCount, state, batchP0, batchP1);
+				for (s32 i = 0; i < groupCount; i++)
+				{
+					const s32 index = group[i];
+					state[index].done = !rayCastBatch_step(&state[index], batchP0[index], batchP1[index], stopAtMidTex, &batchOut[index]);
+					if (state[index].overflow)
+					{
+						batchOut[index] = collision_rayCast3d(sector, batchP0[index], batchP1[index], stopAtMidTex);
+					}
+				}
+
+				// Remove resolved rays, rays that crossed a portal are processed with their new sector group.
+				s32 newCount = 0;
+				for (s32 i = 0; i < activeCount; i++)
+				{
+					if (!state[active[i]].done)
+					{
+						active[newCount++] = active[i];
+					}
+				}
+				activeCount = newCount;
+			}
+		}
+	}
+
+	static s32 rayTest_random(u32* seed, s32 range)
+	{
+		*seed = (*seed) * 1664525u + 1013904223u;
+		return range > 0 ? s32(((*seed) >> 8) % u32(range)) : 0;
+	}
+
+	void collision_rayBatchTest(s32 rayCount)
+	{
+		if (!s_levelState.sectorCount) { return; }
+
+		vec3_fixed p0[COL_MAX_BATCH_RAYS];
+		vec3_fixed p1[COL_MAX_BATCH_RAYS];
+		RayHitInfo batchHits[COL_MAX_BATCH_RAYS];
+
+		// A fixed seed so mismatches can be reproduced.
+		u32 seed = 0x1234567u;
+
+		s32 castCount = 0;
+		s32 mismatchCount = 0;
+		for (s32 attempt = 0; castCount < rayCount && attempt < rayCount * 4; attempt++)
+		{
+			RSector* sector = &s_levelState.sectors[rayTest_random(&seed, s_levelState.sectorCount)];
+			if (sector->wallCount <= 0) { continue; }
+
+			// Generate a group of rays that start inside the sector and travel in random directions.
+			const s32 groupSize = min(rayCount - castCount, COL_MAX_BATCH_RAYS);
+			const fixed16_16 width  = sector->boundsMax.x - sector->boundsMin.x;
+			const fixed16_16 depth  = sector->boundsMax.z - sector->boundsMin.z;
+			const fixed16_16 height = sector->floorHeight - sector->ceilingHeight;
+			s32 count = 0;
+			for (s32 i = 0; i < groupSize * 4 && count < groupSize; i++)
+			{
+				const vec3_fixed start = { sector->boundsMin.x + rayTest_random(&seed, width), sector->ceilingHeight + rayTest_random(&seed, height), sector->boundsMin.z + rayTest_random(&seed, depth) };
+				if (!sector_pointInside(sector, start.x, start.z)) { continue; }
+
+				p0[count] = start;
+				p1[count] = { start.x + rayTest_random(&seed, FIXED(256)) - FIXED(128), start.y + rayTest_random(&seed, FIXED(64)) - FIXED(32), start.z + rayTest_random(&seed, FIXED(256)) - FIXED(128) };
+				count++;
+			}
+			if (!count) { continue; }
+
+			for (s32 m = 0; m < 2; m++)
+			{
+				const bool stopAtMidTex = m != 0;
+				collision_rayCast3dBatch(sector, count, p0, p1, stopAtMidTex, batchHits);
+				for (s32 i = 0; i < count; i++)
+				{
+					const RayHitInfo hit = collision_rayCast3d(sector, p0[i], p1[i], stopAtMidTex);
+					if (hit.hit != batchHits[i].hit || hit.wall != batchHits[i].wall || hit.sector != batchHits[i].sector)
+					{
+						mismatchCount++;
+					}
+				}
+			}
+			castCount += count;
+		}
+		// Each ray is cast with and without stopAtMidTex.
+		TFE_System::logWrite(mismatchCount ? LOG_ERROR : LOG_MSG, "Collision Test", "Cast %d rays twice, %d of %d results differ between collision_rayCast3d() and collision_rayCast3dBatch().",
+			castCount, mismatchCount, castCount * 2);
 	}
 
 	JBool collision_propogateExplosion(RSector* sector)
@@ -20,6 +20,7 @@
 #include <TFE_System/types.h>
 #include <TFE_Jedi/Level/level.h>
 #include <TFE_Jedi/Math/core_math.h>
+#include <TFE_DarkForces/time.h>
 
 struct RSector;
 struct SecObject;
@@ -90,10 +91,34 @@ struct RayHitInfo
 	RSector* sector;
 };
 
+// Added for TFE: coarse grid of wall indices used to accelerate path vs. wall tests in sectors with many walls.
+// Each cell lists the walls whose bounds overlap it, stored as offsets into a shared array (cellStart[width*height + 1]).
+// Walls that move are not re-binned, their cells are stale so they are tested in every query until they stop moving.
+struct SectorWallGrid
+{
+	vec2_fixed boundsMin;
+	vec2_fixed cellSize;
+	s32 width;
+	s32 height;
+	s32* cellStart;
+	s32* cellWalls;
+	u32* wallMask;		// scratch bit mask used to gather walls in order during queries.
+	u32* movedMask;		// walls that moved since the grid was built.
+	s32  maskWords;
+	s32  movedCount;
+	Tick moveTick;		// tick of the last wall move, the grid is rebuilt once the walls have settled.
+	u32  allocSize;
+};
+
 typedef void(*CollisionEffectFunc)(SecObject*);
 
 #define COL_INFINITY FIXED(9999)
 #define COL_SEC_HEIGHT_OFFSET FIXED(2)
+#define COL_MAX_BATCH_RAYS 64
+#define COL_MAX_BATCH_CROSSED 32
+#define COL_WALL_GRID_MIN_WALLS 48
+#define COL_WALL_GRID_MAX_DIM 32
+#define COL_WALL_GRID_SETTLE_TICKS TICKS_PER_SECOND
 
 namespace TFE_Jedi
 {
@@ -102,6 +127,9 @@ namespace TFE_Jedi
 	RSector* collision_tryMove(RSector* sector, fixed16_16 x0, fixed16_16 z0, fixed16_16 x1, fixed16_16 z1);
 	RSector* collision_moveObj(SecObject* obj, fixed16_16 dx, fixed16_16 dz);
 	RWall* collision_pathWallCollision(RSector* sector);
+	SectorWallGrid* collision_getWallGrid(RSector* sector);
+	// Called when 'wall->w0' moves, which also changes the previous wall in the sector.
+	void collision_wallGridMoveVertex(RWall* wall);
 	RWall* collision_wallCollisionFromPath(RSector* sector, fixed16_16 srcX, fixed16_16 srcZ, fixed16_16 dstX, fixed16_16 dstZ);
 	JBool collision_canHitObject(RSector* startSector, RSector* endSector, vec3_fixed p0, vec3_fixed p1, u32 exclWallFlags3);
 
@@ -116,6 +144,11 @@ namespace TFE_Jedi
 
 	JBool inf_handleExplosion(RSector* sector, fixed16_16 x, fixed16_16 z, fixed16_16 range);
 	RayHitInfo collision_rayCast3d(RSector* sector, vec3_fixed p0, vec3_fixed p1, bool stopAtMidTex);
+	// Cast 'count' rays starting in 'sector', sharing the portal traversal between rays in the same sector.
+	void collision_rayCast3dBatch(RSector* sector, s32 count, const vec3_fixed* p0, const vec3_fixed* p1, bool stopAtMidTex, RayHitInfo* outHits);
+	// Test, not called by the engine: cast random rays through the loaded level with both collision_rayCast3d() and
+	// collision_rayCast3dBatch() and log the number of different results. See level_load() to run it.
+	void collision_rayBatchTest(s32 rayCount = 10000);
 
 	// Variables
 	extern fixed16_16 s_colObjOverlap;
@@ -57,7 +57,7 @@ namespace TFE_Jedi
 	SoundSourceId s_switchDefaultSndId = NULL_SOUND;
 
 	// Temporary state that does not need to be cleared or serialized.
-	static std::vector<char> s_buffer;
+	static std::vector<u8> s_fileData;
 	static char s_infArg0[256];
 	static char s_infArg1[256];
 	static char s_infArg2[256];
@@ -1232,20 +1232,17 @@ namespace TFE_Jedi
 			TFE_System::logWrite(LOG_ERROR, "level_loadINF", "Cannot find level INF '%s'.", levelPath);
 			return JFALSE;
 		}
-		FileStream file;
-		if (!file.open(&filePath, Stream::MODE_READ))
+		size_t len = 0;
+		const char* data = (const char*)FileStream::readContentsView(&filePath, s_fileData, &len);
+		if (!data)
 		{
 			TFE_System::logWrite(LOG_ERROR, "level_loadINF", "Cannot open level INF '%s'.", levelPath);
 			return JFALSE;
 		}
-		size_t len = file.getSize();
-		s_buffer.resize(len);
-		file.readBuffer(s_buffer.data(), u32(len));
-		file.close();
 
 		TFE_Parser parser;
 		size_t bufferPos = 0;
-		parser.init(s_buffer.data(), s_buffer.size());
+		parser.init(data, len);
 		parser.enableBlockComments();
 		parser.addCommentString("//");
 		parser.convertToUpperCase(true);
@@ -1,7 +1,9 @@
 #include <cstring>
+#include <cctype>
 
 #include "message.h"
 #include <TFE_Jedi/Memory/allocator.h>
+#include <TFE_Game/igame.h>
 #include <TFE_System/system.h>
 #include <TFE_System/memoryPool.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
@@ -16,7 +18,18 @@
 
 namespace TFE_Jedi
 {
+	enum
+	{
+		MSG_ADDR_NAME_LEN = 16,
+		MSG_ADDR_HASH_MIN_CAPACITY = 256,
+	};
+
 	Allocator* s_messageAddr = nullptr;
+	// Added for TFE: case-insensitive open addressing hash index over s_messageAddr,
+	// so name lookups during INF load and at runtime do not need to walk the whole list.
+	static MessageAddress** s_messageAddrHash = nullptr;
+	static u32 s_messageAddrHashCapacity = 0;
+	static u32 s_messageAddrHashCount = 0;
 	void* s_msgEntity;
 	void* s_msgTarget;
 	u32 s_msgArg1;
@@ -25,7 +38,54 @@ namespace TFE_Jedi
 
 	void message_free()
 	{
+		// Both the allocator and hash index live in the level region, which is freed with the level.
 		s_messageAddr = nullptr;
+		s_messageAddrHash = nullptr;
+		s_messageAddrHashCapacity = 0;
+		s_messageAddrHashCount = 0;
+	}
+
+	// FNV-1a over the upper case name, limited to the stored name length to match strncasecmp(name, addr, 16).
+	static u32 message_hashName(const char* name)
+	{
+		u32 hash = 2166136261u;
+		for (s32 i = 0; i < MSG_ADDR_NAME_LEN && name[i]; i++)
+		{
+			hash ^= u32(toupper(name[i]));
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	static MessageAddress** message_findSlot(MessageAddress** table, u32 capacity, const char* name)
+	{
+		const u32 mask = capacity - 1;
+		u32 slot = message_hashName(name) & mask;
+		while (table[slot] && strncasecmp(name, table[slot]->name, MSG_ADDR_NAME_LEN) != 0)
+		{
+			slot = (slot + 1) & mask;
+		}
+		return &table[slot];
+	}
+
+	static void message_growHash()
+	{
+		const u32 newCapacity = s_messageAddrHashCapacity ? s_messageAddrHashCapacity * 2 : MSG_ADDR_HASH_MIN_CAPACITY;
+		MessageAddress** newTable = (MessageAddress**)level_alloc(sizeof(MessageAddress*) * newCapacity);
+		memset(newTable, 0, sizeof(MessageAddress*) * newCapacity);
+		for (u32 i = 0; i < s_messageAddrHashCapacity; i++)
+		{
+			if (s_messageAddrHash[i])
+			{
+				*message_findSlot(newTable, newCapacity, s_messageAddrHash[i]->name) = s_messageAddrHash[i];
+			}
+		}
+		if (s_messageAddrHash)
+		{
+			level_free(s_messageAddrHash);
+		}
+		s_messageAddrHash = newTable;
+		s_messageAddrHashCapacity = newCapacity;
 	}
 
 	void message_addAddress(const char* name, s32 param0, s32 param1, RSector* sector)
@@ -44,18 +104,30 @@ namespace TFE_Jedi
 		msgAddr->param0 = param0;
 		msgAddr->param1 = param1;
 		msgAddr->sector = sector;
+
+		// Keep the load factor at or below 1/2.
+		if ((s_messageAddrHashCount + 1) * 2 > s_messageAddrHashCapacity)
+		{
+			message_growHash();
+		}
+		// Duplicate names keep the first address, matching the original list order lookup.
+		MessageAddress** slot = message_findSlot(s_messageAddrHash, s_messageAddrHashCapacity, msgAddr->name);
+		if (!*slot)
+		{
+			*slot = msgAddr;
+			s_messageAddrHashCount++;
+		}
 	}
 
 	MessageAddress* message_getAddress(const char* name)
 	{
-		MessageAddress* msgAddr = (MessageAddress*)allocator_getHead(s_messageAddr);
-		while (msgAddr)
+		if (s_messageAddrHash)
 		{
-			if (strncasecmp(name, msgAddr->name, 16) == 0)
+			MessageAddress* msgAddr = *message_findSlot(s_messageAddrHash, s_messageAddrHashCapacity, name);
+			if (msgAddr)
 			{
 				return msgAddr;
 			}
-			msgAddr = (MessageAddress*)allocator_getNext(s_messageAddr);
 		}
 
 		TFE_System::logWrite(LOG_ERROR, "INF", "Message_GetAddress: ADDRESS NOT FOUND: %s", name);
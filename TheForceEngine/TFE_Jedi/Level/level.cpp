@@ -3,7 +3,9 @@
 
 #include "level.h"
 #include "levelBin.h"
+#include "levelCache.h"
 #include "levelData.h"
+#include "levelPrefetch.h"
 #include "rwall.h"
 #include "rtexture.h"
 #include <TFE_Game/igame.h>
@@ -13,12 +15,15 @@
 #include <TFE_Asset/spriteAsset_Jedi.h>
 #include <TFE_Asset/vocAsset.h>
 #include <TFE_DarkForces/sound.h>
+#include <TFE_FileSystem/binaryCache.h>
+#include <TFE_FileSystem/filePrefetch.h>
 #include <TFE_FileSystem/filestream.h>
 #include <TFE_FileSystem/paths.h>
 #include <TFE_System/parser.h>
 #include <TFE_System/system.h>
 #include <TFE_Settings/settings.h>
 
+#include <TFE_Jedi/Collision/collision.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
 #include <TFE_Jedi/InfSystem/infTypesInternal.h>
 #include <TFE_Jedi/InfSystem/message.h>
@@ -46,6 +51,22 @@ namespace TFE_Jedi
 	static s32 s_dataIndex;
 	static char s_readBuffer[256];
 	static std::vector<char> s_buffer;
+	static std::vector<u8> s_fileData;
+	static std::vector<u8> s_cacheData;
+	// Cold vs. cached load timing, reported by level_load().
+	static JBool s_geometryCached = JFALSE;
+	static f64 s_geometryParseMs = 0.0;
+
+	// Storage for the geometry description when parsing the LEV file, see levelCache.h
+	struct LevelGeometryParse
+	{
+		std::vector<s32> textures;
+		std::vector<LevelSectorDesc> sectors;
+		std::vector<LevelWallDesc> walls;
+		std::vector<vec2_fixed> vertices;
+		std::vector<char> strings;
+	};
+	static LevelGeometryParse s_geoParse;
 
 	JBool level_loadGeometry(const char* levelName);
 	JBool level_loadObjects(const char* levelName, u8 difficulty);
@@ -67,12 +88,28 @@ namespace TFE_Jedi
 
 		// Settings helper
 		TFE_Settings::setLevelName(levelName);
+		// Files already read ahead of time are used by the loaders below, but no new files are queued.
+		level_prefetchStop();
 
+		const u64 startTime = TFE_System::getCurrentTimeInTicks();
 		if (!level_loadGeometry(levelName)) { return JFALSE; }
+		const u64 geoTime = TFE_System::getCurrentTimeInTicks();
 		level_loadObjects(levelName, difficulty);
+		const u64 objTime = TFE_System::getCurrentTimeInTicks();
 		inf_load(levelName);
+		const u64 infTime = TFE_System::getCurrentTimeInTicks();
 		level_loadGoals(levelName);
+		// Textures, sprites and models are loaded with the level, anything left over is unused.
+		TFE_FilePrefetch::prefetch_clear();
+
+		TFE_System::logWrite(LOG_MSG, "Level", "Loaded '%s' - geometry: %.2fms (%s: %.2fms), objects: %.2fms, INF: %.2fms.", levelName,
+			1000.0 * TFE_System::convertFromTicksToSeconds(geoTime - startTime),
+			s_geometryCached ? "cache read" : "text parse", s_geometryParseMs,
+			1000.0 * TFE_System::convertFromTicksToSeconds(objTime - geoTime),
+			1000.0 * TFE_System::convertFromTicksToSeconds(infTime - objTime));
 
+		// Uncomment to compare batched and single ray casts in each level as it is loaded.
+		// collision_rayBatchTest();
 		return JTRUE;
 	}
 
@@ -142,45 +179,68 @@ namespace TFE_Jedi
 		s_levelState.controlSector->index = s_levelState.controlSector->id;
 	}
 
-	JBool level_loadGeometry(const char* levelName)
+	s32 level_addString(std::vector<char>& strings, const char* str)
 	{
-		s_levelState.secretCount = 0;
-		s_dataIndex = 0;
-		s_levelState.minLayer = INT_MAX;
-		s_levelState.maxLayer = INT_MIN;
-		message_free();
-
-		// Try loading as an LVB
-		if (level_loadGeometryBin(levelName, s_buffer))
-		{
-			return JTRUE;
-		}
-
-		// Otherwise load the LEV
-		char levelPath[TFE_MAX_PATH];
-		strcpy(levelPath, levelName);
-		strcat(levelPath, ".LEV");
+		const s32 offset = s32(strings.size());
+		strings.insert(strings.end(), str, str + strlen(str) + 1);
+		return offset;
+	}
 
-		FilePath filePath;
-		if (!TFE_Paths::getFilePath(levelPath, &filePath))
+	// Reads "<key> %d %f %f" followed by "%d" if 'hasUnused' is set, the offset is scaled to texels.
+	bool level_parseWallTexture(const char*& line, const char* key, s32* texture, vec2_fixed* offset, bool hasUnused)
+	{
+		f32 offsetX, offsetZ;
+		s32 unused;
+		if (!TFE_Parser::matchLiteral(line, key) || !TFE_Parser::parseInt(line, texture) ||
+			!TFE_Parser::parseFloat(line, &offsetX) || !TFE_Parser::parseFloat(line, &offsetZ) ||
+			(hasUnused && !TFE_Parser::parseInt(line, &unused)))
 		{
-			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot find level geometry '%s'.", levelName);
 			return false;
 		}
-		FileStream file;
-		if (!file.open(&filePath, Stream::MODE_READ))
+		*offset = { floatToFixed16(offsetX) * 8, floatToFixed16(offsetZ) * 8 };
+		return true;
+	}
+
+	// Reads " WALL LEFT: %d RIGHT: %d MID: %d %f %f %d TOP: %d %f %f %d BOT: %d %f %f %d SIGN: %d %f %f ADJOIN: %d MIRROR: %d
+	// WALK: %d FLAGS: %d %d %d LIGHT: %d" without sscanf(), since walls make up most of the LEV file.
+	bool level_parseWall(const char* line, LevelWallDesc* wall)
+	{
+		s32 walk;
+		s32 flags[3];
+		if (!TFE_Parser::matchLiteral(line, " WALL LEFT:") || !TFE_Parser::parseInt(line, &wall->left) ||
+			!TFE_Parser::matchLiteral(line, " RIGHT:") || !TFE_Parser::parseInt(line, &wall->right) ||
+			!level_parseWallTexture(line, " MID:", &wall->midTex, &wall->midOffset, true) ||
+			!level_parseWallTexture(line, " TOP:", &wall->topTex, &wall->topOffset, true) ||
+			!level_parseWallTexture(line, " BOT:", &wall->botTex, &wall->botOffset, true) ||
+			!level_parseWallTexture(line, " SIGN:", &wall->signTex, &wall->signOffset, false) ||
+			!TFE_Parser::matchLiteral(line, " ADJOIN:") || !TFE_Parser::parseInt(line, &wall->adjoin) ||
+			!TFE_Parser::matchLiteral(line, " MIRROR:") || !TFE_Parser::parseInt(line, &wall->mirror) ||
+			!TFE_Parser::matchLiteral(line, " WALK:") || !TFE_Parser::parseInt(line, &walk) ||
+			!TFE_Parser::matchLiteral(line, " FLAGS:") || !TFE_Parser::parseInt(line, &flags[0]) ||
+			!TFE_Parser::parseInt(line, &flags[1]) || !TFE_Parser::parseInt(line, &flags[2]) ||
+			!TFE_Parser::matchLiteral(line, " LIGHT:") || !TFE_Parser::parseInt(line, &wall->light))
 		{
-			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot open level geometry '%s'.", levelName);
 			return false;
 		}
-		size_t len = file.getSize();
-		s_buffer.resize(len);
-		file.readBuffer(s_buffer.data(), u32(len));
-		file.close();
+		wall->flags1 = u32(flags[0]);
+		wall->flags2 = u32(flags[1]);
+		wall->flags3 = u32(flags[2]);
+		return true;
+	}
+
+	// Parse the LEV text into a geometry description, the level state is not modified.
+	JBool level_parseGeometry(const char* data, size_t len, LevelGeometryDesc* desc)
+	{
+		LevelGeometryParse& geo = s_geoParse;
+		geo.textures.clear();
+		geo.sectors.clear();
+		geo.walls.clear();
+		geo.vertices.clear();
+		geo.strings.clear();
 
 		TFE_Parser parser;
 		size_t bufferPos = 0;
-		parser.init(s_buffer.data(), s_buffer.size());
+		parser.init(data, len);
 		parser.addCommentString("#");
 		parser.convertToUpperCase(true);
 
@@ -208,13 +268,12 @@ namespace TFE_Jedi
 
 		// This gets read here just to be overwritten later... so just ignore for now.
 		line = parser.readLine(bufferPos);
-		if (sscanf(line, " PALETTE %s", s_levelState.levelPaletteName) != 1)
+		if (sscanf(line, " PALETTE %s", s_readBuffer) != 1)
 		{
 			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read palette name.");
 			return false;
 		}
-
-		level_loadPalette();
+		desc->paletteName = level_addString(geo.strings, s_readBuffer);
 		
 		// Another value that is ignored.
 		line = parser.readLine(bufferPos);
@@ -234,79 +293,51 @@ namespace TFE_Jedi
 			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read parallax values.");
 			return false;
 		}
-		s_levelState.parallax0 = floatToFixed16(parallax0);
-		s_levelState.parallax1 = floatToFixed16(parallax1);
+		desc->parallax0 = floatToFixed16(parallax0);
+		desc->parallax1 = floatToFixed16(parallax1);
 
 		// Number of textures used by the level.
+		s32 textureCount;
 		line = parser.readLine(bufferPos);
-		if (sscanf(line, " TEXTURES %d", &s_levelState.textureCount) != 1)
+		if (sscanf(line, " TEXTURES %d", &textureCount) != 1)
 		{
 			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read texture count.");
 			return false;
 		}
-		s_levelState.textures = (TextureData**)level_alloc(2 * s_levelState.textureCount * sizeof(TextureData**));
-		memset(s_levelState.textures, 0, 2 * s_levelState.textureCount * sizeof(TextureData**));
 
-		// Load Textures.
-		TextureData** texture = s_levelState.textures;
-		TextureData** texBase = s_levelState.textures + s_levelState.textureCount;
-		for (s32 i = 0; i < s_levelState.textureCount; i++, texture++, texBase++)
+		// Texture names.
+		for (s32 i = 0; i < textureCount; i++)
 		{
 			line = parser.readLine(bufferPos);
 			char textureName[256];
 			if (sscanf(line, " TEXTURE: %s ", textureName) != 1)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read texture name.");
-				*texture = bitmap_load("default.bm", 1);
-				(*texture)->flags |= ENABLE_MIP_MAPS;
+				geo.textures.push_back(LEVEL_TEX_INVALID);
 			}
 			else if (strcasecmp(textureName, "<NoTexture>") == 0)
 			{
-				*texture = nullptr;
+				geo.textures.push_back(LEVEL_TEX_NONE);
 			}
 			else
 			{
-				TextureData* tex = bitmap_load(textureName, 1);
-				if (!tex)
-				{
-					TFE_System::logWrite(LOG_WARNING, "level_loadGeometry", "Could not open '%s', using 'default.bm' instead.", textureName);
-					tex = bitmap_load("default.bm", 1);
-					if (!tex)
-					{
-						TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "'default.bm' is not a valid BM file!");
-						assert(0);
-						return false;
-					}
-				}
-				// TFE - so we know which textures to mip.
-				tex->flags |= ENABLE_MIP_MAPS;
-				*texture = tex;
-				// This version never gets modified, so serialization is simpler.
-				*texBase = tex;
-
-				// Setup an animated texture.
-				if (tex->uvWidth == BM_ANIMATED_TEXTURE && !tex->animSetup)
-				{
-					bitmap_setupAnimatedTexture(texture, i);
-				}
+				geo.textures.push_back(level_addString(geo.strings, textureName));
 			}
 		}
 
-		// Load Sectors.
+		// Sectors.
+		u32 sectorCount;
 		line = parser.readLine(bufferPos);
-		if (sscanf(line, "NUMSECTORS %d", &s_levelState.sectorCount) != 1)
+		if (sscanf(line, "NUMSECTORS %d", &sectorCount) != 1)
 		{
 			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector count.");
 			return false;
 		}
 
-		s_levelState.sectors = (RSector*)level_alloc(sizeof(RSector) * s_levelState.sectorCount);
-		memset(s_levelState.sectors, 0, sizeof(RSector) * s_levelState.sectorCount);
-		for (u32 i = 0; i < s_levelState.sectorCount; i++)
+		geo.sectors.resize(sectorCount);
+		for (u32 i = 0; i < sectorCount; i++)
 		{
-			RSector* sector = &s_levelState.sectors[i];
-			sector_clear(sector);
-			sector->index = i;
+			LevelSectorDesc* sector = &geo.sectors[i];
 
 			// Sector ID and Name
 			line = parser.readLine(bufferPos);
@@ -318,54 +349,30 @@ namespace TFE_Jedi
 
 			// Allow names to have '#' in them.
 			line = parser.readLine(bufferPos, false, true);
-			// Sectors missing a name are valid but do not get "addresses" - and thus cannot be
-			// used by the INF system (except in the case of doors and exploding walls, see the flags section below).
 			char name[256];
+			sector->name = LEVEL_NO_NAME;
 			if (sscanf(line, " NAME %s", name) == 1)
 			{
-				// Add the sector "address" for later use by the INF system.
-				message_addAddress(name, 0, 0, sector);
-
-				// Track special elevators.
-				if (!strcasecmp(name, "complete"))
-				{
-					s_levelState.completeSector = sector;
-				}
-				else if (!strcasecmp(name, "boss"))
-				{
-					s_levelState.bossSector = sector;
-				}
-				else if (!strcasecmp(name, "mohc"))
-				{
-					s_levelState.mohcSector = sector;
-				}
+				sector->name = level_addString(geo.strings, name);
 			}
 
 			// Lighting
 			line = parser.readLine(bufferPos);
-			s32 ambient;
-			if (sscanf(line, " AMBIENT %d", &ambient) != 1)
+			if (sscanf(line, " AMBIENT %d", &sector->ambient) != 1)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector ambient.");
 				return false;
 			}
-			sector->ambient = intToFixed16(ambient);
 
 			// Floor Texture & Offset
 			line = parser.readLine(bufferPos);
-			s32 index, tmp;
+			s32 tmp;
 			f32 offsetX, offsetZ;
-			if (sscanf(line, " FLOOR TEXTURE %d %f %f %d", &index, &offsetX, &offsetZ, &tmp) != 4)
+			if (sscanf(line, " FLOOR TEXTURE %d %f %f %d", &sector->floorTex, &offsetX, &offsetZ, &tmp) != 4)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read floor texture.");
 				return false;
 			}
-
-			sector->floorTex = nullptr;
-			if (index != -1)
-			{
-				sector->floorTex = &s_levelState.textures[index];
-			}
 			sector->floorOffset.x = floatToFixed16(offsetX);
 			sector->floorOffset.z = floatToFixed16(offsetZ);
 
@@ -381,16 +388,11 @@ namespace TFE_Jedi
 
 			// Ceiling Texture & Offset
 			line = parser.readLine(bufferPos);
-			if (sscanf(line, " CEILING TEXTURE %d %f %f %d", &index, &offsetX, &offsetZ, &tmp) != 4)
+			if (sscanf(line, " CEILING TEXTURE %d %f %f %d", &sector->ceilTex, &offsetX, &offsetZ, &tmp) != 4)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read ceiling texture.");
 				return false;
 			}
-			sector->ceilTex = nullptr;
-			if (index != -1)
-			{
-				sector->ceilTex = &s_levelState.textures[index];
-			}
 			sector->ceilOffset.x = floatToFixed16(offsetX);
 			sector->ceilOffset.z = floatToFixed16(offsetZ);
 
@@ -401,7 +403,7 @@ namespace TFE_Jedi
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read ceiling altitude.");
 				return false;
 			}
-			sector->ceilingHeight = floatToFixed16(alt);
+			sector->ceilHeight = floatToFixed16(alt);
 
 			// Second Altitude
 			line = parser.readLine(bufferPos);
@@ -419,22 +421,6 @@ namespace TFE_Jedi
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector flags.");
 				return false;
 			}
-			// Create a door if needed.
-			if (sector->flags1 & SEC_FLAGS1_DOOR)
-			{
-				InfElevator* elev = inf_allocateSpecialElevator(sector, IELEV_SP_DOOR);
-				if (elev) { elev->flags |= INF_EFLAG_DOOR; }
-			}
-			// Create an exploding wall if needed.
-			if (sector->flags1 & SEC_FLAGS1_EXP_WALL)
-			{
-				inf_allocateSpecialElevator(sector, IELEV_SP_EXPLOSIVE_WALL);
-			}
-			// Add secrets.
-			if (sector->flags1 & SEC_FLAGS1_SECRET)
-			{
-				s_levelState.secretCount++;
-			}
 
 			// Layer
 			line = parser.readLine(bufferPos);
@@ -443,129 +429,281 @@ namespace TFE_Jedi
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector layer.");
 				return false;
 			}
-			s_levelState.minLayer = min(s_levelState.minLayer, sector->layer);
-			s_levelState.maxLayer = max(s_levelState.maxLayer, sector->layer);
 
 			// Vertices
 			line = parser.readLine(bufferPos);
-			s32 vertexCount;
-			if (sscanf(line, " VERTICES %d", &vertexCount) != 1)
+			if (sscanf(line, " VERTICES %d", &sector->vertexCount) != 1)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector vertices.");
 				return false;
 			}
-			const size_t vtxSize = vertexCount * sizeof(vec2_fixed);
-			sector->verticesWS = (vec2_fixed*)level_alloc(vtxSize);
-			sector->verticesVS = (vec2_fixed*)level_alloc(vtxSize);
-			sector->vertexCount = vertexCount;
-
-			for (s32 v = 0; v < vertexCount; v++)
+			sector->vertexStart = u32(geo.vertices.size());
+			for (s32 v = 0; v < sector->vertexCount; v++)
 			{
 				line = parser.readLine(bufferPos);
 
-				f32 x, z;
-				sscanf(line, " X: %f Z: %f ", &x, &z);
-				sector->verticesWS[v].x = floatToFixed16(x);
-				sector->verticesWS[v].z = floatToFixed16(z);
+				// Like the original sscanf(), values that cannot be read are left at zero.
+				f32 x = 0.0f, z = 0.0f;
+				if (TFE_Parser::matchLiteral(line, " X:") && TFE_Parser::parseFloat(line, &x) && TFE_Parser::matchLiteral(line, " Z:"))
+				{
+					TFE_Parser::parseFloat(line, &z);
+				}
+				geo.vertices.push_back({ floatToFixed16(x), floatToFixed16(z) });
 			}
 
 			// Walls
 			line = parser.readLine(bufferPos);
-			s32 wallCount;
-			if (sscanf(line, " WALLS %d", &wallCount) != 1)
+			if (sscanf(line, " WALLS %d", &sector->wallCount) != 1)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector walls.");
 				return false;
 			}
-			sector->walls = (RWall*)level_alloc(wallCount * sizeof(RWall));
-			sector->wallCount = wallCount;
-
-			for (s32 w = 0; w < wallCount; w++)
+			sector->wallStart = u32(geo.walls.size());
+			for (s32 w = 0; w < sector->wallCount; w++)
 			{
-				s32 light, flags3, flags2, flags1, walk, mirror, adjoin;
-				s32 signTex, unused;
-				s32 botTex, topTex, midTex, right, left;
-				f32 signOffsetZ, signOffsetX;
-				f32 botOffsetZ, botOffsetX;
-				f32 topOffsetZ, topOffsetX;
-				f32 midOffsetZ, midOffsetX;
-
+				LevelWallDesc wall = {};
 				line = parser.readLine(bufferPos);
-				if (sscanf(line, " WALL LEFT: %d RIGHT: %d MID: %d %f %f %d TOP: %d %f %f %d BOT: %d %f %f %d SIGN: %d %f %f ADJOIN: %d MIRROR: %d WALK: %d FLAGS: %d %d %d LIGHT: %d",
-					&left, &right, &midTex, &midOffsetX, &midOffsetZ, &unused, &topTex, &topOffsetX, &topOffsetZ, &unused, &botTex, &botOffsetX, &botOffsetZ, &unused,
-					&signTex, &signOffsetX, &signOffsetZ, &adjoin, &mirror, &walk, &flags1, &flags2, &flags3, &light) != 24)
+				if (!level_parseWall(line, &wall))
 				{
 					TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read wall.");
 					return false;
 				}
+				geo.walls.push_back(wall);
+			}
+		}
+		// Keep the string pool valid even if nothing was added.
+		geo.strings.push_back(0);
+
+		desc->textureCount = textureCount;
+		desc->textures     = geo.textures.data();
+		desc->sectorCount  = sectorCount;
+		desc->sectors      = geo.sectors.data();
+		desc->wallCount    = u32(geo.walls.size());
+		desc->walls        = geo.walls.data();
+		desc->vertexCount  = u32(geo.vertices.size());
+		desc->vertices     = geo.vertices.data();
+		desc->stringSize   = u32(geo.strings.size());
+		desc->strings      = geo.strings.data();
+		return true;
+	}
+
+	// Build the level geometry from a description, which either comes from the LEV file or the level cache.
+	JBool level_buildGeometry(const LevelGeometryDesc* desc)
+	{
+		strcpy(s_levelState.levelPaletteName, &desc->strings[desc->paletteName]);
+		level_loadPalette();
+
+		s_levelState.parallax0 = desc->parallax0;
+		s_levelState.parallax1 = desc->parallax1;
+
+		s_levelState.textureCount = desc->textureCount;
+		s_levelState.textures = (TextureData**)level_alloc(2 * s_levelState.textureCount * sizeof(TextureData**));
+		memset(s_levelState.textures, 0, 2 * s_levelState.textureCount * sizeof(TextureData**));
+
+		// Load Textures.
+		TextureData** texture = s_levelState.textures;
+		TextureData** texBase = s_levelState.textures + s_levelState.textureCount;
+		for (s32 i = 0; i < s_levelState.textureCount; i++, texture++, texBase++)
+		{
+			if (desc->textures[i] == LEVEL_TEX_INVALID)
+			{
+				*texture = bitmap_load("default.bm", 1);
+				(*texture)->flags |= ENABLE_MIP_MAPS;
+			}
+			else if (desc->textures[i] == LEVEL_TEX_NONE)
+			{
+				*texture = nullptr;
+			}
+			else
+			{
+				const char* textureName = &desc->strings[desc->textures[i]];
+				TextureData* tex = bitmap_load(textureName, 1);
+				if (!tex)
+				{
+					TFE_System::logWrite(LOG_WARNING, "level_loadGeometry", "Could not open '%s', using 'default.bm' instead.", textureName);
+					tex = bitmap_load("default.bm", 1);
+					if (!tex)
+					{
+						TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "'default.bm' is not a valid BM file!");
+						assert(0);
+						return false;
+					}
+				}
+				// TFE - so we know which textures to mip.
+				tex->flags |= ENABLE_MIP_MAPS;
+				*texture = tex;
+				// This version never gets modified, so serialization is simpler.
+				*texBase = tex;
+
+				// Setup an animated texture.
+				if (tex->uvWidth == BM_ANIMATED_TEXTURE && !tex->animSetup)
+				{
+					bitmap_setupAnimatedTexture(texture, i);
+				}
+			}
+		}
+
+		// Load Sectors.
+		s_levelState.sectorCount = desc->sectorCount;
+		s_levelState.sectors = (RSector*)level_alloc(sizeof(RSector) * s_levelState.sectorCount);
+		memset(s_levelState.sectors, 0, sizeof(RSector) * s_levelState.sectorCount);
+		for (u32 i = 0; i < s_levelState.sectorCount; i++)
+		{
+			const LevelSectorDesc* sectorDesc = &desc->sectors[i];
+			RSector* sector = &s_levelState.sectors[i];
+			sector_clear(sector);
+			sector->index = i;
+			sector->id = sectorDesc->id;
+
+			// Sectors missing a name are valid but do not get "addresses" - and thus cannot be
+			// used by the INF system (except in the case of doors and exploding walls, see the flags section below).
+			if (sectorDesc->name != LEVEL_NO_NAME)
+			{
+				const char* name = &desc->strings[sectorDesc->name];
+				// Add the sector "address" for later use by the INF system.
+				message_addAddress(name, 0, 0, sector);
+
+				// Track special elevators.
+				if (!strcasecmp(name, "complete"))
+				{
+					s_levelState.completeSector = sector;
+				}
+				else if (!strcasecmp(name, "boss"))
+				{
+					s_levelState.bossSector = sector;
+				}
+				else if (!strcasecmp(name, "mohc"))
+				{
+					s_levelState.mohcSector = sector;
+				}
+			}
+
+			// Lighting
+			sector->ambient = intToFixed16(sectorDesc->ambient);
+
+			// Floor and ceiling.
+			sector->floorTex = nullptr;
+			if (sectorDesc->floorTex != -1)
+			{
+				sector->floorTex = &s_levelState.textures[sectorDesc->floorTex];
+			}
+			sector->floorOffset = sectorDesc->floorOffset;
+			sector->floorHeight = sectorDesc->floorHeight;
+
+			sector->ceilTex = nullptr;
+			if (sectorDesc->ceilTex != -1)
+			{
+				sector->ceilTex = &s_levelState.textures[sectorDesc->ceilTex];
+			}
+			sector->ceilOffset = sectorDesc->ceilOffset;
+			sector->ceilingHeight = sectorDesc->ceilHeight;
+			sector->secHeight = sectorDesc->secHeight;
+
+			// Sector flags
+			sector->flags1 = sectorDesc->flags1;
+			sector->flags2 = sectorDesc->flags2;
+			sector->flags3 = sectorDesc->flags3;
+			// Create a door if needed.
+			if (sector->flags1 & SEC_FLAGS1_DOOR)
+			{
+				InfElevator* elev = inf_allocateSpecialElevator(sector, IELEV_SP_DOOR);
+				if (elev) { elev->flags |= INF_EFLAG_DOOR; }
+			}
+			// Create an exploding wall if needed.
+			if (sector->flags1 & SEC_FLAGS1_EXP_WALL)
+			{
+				inf_allocateSpecialElevator(sector, IELEV_SP_EXPLOSIVE_WALL);
+			}
+			// Add secrets.
+			if (sector->flags1 & SEC_FLAGS1_SECRET)
+			{
+				s_levelState.secretCount++;
+			}
 
+			// Layer
+			sector->layer = sectorDesc->layer;
+			s_levelState.minLayer = min(s_levelState.minLayer, sector->layer);
+			s_levelState.maxLayer = max(s_levelState.maxLayer, sector->layer);
+
+			// Vertices
+			const s32 vertexCount = sectorDesc->vertexCount;
+			const size_t vtxSize = vertexCount * sizeof(vec2_fixed);
+			sector->verticesWS = (vec2_fixed*)level_alloc(vtxSize);
+			sector->verticesVS = (vec2_fixed*)level_alloc(vtxSize);
+			sector->vertexCount = vertexCount;
+			memcpy(sector->verticesWS, &desc->vertices[sectorDesc->vertexStart], vtxSize);
+
+			// Walls
+			const s32 wallCount = sectorDesc->wallCount;
+			sector->walls = (RWall*)level_alloc(wallCount * sizeof(RWall));
+			sector->wallCount = wallCount;
+
+			const LevelWallDesc* wallDesc = &desc->walls[sectorDesc->wallStart];
+			for (s32 w = 0; w < wallCount; w++, wallDesc++)
+			{
 				RWall* wall = &sector->walls[w];
 				wall->id = w;
 				wall->sector = sector;
 				wall->mirrorWall = nullptr;
 				wall->seen = JFALSE;
-				wall->flags1 = flags1;
-				wall->flags2 = flags2;
-				wall->flags3 = flags3;
+				wall->flags1 = wallDesc->flags1;
+				wall->flags2 = wallDesc->flags2;
+				wall->flags3 = wallDesc->flags3;
 
-				vec2_fixed* leftVtxWS = &sector->verticesWS[left];
-				vec2_fixed* rightVtxWS = &sector->verticesWS[right];
+				vec2_fixed* leftVtxWS = &sector->verticesWS[wallDesc->left];
+				vec2_fixed* rightVtxWS = &sector->verticesWS[wallDesc->right];
 				wall->w0 = leftVtxWS;
 				wall->w1 = rightVtxWS;
-				wall->v0 = &sector->verticesVS[left];
-				wall->v1 = &sector->verticesVS[right];
+				wall->v0 = &sector->verticesVS[wallDesc->left];
+				wall->v1 = &sector->verticesVS[wallDesc->right];
 				// Store the original position 0 in the wall since it is used by the sector rotation INF.
 				wall->worldPos0.x = leftVtxWS->x;
 				wall->worldPos0.z = leftVtxWS->z;
 
 				wall->nextSector = nullptr;
 				wall->mirror = -1;
-				if (adjoin != -1)
+				if (wallDesc->adjoin != -1)
 				{
-					wall->nextSector = &s_levelState.sectors[adjoin];
-					if (mirror == -1)
+					wall->nextSector = &s_levelState.sectors[wallDesc->adjoin];
+					if (wallDesc->mirror == -1)
 					{
 						TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Adjoining wall missing mirror.");
 					}
-					wall->mirror = mirror;
+					wall->mirror = wallDesc->mirror;
 				}
 
 				wall->infLink = nullptr;
 				wall->collisionFrame = 0;
 				wall->drawFrame = 0;
 				wall->drawFlags = 0;
-				wall->wallLight = intToFixed16(light);
+				wall->wallLight = intToFixed16(wallDesc->light);
 
 				wall->midTex = nullptr;
-				if (midTex != -1)
+				if (wallDesc->midTex != -1)
 				{
-					wall->midTex = &s_levelState.textures[midTex];
-					wall->midOffset.x = floatToFixed16(midOffsetX) * 8;
-					wall->midOffset.z = floatToFixed16(midOffsetZ) * 8;
+					wall->midTex = &s_levelState.textures[wallDesc->midTex];
+					wall->midOffset = wallDesc->midOffset;
 				}
 
 				wall->topTex = nullptr;
-				if (topTex != -1)
+				if (wallDesc->topTex != -1)
 				{
-					wall->topTex = &s_levelState.textures[topTex];
-					wall->topOffset.x = floatToFixed16(topOffsetX) * 8;
-					wall->topOffset.z = floatToFixed16(topOffsetZ) * 8;
+					wall->topTex = &s_levelState.textures[wallDesc->topTex];
+					wall->topOffset = wallDesc->topOffset;
 				}
 
 				wall->botTex = nullptr;
-				if (botTex != -1)
+				if (wallDesc->botTex != -1)
 				{
-					wall->botTex = &s_levelState.textures[botTex];
-					wall->botOffset.x = floatToFixed16(botOffsetX) * 8;
-					wall->botOffset.z = floatToFixed16(botOffsetZ) * 8;
+					wall->botTex = &s_levelState.textures[wallDesc->botTex];
+					wall->botOffset = wallDesc->botOffset;
 				}
 
 				wall->signTex = nullptr;
-				if (signTex != -1)
+				if (wallDesc->signTex != -1)
 				{
-					wall->signTex = &s_levelState.textures[signTex];
-					wall->signOffset.x = floatToFixed16(signOffsetX) * 8;
-					wall->signOffset.z = floatToFixed16(signOffsetZ) * 8;
+					wall->signTex = &s_levelState.textures[wallDesc->signTex];
+					wall->signOffset = wallDesc->signOffset;
 				}
 
 				fixed16_16 dx = rightVtxWS->x - leftVtxWS->x;
@@ -578,10 +716,64 @@ namespace TFE_Jedi
 		}
 
 		level_postProcessGeometry();
-
 		return true;
 	}
 
+	JBool level_loadGeometry(const char* levelName)
+	{
+		s_levelState.secretCount = 0;
+		s_dataIndex = 0;
+		s_levelState.minLayer = INT_MAX;
+		s_levelState.maxLayer = INT_MIN;
+		s_geometryCached = JFALSE;
+		s_geometryParseMs = 0.0;
+		message_free();
+
+		// Try loading as an LVB
+		if (level_loadGeometryBin(levelName, s_buffer))
+		{
+			return JTRUE;
+		}
+
+		// Otherwise load the LEV
+		char levelPath[TFE_MAX_PATH];
+		strcpy(levelPath, levelName);
+		strcat(levelPath, ".LEV");
+
+		FilePath filePath;
+		if (!TFE_Paths::getFilePath(levelPath, &filePath))
+		{
+			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot find level geometry '%s'.", levelName);
+			return false;
+		}
+		size_t len = 0;
+		const char* data = (const char*)FileStream::readContentsView(&filePath, s_fileData, &len);
+		if (!data)
+		{
+			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot open level geometry '%s'.", levelName);
+			return false;
+		}
+
+		// Use the cached description if the LEV has not changed since it was written.
+		LevelGeometryDesc desc;
+		const u64 parseStart = TFE_System::getCurrentTimeInTicks();
+		const u64 sourceHash = TFE_BinaryCache::cache_hash((const u8*)data, len);
+		if (level_readGeometryCache(levelName, sourceHash, &desc, s_cacheData))
+		{
+			s_geometryCached = JTRUE;
+		}
+		else if (level_parseGeometry(data, len, &desc))
+		{
+			level_writeGeometryCache(levelName, sourceHash, &desc);
+		}
+		else
+		{
+			return false;
+		}
+		s_geometryParseMs = 1000.0 * TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - parseStart);
+		return level_buildGeometry(&desc);
+	}
+
 	void level_freeAllAssets()
 	{
 		TFE_Sprite_Jedi::freeLevelData();
@@ -612,26 +804,22 @@ namespace TFE_Jedi
 		strcat(levelPath, ".GOL");
 				
 		FilePath filePath;
-		FileStream file;
 		if (!TFE_Paths::getFilePath(levelPath, &filePath))
 		{
 			TFE_System::logWrite(LOG_ERROR, "level_loadGoals", "Cannot find level goals '%s'.", levelName);
 			return JFALSE;
 		}
-		if (!file.open(&filePath, Stream::MODE_READ))
+		size_t len = 0;
+		const char* data = (const char*)FileStream::readContentsView(&filePath, s_fileData, &len);
+		if (!data)
 		{
 			TFE_System::logWrite(LOG_ERROR, "level_loadGoals", "Cannot open level goals '%s'.", levelName);
 			return JFALSE;
 		}
 
-		size_t len = file.getSize();
-		s_buffer.resize(len);
-		file.readBuffer(s_buffer.data(), u32(len));
-		file.close();
-
 		TFE_Parser parser;
 		size_t bufferPos = 0;
-		parser.init(s_buffer.data(), s_buffer.size());
+		parser.init(data, len);
 		parser.enableBlockComments();
 		parser.addCommentString("//");
 		parser.addCommentString("#");
@@ -672,7 +860,6 @@ namespace TFE_Jedi
 
 			line = parser.readLine(bufferPos);
 		}
-		file.close();
 
 		return JTRUE;
 	}
@@ -729,21 +916,17 @@ namespace TFE_Jedi
 			TFE_System::logWrite(LOG_ERROR, "Level Load", "Cannot find level objects '%s'.", levelName);
 			return false;
 		}
-		FileStream file;
-		if (!file.open(&filePath, Stream::MODE_READ))
+		size_t len = 0;
+		const char* data = (const char*)FileStream::readContentsView(&filePath, s_fileData, &len);
+		if (!data)
 		{
 			TFE_System::logWrite(LOG_ERROR, "Level Load", "Cannot open level objects '%s'.", levelName);
 			return false;
 		}
 
-		size_t len = file.getSize();
-		s_buffer.resize(len);
-		file.readBuffer(s_buffer.data(), u32(len));
-		file.close();
-
 		TFE_Parser parser;
 		size_t bufferPos = 0;
-		parser.init(s_buffer.data(), s_buffer.size());
+		parser.init(data, len);
 		parser.enableBlockComments();
 		parser.addCommentString("//");
 		parser.addCommentString("#");
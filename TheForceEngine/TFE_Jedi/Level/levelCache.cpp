@@ -0,0 +1,149 @@
+#include <cstring>
+
+#include "levelCache.h"
+#include <TFE_FileSystem/binaryCache.h>
+#include <TFE_FileSystem/paths.h>
+#include <TFE_System/system.h>
+#include <stdio.h>
+
+using namespace TFE_BinaryCache;
+
+namespace TFE_Jedi
+{
+	enum LevelCacheFileConst : u32
+	{
+		LevelCacheSignature = BINARY_CACHE_SIG('L', 'V', 'C', 'F'),
+		LevelCacheVersion   = 2,
+	};
+
+	enum LevelCacheSection
+	{
+		LCS_INFO = 0,
+		LCS_TEXTURES,
+		LCS_SECTORS,
+		LCS_WALLS,
+		LCS_VERTICES,
+		LCS_STRINGS,
+		LCS_COUNT
+	};
+
+	struct LevelCacheInfo
+	{
+		s32 paletteName;
+		fixed16_16 parallax0;
+		fixed16_16 parallax1;
+	};
+
+	void level_getCachePath(const char* levelName, char* path)
+	{
+		snprintf(path, TFE_MAX_PATH, "%sLevelCache/%s.lvc", TFE_Paths::getPath(PATH_PROGRAM_DATA), levelName);
+	}
+
+	// Texture indices are either LEVEL_TEX_NONE or index the texture list.
+	bool level_textureValid(s32 index, const LevelGeometryDesc* desc)
+	{
+		return index >= LEVEL_TEX_NONE && index < desc->textureCount;
+	}
+
+	bool level_readGeometryCache(const char* levelName, u64 sourceHash, LevelGeometryDesc* desc, std::vector<u8>& buffer)
+	{
+		char path[TFE_MAX_PATH];
+		level_getCachePath(levelName, path);
+
+		CacheSection sections[LCS_COUNT] =
+		{
+			{ nullptr, 0, sizeof(LevelCacheInfo) },
+			{ nullptr, 0, sizeof(s32) },
+			{ nullptr, 0, sizeof(LevelSectorDesc) },
+			{ nullptr, 0, sizeof(LevelWallDesc) },
+			{ nullptr, 0, sizeof(vec2_fixed) },
+			{ nullptr, 0, 1 },
+		};
+		if (!cache_read(path, LevelCacheSignature, LevelCacheVersion, sourceHash, sections, LCS_COUNT, buffer))
+		{
+			return false;
+		}
+		if (sections[LCS_INFO].count != 1 || !sections[LCS_STRINGS].count)
+		{
+			TFE_System::logWrite(LOG_WARNING, "Level Cache", "Ignoring invalid cache '%s'.", path);
+			return false;
+		}
+
+		// Pointer fixups.
+		const LevelCacheInfo* info = (const LevelCacheInfo*)sections[LCS_INFO].data;
+		desc->paletteName  = info->paletteName;
+		desc->parallax0    = info->parallax0;
+		desc->parallax1    = info->parallax1;
+		desc->textureCount = s32(sections[LCS_TEXTURES].count);
+		desc->textures     = (const s32*)sections[LCS_TEXTURES].data;
+		desc->sectorCount  = sections[LCS_SECTORS].count;
+		desc->sectors      = (const LevelSectorDesc*)sections[LCS_SECTORS].data;
+		desc->wallCount    = sections[LCS_WALLS].count;
+		desc->walls        = (const LevelWallDesc*)sections[LCS_WALLS].data;
+		desc->vertexCount  = sections[LCS_VERTICES].count;
+		desc->vertices     = (const vec2_fixed*)sections[LCS_VERTICES].data;
+		desc->stringSize   = sections[LCS_STRINGS].count;
+		desc->strings      = (const char*)sections[LCS_STRINGS].data;
+
+		// Make sure the indices stay in range, so a damaged cache cannot crash the loader.
+		bool valid = desc->strings[desc->stringSize - 1] == 0 && desc->paletteName >= 0 && u32(desc->paletteName) < desc->stringSize;
+		for (s32 i = 0; i < desc->textureCount && valid; i++)
+		{
+			valid = desc->textures[i] < s32(desc->stringSize) && desc->textures[i] >= LEVEL_TEX_INVALID;
+		}
+		for (u32 i = 0; i < desc->sectorCount && valid; i++)
+		{
+			const LevelSectorDesc* sector = &desc->sectors[i];
+			valid = sector->name < s32(desc->stringSize) && sector->name >= LEVEL_NO_NAME &&
+				sector->vertexCount >= 0 && u64(sector->vertexStart) + sector->vertexCount <= desc->vertexCount &&
+				sector->wallCount >= 0 && u64(sector->wallStart) + sector->wallCount <= desc->wallCount &&
+				level_textureValid(sector->floorTex, desc) && level_textureValid(sector->ceilTex, desc);
+		}
+		// Walls are only checked once every sector is known to be valid, since they index the sector ranges.
+		for (u32 i = 0; i < desc->sectorCount && valid; i++)
+		{
+			const LevelSectorDesc* sector = &desc->sectors[i];
+			const LevelWallDesc* wall = &desc->walls[sector->wallStart];
+			for (s32 w = 0; w < sector->wallCount && valid; w++, wall++)
+			{
+				valid = wall->left >= 0 && wall->left < sector->vertexCount &&
+					wall->right >= 0 && wall->right < sector->vertexCount &&
+					level_textureValid(wall->midTex, desc) && level_textureValid(wall->topTex, desc) &&
+					level_textureValid(wall->botTex, desc) && level_textureValid(wall->signTex, desc) &&
+					wall->adjoin >= -1 && wall->adjoin < s32(desc->sectorCount);
+				// The mirror is a wall in the adjoining sector.
+				if (valid && wall->adjoin >= 0)
+				{
+					valid = wall->mirror >= -1 && wall->mirror < desc->sectors[wall->adjoin].wallCount;
+				}
+			}
+		}
+		if (!valid)
+		{
+			TFE_System::logWrite(LOG_WARNING, "Level Cache", "Ignoring invalid cache '%s'.", path);
+		}
+		return valid;
+	}
+
+	void level_writeGeometryCache(const char* levelName, u64 sourceHash, const LevelGeometryDesc* desc)
+	{
+		LevelCacheInfo info;
+		info.paletteName = desc->paletteName;
+		info.parallax0   = desc->parallax0;
+		info.parallax1   = desc->parallax1;
+
+		const CacheSection sections[LCS_COUNT] =
+		{
+			{ &info,          1,                       sizeof(LevelCacheInfo) },
+			{ desc->textures, u32(desc->textureCount), sizeof(s32) },
+			{ desc->sectors,  desc->sectorCount,       sizeof(LevelSectorDesc) },
+			{ desc->walls,    desc->wallCount,         sizeof(LevelWallDesc) },
+			{ desc->vertices, desc->vertexCount,       sizeof(vec2_fixed) },
+			{ desc->strings,  desc->stringSize,        1 },
+		};
+
+		char path[TFE_MAX_PATH];
+		level_getCachePath(levelName, path);
+		cache_write(path, LevelCacheSignature, LevelCacheVersion, sourceHash, sections, LCS_COUNT);
+	}
+}
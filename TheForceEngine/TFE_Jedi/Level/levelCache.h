@@ -0,0 +1,89 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Level Cache
+// Binary cache of the parsed level geometry (LEV).
+//
+// The text parser fills in a LevelGeometryDesc, which is written to
+// PATH_PROGRAM_DATA/LevelCache/ along with a hash of the source file.
+// Later loads of the same source read the cache with one bulk read
+// (see TFE_BinaryCache), fix up the array pointers and skip the text
+// parsing entirely. The engine structures are built from the
+// description the same way in both cases, see level_loadGeometry().
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_Jedi/Math/core_math.h>
+#include <vector>
+
+namespace TFE_Jedi
+{
+	enum LevelCacheConst
+	{
+		LEVEL_TEX_NONE    = -1,		// <NoTexture>
+		LEVEL_TEX_INVALID = -2,		// The texture entry could not be read, default.bm is used instead.
+		LEVEL_NO_NAME     = -1,
+	};
+
+	struct LevelSectorDesc
+	{
+		s32 id;
+		s32 name;					// Offset into the string pool or LEVEL_NO_NAME.
+		s32 ambient;
+		s32 floorTex;
+		vec2_fixed floorOffset;
+		fixed16_16 floorHeight;
+		s32 ceilTex;
+		vec2_fixed ceilOffset;
+		fixed16_16 ceilHeight;
+		fixed16_16 secHeight;
+		u32 flags1;
+		u32 flags2;
+		u32 flags3;
+		s32 layer;
+		u32 vertexStart;
+		s32 vertexCount;
+		u32 wallStart;
+		s32 wallCount;
+	};
+
+	struct LevelWallDesc
+	{
+		s32 left;
+		s32 right;
+		s32 midTex;
+		s32 topTex;
+		s32 botTex;
+		s32 signTex;
+		vec2_fixed midOffset;		// Texture offsets are already scaled to texels.
+		vec2_fixed topOffset;
+		vec2_fixed botOffset;
+		vec2_fixed signOffset;
+		s32 adjoin;
+		s32 mirror;
+		u32 flags1;
+		u32 flags2;
+		u32 flags3;
+		s32 light;
+	};
+
+	struct LevelGeometryDesc
+	{
+		s32 paletteName;			// Offset into the string pool.
+		fixed16_16 parallax0;
+		fixed16_16 parallax1;
+
+		s32 textureCount;
+		const s32* textures;		// Offset of each texture name, LEVEL_TEX_NONE or LEVEL_TEX_INVALID.
+		u32 sectorCount;
+		const LevelSectorDesc* sectors;
+		u32 wallCount;
+		const LevelWallDesc* walls;
+		u32 vertexCount;
+		const vec2_fixed* vertices;
+		u32 stringSize;
+		const char* strings;
+	};
+
+	// Returns true and fills in 'desc' if a valid cache exists, the arrays point into 'buffer'.
+	bool level_readGeometryCache(const char* levelName, u64 sourceHash, LevelGeometryDesc* desc, std::vector<u8>& buffer);
+	void level_writeGeometryCache(const char* levelName, u64 sourceHash, const LevelGeometryDesc* desc);
+}
@@ -362,6 +362,9 @@ namespace TFE_Jedi
 			sector->objectCount = 0;
 			sector->objectCapacity = 0;
 			sector->objectList = nullptr;
+			sector->wallGrid = nullptr;
+			sector->objectListHoles = JFALSE;
+			sector->objectsDense = nullptr;
 		}
 
 		SERIALIZE(LevelState_InitVersion, sector->collisionFrame, 0);
@@ -0,0 +1,180 @@
+#include <cstring>
+
+#include "levelPrefetch.h"
+#include <TFE_FileSystem/filePrefetch.h>
+#include <TFE_FileSystem/paths.h>
+#include <TFE_System/jobSystem.h>
+#include <TFE_System/system.h>
+#include <string>
+#include <vector>
+
+using namespace TFE_FilePrefetch;
+using namespace TFE_Jobs;
+
+namespace TFE_Jedi
+{
+	enum LevelPrefetchState
+	{
+		LPREFETCH_NONE = 0,
+		LPREFETCH_READING,		// Waiting for the files to be scanned to be read.
+		LPREFETCH_SCANNING,		// Scanning them for references on a worker thread.
+	};
+
+	struct ScanFile
+	{
+		FilePath path;
+		const char* stopKey;	// Scanning stops at the first line starting with this key, the references are listed before it.
+		const u8* data;
+		size_t size;
+	};
+
+	static const char* c_levelExt[] = { ".LEV", ".O", ".INF", ".GOL" };
+	static const char* c_levelStopKey[] = { "NUMSECTORS", "OBJECTS", nullptr, nullptr };
+	static const char* c_referenceKeys[] = { "TEXTURE:", "POD:", "SPR:", "FME:" };
+
+	static LevelPrefetchState s_state = LPREFETCH_NONE;
+	static std::vector<ScanFile> s_scanFiles;
+	static std::vector<std::string> s_scanNames;
+	static JobCounter s_scanCounter;
+
+	bool isWhitespace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	// Collect the names following the reference keys, this only needs to be good enough to find most files -
+	// anything missed is simply loaded from disk as usual.
+	void scanReferences(const char* data, size_t size, const char* stopKey, std::vector<std::string>& names)
+	{
+		const char* end = data + size;
+		const size_t stopLen = stopKey ? strlen(stopKey) : 0;
+		while (data < end)
+		{
+			const char* lineEnd = (const char*)memchr(data, '\n', end - data);
+			if (!lineEnd) { lineEnd = end; }
+			while (data < lineEnd && isWhitespace(*data)) { data++; }
+
+			const size_t lineLen = size_t(lineEnd - data);
+			if (stopLen && lineLen >= stopLen && strncasecmp(data, stopKey, stopLen) == 0)
+			{
+				break;
+			}
+			for (size_t k = 0; k < TFE_ARRAYSIZE(c_referenceKeys); k++)
+			{
+				const size_t keyLen = strlen(c_referenceKeys[k]);
+				if (lineLen < keyLen || strncasecmp(data, c_referenceKeys[k], keyLen) != 0) { continue; }
+
+				const char* name = data + keyLen;
+				while (name < lineEnd && isWhitespace(*name)) { name++; }
+				const char* nameEnd = name;
+				while (nameEnd < lineEnd && !isWhitespace(*nameEnd) && *nameEnd != '#') { nameEnd++; }
+				// Skip empty names and placeholders such as <NoTexture>.
+				if (nameEnd > name && *name != '<')
+				{
+					names.push_back(std::string(name, nameEnd));
+				}
+				break;
+			}
+			data = lineEnd + 1;
+		}
+	}
+
+	// Runs on a worker thread, only touches the data gathered by the main thread before the job was submitted.
+	void scanJob(void* userData, u32 begin, u32 end)
+	{
+		const size_t count = s_scanFiles.size();
+		const ScanFile* file = s_scanFiles.data();
+		for (size_t i = 0; i < count; i++, file++)
+		{
+			if (file->data)
+			{
+				scanReferences((const char*)file->data, file->size, file->stopKey, s_scanNames);
+			}
+		}
+	}
+
+	bool isModel(const char* name)
+	{
+		const size_t len = strlen(name);
+		return len > 4 && strcasecmp(&name[len - 4], ".3DO") == 0;
+	}
+
+	void level_prefetch(const char* levelName)
+	{
+		level_prefetchCancel();
+		if (!levelName || !levelName[0]) { return; }
+
+		char levelPath[TFE_MAX_PATH];
+		for (size_t i = 0; i < TFE_ARRAYSIZE(c_levelExt); i++)
+		{
+			snprintf(levelPath, TFE_MAX_PATH, "%s%s", levelName, c_levelExt[i]);
+
+			ScanFile file = { };
+			if (!TFE_Paths::getFilePath(levelPath, &file.path)) { continue; }
+			prefetch_file(&file.path);
+			if (c_levelStopKey[i])
+			{
+				file.stopKey = c_levelStopKey[i];
+				s_scanFiles.push_back(file);
+			}
+		}
+		s_state = s_scanFiles.empty() ? LPREFETCH_NONE : LPREFETCH_READING;
+	}
+
+	void level_prefetchUpdate()
+	{
+		if (s_state == LPREFETCH_READING)
+		{
+			const size_t count = s_scanFiles.size();
+			ScanFile* file = s_scanFiles.data();
+			for (size_t i = 0; i < count; i++)
+			{
+				if (prefetch_isPending(&file[i].path)) { return; }
+			}
+			// Files that failed or that did not fit in the budget are skipped.
+			for (size_t i = 0; i < count; i++)
+			{
+				file[i].data = prefetch_peek(&file[i].path, &file[i].size);
+			}
+			s_scanNames.clear();
+			jobs_submit("Level Prefetch Scan", scanJob, nullptr, &s_scanCounter);
+			s_state = LPREFETCH_SCANNING;
+		}
+		else if (s_state == LPREFETCH_SCANNING)
+		{
+			if (s_scanCounter.count.load(std::memory_order_acquire) != 0) { return; }
+
+			// Paths are resolved on the main thread, models are scanned for their textures in the next pass.
+			s_scanFiles.clear();
+			const size_t count = s_scanNames.size();
+			for (size_t i = 0; i < count; i++)
+			{
+				ScanFile file = { };
+				if (!TFE_Paths::getFilePath(s_scanNames[i].c_str(), &file.path)) { continue; }
+				if (prefetch_file(&file.path) && isModel(s_scanNames[i].c_str()))
+				{
+					s_scanFiles.push_back(file);
+				}
+			}
+			s_scanNames.clear();
+			s_state = s_scanFiles.empty() ? LPREFETCH_NONE : LPREFETCH_READING;
+		}
+	}
+
+	void level_prefetchStop()
+	{
+		if (s_state == LPREFETCH_SCANNING)
+		{
+			jobs_wait(&s_scanCounter);
+		}
+		s_scanFiles.clear();
+		s_scanNames.clear();
+		s_state = LPREFETCH_NONE;
+	}
+
+	void level_prefetchCancel()
+	{
+		level_prefetchStop();
+		prefetch_clear();
+	}
+}
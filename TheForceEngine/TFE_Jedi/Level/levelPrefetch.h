@@ -0,0 +1,25 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Level Prefetch
+// Reads the files of the next level in the background, such as while
+// the mission briefing is displayed.
+//
+// The LEV, O, INF and GOL files are read first, then the LEV, O and
+// 3DO files are scanned for the textures, sprites, frames and models
+// they reference and those are read as well. level_load() then finds
+// the data through FileStream::readContentsView() and decodes it on
+// the main thread as usual, so the loaded level is identical.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+namespace TFE_Jedi
+{
+	// Start prefetching 'levelName' (without extension).
+	void level_prefetch(const char* levelName);
+	// Queue the next set of files once the current set has been read, call once per frame while waiting.
+	void level_prefetchUpdate();
+	// Stop queuing new files, called when the level starts loading. Files already queued are still used.
+	void level_prefetchStop();
+	// Stop and free any prefetched data that was not used.
+	void level_prefetchCancel();
+}
@@ -140,32 +140,23 @@ namespace TFE_Jedi
 				return;
 			}
 
-			// Assign IDs
-			const u32 size = TFE_Memory::chunkedArraySize(list);
-			for (u32 i = 0; i < size; i++)
+			// Assign IDs, deleted objects are skipped.
+			TFE_Memory::chunkedArrayForEach<SecObject>(list, [&writeCount](SecObject* obj)
 			{
-				SecObject* obj = (SecObject*)TFE_Memory::chunkedArrayGet(list, i);
-
-				// Skip deleted objects.
-				if (!obj->self) { continue; }
 				obj->serializeIndex = writeCount;  // So downstream serialization passes have an object ID to use.
 				writeCount++;
-			}
+			});
 			SERIALIZE(ObjState_InitVersion, writeCount, 0);
 
 			// Write objects.
-			for (u32 i = 0; i < size; i++)
+			TFE_Memory::chunkedArrayForEach<SecObject>(list, [stream](SecObject* obj)
 			{
-				SecObject* obj = (SecObject*)TFE_Memory::chunkedArrayGet(list, i);
-
-				// Skip deleted objects.
-				if (!obj->self) { continue; }
 				// Write the object to the stream.
 				objData_serializeObject(obj, stream);
 
 				u32 logicCount = allocator_getCount((Allocator*)obj->logic);
 				SERIALIZE(ObjState_InitVersion, logicCount, 0);
-				if (!logicCount) { continue; }
+				if (!logicCount) { return; }
 
 				allocator_saveIter((Allocator*)obj->logic);
 					Logic** logicList = (Logic**)allocator_getHead((Allocator*)obj->logic);
@@ -184,7 +175,7 @@ namespace TFE_Jedi
 						logicList = (Logic**)allocator_getNext((Allocator*)obj->logic);
 					}
 				allocator_restoreIter((Allocator*)obj->logic);
-			}
+			});
 		}
 		else if (serialization_getMode() == SMODE_READ)
 		{
@@ -62,28 +62,30 @@ enum ObjStateVersion : u32
 	ObjState_VueSmoothing = 3,
 	ObjState_OneHitCheats = 4,
 	ObjState_CrouchToggle = 5,
-	ObjState_CurVersion = ObjState_CrouchToggle,
+	ObjState_ActorSimLod = 6,
+	ObjState_CurVersion = ObjState_ActorSimLod,
 };
 
 #define SPRITE_SCALE_FIXED FIXED(10)
 
+// Fields are ordered so the data read by collision, sector queries and
+// object sorting comes first; the transform and logic data used by fewer
+// systems follows.
 struct SecObject
 {
 	SecObject* self;
 	ObjectType type;
 	u32 entityFlags;    // see EntityTypeFlags above.
-	void* projectileLogic;	// projectile logic.
 
 	// Position
 	vec3_fixed posWS;
-	vec3_fixed posVS;
 
 	// World Size
 	fixed16_16 worldWidth;
 	fixed16_16 worldHeight;
 
-	// 3x3 transformation matrix.
-	fixed16_16 transform[9];
+	// See ObjectFlags above.
+	u32 flags;
 
 	// Rendering data.
 	union
@@ -93,14 +95,11 @@ struct SecObject
 		WaxFrame* fme;
 		void* ptr;
 	};
+	RSector* sector;
 	s32 frame;
 	s32 anim;
-	RSector* sector;
-	void* logic;
-
-	// See ObjectFlags above.
-	u32 flags;
 
+	vec3_fixed posVS;
 	// Orientation.
 	angle14_16 pitch;
 	angle14_16 yaw;
@@ -108,6 +107,12 @@ struct SecObject
 	// index in containing sector object list.
 	s16 index;
 
+	// 3x3 transformation matrix.
+	fixed16_16 transform[9];
+
+	void* projectileLogic;	// projectile logic.
+	void* logic;
+
 	// TFE
 	u32 serializeIndex;
 };
@@ -51,6 +51,9 @@ namespace TFE_Jedi
 		sector->objectCapacity = 0;
 		sector->verticesWS = nullptr;
 		sector->verticesVS = nullptr;
+		sector->wallGrid = nullptr;
+		sector->objectListHoles = JFALSE;
+		sector->objectsDense = nullptr;
 		sector->self = sector;
 	}
 
@@ -395,10 +398,12 @@ namespace TFE_Jedi
 			{
 				list = (SecObject**)level_alloc(sizeof(SecObject*) * 5);
 				sector->objectList = list;
+				sector->objectsDense = (SecObject**)level_alloc(sizeof(SecObject*) * 5);
 			}
 			else
 			{
 				sector->objectList = (SecObject**)level_realloc(sector->objectList, sizeof(SecObject*) * (objectCapacity + 5));
+				sector->objectsDense = (SecObject**)level_realloc(sector->objectsDense, sizeof(SecObject*) * (objectCapacity + 5));
 				list = sector->objectList + objectCapacity;
 			}
 			memset(list, 0, sizeof(SecObject*) * 5);
@@ -410,14 +415,26 @@ namespace TFE_Jedi
 	{
 		// Then add the object to the first free slot.
 		// Note that this scheme is optimized for deletion rather than addition.
-		SecObject** list = sector->objectList;
-		for (s32 i = 0; i < sector->objectCapacity; i++, list++)
+		// TFE: If the list has no holes, the first free slot is at objectCount.
+		s32 i = sector->objectListHoles ? 0 : sector->objectCount;
+		SecObject** list = sector->objectList + i;
+		for (; i < sector->objectCapacity; i++, list++)
 		{
 			if (!(*list))
 			{
 				*list = obj;
 				obj->index = i;
 				obj->sector = sector;
+
+				// TFE: Keep the dense list in object list order, new objects are usually added at the end.
+				SecObject** dense = sector->objectsDense;
+				s32 d = sector->objectCount;
+				for (; d > 0 && dense[d - 1]->index > i; d--)
+				{
+					dense[d] = dense[d - 1];
+				}
+				dense[d] = obj;
+
 				sector->objectCount++;
 				break;
 			}
@@ -486,6 +503,22 @@ namespace TFE_Jedi
 		objList[obj->index] = nullptr;
 		sector->objectCount--;
 
+		// TFE: Remove the object from the dense list, keeping the order.
+		SecObject** dense = sector->objectsDense;
+		s32 d = 0;
+		while (dense[d] != obj) { d++; }
+		memmove(&dense[d], &dense[d + 1], sizeof(SecObject*) * (sector->objectCount - d));
+		// TFE: Removing the last object in the list does not leave a hole, and an empty list has none.
+		// The lists are never packed, so new objects fill the first hole in the same order as DOS.
+		if (sector->objectCount == 0)
+		{
+			sector->objectListHoles = JFALSE;
+		}
+		else if (obj->index < sector->objectCount)
+		{
+			sector->objectListHoles = JTRUE;
+		}
+
 		if (!((obj->entityFlags & ETFLAG_PLAYER) && s_playerDying))
 		{
 			message_sendToSector(sector, obj, INF_EVENT_LEAVE_SECTOR, MSG_TRIGGER);
@@ -923,6 +956,7 @@ namespace TFE_Jedi
 		wall->angle = vec2ToAngle(dx, dz);
 
 		RSector* sector = wall->sector;
+		collision_wallGridMoveVertex(wall);
 		if (sector->flags1 & SEC_FLAGS1_PLAYER)
 		{
 			s_playerSecMoved = JTRUE;
@@ -1095,6 +1129,7 @@ namespace TFE_Jedi
 
 		// Set the appropriate game value if the player is inside the sector.
 		RSector* sector = wall->sector;
+		collision_wallGridMoveVertex(wall);
 		if (sector->flags1 & SEC_FLAGS1_PLAYER)
 		{
 			s_playerSecMoved = JTRUE;
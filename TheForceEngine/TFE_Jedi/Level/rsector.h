@@ -13,6 +13,7 @@ struct TextureData;
 
 struct RWall;
 struct SecObject;
+struct SectorWallGrid;
 
 enum SectorFlags1
 {
@@ -132,6 +133,15 @@ struct RSector
 
 	// Added for TFE, to support floating point and GPU sub-renderers.
 	u32 dirtyFlags;
+
+	// Added for TFE, collision wall grid - built on demand, walls that move are tracked in the grid itself.
+	SectorWallGrid* wallGrid;
+	// Added for TFE, set when an object removal leaves a hole in the object list.
+	JBool objectListHoles;
+	// Added for TFE, the same objects in the same order as objectList but packed without holes
+	// (objectCount entries), so queries that only read the objects can iterate them linearly.
+	// objectList must still be used by loops that can add or remove objects.
+	SecObject** objectsDense;
 };
 
 namespace TFE_Jedi
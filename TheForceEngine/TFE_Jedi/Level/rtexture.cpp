@@ -225,18 +225,14 @@ namespace TFE_Jedi
 		{
 			return;
 		}
-		FileStream file;
-		if (!file.open(&filepath, Stream::MODE_READ))
+		// Load the raw data, this reads directly from the archive if it is memory mapped.
+		size_t size;
+		const u8* srcData = FileStream::readContentsView(&filepath, s_buffer, &size);
+		if (!srcData)
 		{
 			return;
 		}
 
-		// Load the raw data from disk.
-		size_t size = file.getSize();
-		s_buffer.resize(size);
-		file.readBuffer(s_buffer.data(), (u32)size);
-		file.close();
-
 		// Process the data based on the base texture.
 		s32 width  = texData->width  * scaleFactor;
 		s32 height = texData->height * scaleFactor;
@@ -265,7 +261,6 @@ namespace TFE_Jedi
 		memset(texData->hdAssetData, 0, hdFrameSize * frameCount);
 		
 		u8* dstData = texData->hdAssetData;
-		const u8* srcData = s_buffer.data();
 		for (s32 i = 0; i < frameCount; i++)
 		{
 			for (u32 y = 0; y < height; y++)
@@ -323,21 +318,16 @@ namespace TFE_Jedi
 			return nullptr;
 		}
 
-		FileStream file;
-		if (!file.open(&filepath, Stream::MODE_READ))
+		size_t size;
+		const u8* data = FileStream::readContentsView(&filepath, s_buffer, &size);
+		if (!data)
 		{
 			return nullptr;
 		}
 
-		size_t size = file.getSize();
-		s_buffer.resize(size);
-		file.readBuffer(s_buffer.data(), (u32)size);
-		file.close();
-
 		TextureData* texture = (TextureData*)region_alloc(s_texState.memoryRegion, sizeof(TextureData));
 		memset(texture, 0, sizeof(TextureData));
 
-		const u8* data = s_buffer.data();
 		const u8* end = data + size;
 		const u8* fheader = data;
 		data += 3;
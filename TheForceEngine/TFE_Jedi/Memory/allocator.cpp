@@ -1,15 +1,30 @@
 #include "allocator.h"
 #include <TFE_System/system.h>
 #include <TFE_Game/igame.h>
+#include <TFE_Jedi/Math/core_math.h>
 #include <cstring>
 
 struct AllocHeader
 {
 	AllocHeader* prev;
 	AllocHeader* next;
+	s32 index;			// position in the list, valid when the allocator order is not dirty.
+	s32 slot;			// slot in the owning chunk.
 	char data[];		// actual data storage area.
 };
 
+// Items are stored in chunks of contiguous slots rather than allocated one at a time,
+// the list links above still define the iteration order.
+struct AllocChunk
+{
+	AllocChunk* prevFree;	// chunks with free slots are linked, so a free slot is found without a search.
+	AllocChunk* nextFree;
+	u32 freeMask;		// one bit per slot, set if the slot is free.
+	s32 capacity;
+	s32 index;			// position in Allocator::chunks.
+	// slots follow.
+};
+
 struct Allocator
 {
 	Allocator*   self;
@@ -24,6 +39,20 @@ struct Allocator
 	// TFE
 	AllocHeader* iterSave;
 	AllocHeader* iterPrevSave;
+
+	// Slab storage.
+	AllocChunk** chunks;
+	AllocChunk* freeChunks;		// chunks with at least one free slot.
+	s32 chunkCount;
+	s32 chunkCapacity;
+	s32 slotCount;		// total number of slots, used to size the next chunk.
+
+	// Items in list order, so index <-> item lookups are O(1) while the order is valid.
+	// Removing an item from the middle of the list invalidates it, and the next lookup rebuilds it in O(n).
+	AllocHeader** order;
+	s32 count;
+	s32 orderCapacity;
+	JBool orderDirty;
 };
 
 // given an "item" (=allocheader->data), get the "AllocHeader" it belongs to.
@@ -42,6 +71,126 @@ namespace TFE_Jedi
 {
 	#define MAX_ALLOC_SIZE (8*1024*1024)  // 8MB
 
+	enum AllocatorConstants
+	{
+		ALLOC_CHUNK_MIN_SLOTS = 4,
+		ALLOC_CHUNK_MAX_SLOTS = 32,			// limited by AllocChunk::freeMask.
+		ALLOC_CHUNK_MAX_BYTES = 64 * 1024,	// large items use smaller chunks.
+		ALLOC_ORDER_MIN_CAPACITY = 16,
+	};
+
+	static u8* chunk_getSlot(Allocator* alloc, AllocChunk* chunk, s32 slot)
+	{
+		return (u8*)chunk + sizeof(AllocChunk) + slot * alloc->size;
+	}
+
+	static AllocChunk* chunk_fromHeader(Allocator* alloc, AllocHeader* header)
+	{
+		return (AllocChunk*)((u8*)header - header->slot * alloc->size - sizeof(AllocChunk));
+	}
+
+	static u32 chunk_getFullMask(AllocChunk* chunk)
+	{
+		return chunk->capacity >= 32 ? ~0u : (1u << chunk->capacity) - 1u;
+	}
+
+	static void chunk_linkFree(Allocator* alloc, AllocChunk* chunk)
+	{
+		chunk->prevFree = nullptr;
+		chunk->nextFree = alloc->freeChunks;
+		if (alloc->freeChunks) { alloc->freeChunks->prevFree = chunk; }
+		alloc->freeChunks = chunk;
+	}
+
+	static void chunk_unlinkFree(Allocator* alloc, AllocChunk* chunk)
+	{
+		if (chunk->prevFree) { chunk->prevFree->nextFree = chunk->nextFree; }
+		else { alloc->freeChunks = chunk->nextFree; }
+		if (chunk->nextFree) { chunk->nextFree->prevFree = chunk->prevFree; }
+		chunk->prevFree = nullptr;
+		chunk->nextFree = nullptr;
+	}
+
+	static AllocChunk* allocator_addChunk(Allocator* alloc)
+	{
+		// Start small since many allocators only hold a few items, then grow with the allocator.
+		s32 capacity = clamp(alloc->slotCount, (s32)ALLOC_CHUNK_MIN_SLOTS, (s32)ALLOC_CHUNK_MAX_SLOTS);
+		capacity = max(1, min(capacity, (s32)ALLOC_CHUNK_MAX_BYTES / alloc->size));
+
+		AllocChunk* chunk = (AllocChunk*)TFE_Memory::region_alloc(alloc->region, sizeof(AllocChunk) + capacity * alloc->size);
+		if (!chunk) { return nullptr; }
+		chunk->capacity = capacity;
+		chunk->freeMask = chunk_getFullMask(chunk);
+
+		if (alloc->chunkCount >= alloc->chunkCapacity)
+		{
+			s32 newCapacity = max((s32)ALLOC_CHUNK_MIN_SLOTS, alloc->chunkCapacity * 2);
+			AllocChunk** chunks = (AllocChunk**)TFE_Memory::region_realloc(alloc->region, alloc->chunks, sizeof(AllocChunk*) * newCapacity);
+			if (!chunks)
+			{
+				TFE_Memory::region_free(alloc->region, chunk);
+				return nullptr;
+			}
+			alloc->chunks = chunks;
+			alloc->chunkCapacity = newCapacity;
+		}
+		chunk->index = alloc->chunkCount;
+		alloc->chunks[alloc->chunkCount++] = chunk;
+		alloc->slotCount += capacity;
+		chunk_linkFree(alloc, chunk);
+		return chunk;
+	}
+
+	static void allocator_removeChunk(Allocator* alloc, AllocChunk* chunk)
+	{
+		// Move the last chunk into the hole.
+		AllocChunk* last = alloc->chunks[--alloc->chunkCount];
+		alloc->chunks[chunk->index] = last;
+		last->index = chunk->index;
+
+		chunk_unlinkFree(alloc, chunk);
+		alloc->slotCount -= chunk->capacity;
+		TFE_Memory::region_free(alloc->region, chunk);
+	}
+
+	static void allocator_rebuildOrder(Allocator* alloc)
+	{
+		s32 index = 0;
+		AllocHeader* header = alloc->head;
+		while (header)
+		{
+			header->index = index;
+			alloc->order[index] = header;
+			index++;
+			header = header->next;
+		}
+		assert(index == alloc->count);
+		alloc->orderDirty = JFALSE;
+	}
+
+	// Get the item header at list position 'index', or null if it is out of range.
+	static AllocHeader* allocator_getHeaderByIndex(Allocator* alloc, s32 index)
+	{
+		if (index < 0 || index >= alloc->count) { return nullptr; }
+		if (alloc->orderDirty)
+		{
+			allocator_rebuildOrder(alloc);
+		}
+		return alloc->order[index];
+	}
+
+	// Get the list position of 'header', or -1 if it is null.
+	static s32 allocator_getHeaderIndex(Allocator* alloc, AllocHeader* header)
+	{
+		if (!header) { return -1; }
+		if (alloc->orderDirty)
+		{
+			allocator_rebuildOrder(alloc);
+		}
+		const s32 index = header->index;
+		return (index >= 0 && index < alloc->count && alloc->order[index] == header) ? index : -1;
+	}
+
 	// Create and free an allocator.
 	Allocator* allocator_create(s32 allocSize, MemoryRegion* region)
 	{
@@ -60,7 +209,8 @@ namespace TFE_Jedi
 		memset(res, 0, sizeof(Allocator));
 		res->self = res;
 		res->region = region;
-		res->size = allocSize + sizeof(AllocHeader);
+		// Round up so that every slot in a chunk is 8 byte aligned.
+		res->size = (allocSize + sizeof(AllocHeader) + 7) & ~7;
 		res->refCount = 0;
 
 		return res;
@@ -69,13 +219,14 @@ namespace TFE_Jedi
 	void allocator_free(Allocator* alloc)
 	{
 		if (!alloc) { return; }
+		TFE_TRACK_FREE(TFE_Memory::region_getSubAllocTag(alloc->region), u64(alloc->size) * alloc->count, alloc->count);
 
-		void* item = allocator_getHead(alloc);
-		while (item)
+		for (s32 i = 0; i < alloc->chunkCount; i++)
 		{
-			allocator_deleteItem(alloc, item);
-			item = allocator_getNext(alloc);
+			TFE_Memory::region_free(alloc->region, alloc->chunks[i]);
 		}
+		TFE_Memory::region_free(alloc->region, alloc->chunks);
+		TFE_Memory::region_free(alloc->region, alloc->order);
 
 		alloc->self = nullptr;
 		TFE_Memory::region_free(alloc->region, alloc);
@@ -91,13 +242,43 @@ namespace TFE_Jedi
 	{
 		if (!alloc) { return nullptr; }
 
-		AllocHeader* header = (AllocHeader*)TFE_Memory::region_alloc(alloc->region, alloc->size);
-		if (!header)
+		// Make sure there is room in the order list first, so a failure leaves the allocator unchanged.
+		if (alloc->count >= alloc->orderCapacity)
+		{
+			s32 newCapacity = max((s32)ALLOC_ORDER_MIN_CAPACITY, alloc->orderCapacity * 2);
+			AllocHeader** order = (AllocHeader**)TFE_Memory::region_realloc(alloc->region, alloc->order, sizeof(AllocHeader*) * newCapacity);
+			if (!order)
+			{
+				TFE_System::logWrite(LOG_ERROR, "Allocator", "allocator_newItem - cannot grow the item list to %d items", newCapacity);
+				return nullptr;
+			}
+			alloc->order = order;
+			alloc->orderCapacity = newCapacity;
+		}
+
+		// Find a free slot, filling holes in existing chunks before adding a new one.
+		AllocChunk* chunk = alloc->freeChunks;
+		if (!chunk)
+		{
+			chunk = allocator_addChunk(alloc);
+		}
+		if (!chunk)
 		{
 			TFE_System::logWrite(LOG_ERROR, "Allocator", "allocator_newItem - cannot allocate header of size %d", alloc->size);
 			return nullptr;
 		}
+
+		s32 slot = 0;
+		while (!(chunk->freeMask & (1u << slot))) { slot++; }
+		chunk->freeMask &= ~(1u << slot);
+		if (!chunk->freeMask)
+		{
+			chunk_unlinkFree(alloc, chunk);
+		}
+
+		AllocHeader* header = (AllocHeader*)chunk_getSlot(alloc, chunk, slot);
 		memset(header, 0, alloc->size);
+		header->slot = slot;
 
 		header->next = nullptr;
 		header->prev = alloc->tail;
@@ -113,6 +294,11 @@ namespace TFE_Jedi
 			alloc->head = header;
 		}
 
+		// New items are always added to the end of the list.
+		header->index = alloc->count;
+		alloc->order[alloc->count++] = header;
+		TFE_TRACK_ALLOC(TFE_Memory::region_getSubAllocTag(alloc->region), alloc->size);
+
 		return GET_DATA(header);
 	}
 
@@ -122,6 +308,7 @@ namespace TFE_Jedi
 
 		AllocHeader* header = AllocHeader_of(item);
 		if (header == nullptr) { return; }
+		TFE_TRACK_FREE(TFE_Memory::region_getSubAllocTag(alloc->region), alloc->size);
 
 		AllocHeader* prev = header->prev;
 		AllocHeader* next = header->next;
@@ -141,128 +328,73 @@ namespace TFE_Jedi
 			alloc->iterPrev = header->next;
 		}
 
-		TFE_Memory::region_free(alloc->region, header);
+		// Removing the last item keeps the order intact, otherwise the items that follow need new indices.
+		alloc->count--;
+		if (next)
+		{
+			alloc->orderDirty = JTRUE;
+		}
+
+		AllocChunk* chunk = chunk_fromHeader(alloc, header);
+		if (!chunk->freeMask)
+		{
+			chunk_linkFree(alloc, chunk);
+		}
+		chunk->freeMask |= (1u << header->slot);
+		// Give the memory back once the chunk is empty.
+		if (chunk->freeMask == chunk_getFullMask(chunk))
+		{
+			allocator_removeChunk(alloc, chunk);
+		}
 	}
 
 	// Random access.
 	s32 allocator_getCount(Allocator* alloc)
 	{
-		if (!alloc) { return 0; }
-
-		s32 count = 0;
-		AllocHeader* header = alloc->head;
-		while (header)
-		{
-			count++;
-			header = header->next;
-		}
-		return count;
+		return alloc ? alloc->count : 0;
 	}
 		
 	s32 allocator_getCurPos(Allocator* alloc)
 	{
 		if (!alloc) { return -1; }
-
-		s32 index = 0;
-		AllocHeader* iter = alloc->iter;
-		AllocHeader* header = alloc->head;
-		while (header)
-		{
-			if (header == iter)
-			{
-				return index;
-			}
-			index++;
-			header = header->next;
-		}
-		return -1;
+		return allocator_getHeaderIndex(alloc, alloc->iter);
 	}
 
 	void allocator_setPos(Allocator* alloc, s32 pos)
 	{
 		if (!alloc) { return; }
-
-		s32 index = 0;
-		AllocHeader* header = alloc->head;
-		alloc->iter = nullptr;
-		while (header)
-		{
-			if (index == pos)
-			{
-				alloc->iter = header;
-				break;
-			}
-			index++;
-			header = header->next;
-		}
+		alloc->iter = allocator_getHeaderByIndex(alloc, pos);
 	}
 		
 	s32 allocator_getPrevPos(Allocator* alloc)
 	{
 		if (!alloc) { return -1; }
-
-		s32 index = 0;
-		AllocHeader* iterPrev = alloc->iterPrev;
-		AllocHeader* header = alloc->head;
-		while (header)
-		{
-			if (header == iterPrev)
-			{
-				return index;
-			}
-			index++;
-			header = header->next;
-		}
-		return -1;
+		return allocator_getHeaderIndex(alloc, alloc->iterPrev);
 	}
 
 	void allocator_setPrevPos(Allocator* alloc, s32 pos)
 	{
 		if (!alloc) { return; }
 
-		s32 index = 0;
-		AllocHeader* header = alloc->head;
-		while (header)
+		AllocHeader* header = allocator_getHeaderByIndex(alloc, pos);
+		if (header)
 		{
-			if (index == pos)
-			{
-				alloc->iterPrev = header;
-				break;
-			}
-			index++;
-			header = header->next;
+			alloc->iterPrev = header;
 		}
 	}
 
 	s32 allocator_getIndex(Allocator* alloc, void* item)
 	{
 		if (!item || !alloc) { return -1; }
-
-		AllocHeader* header = alloc->head;
-		s32 index = 0;
-		while (header)
-		{
-			if (item == &(header->data))
-			{
-				return index;
-			}
-			index++;
-			header = header->next;
-		}
-		return -1;
+		return allocator_getHeaderIndex(alloc, AllocHeader_of(item));
 	}
 
 	void* allocator_getByIndex(Allocator* alloc, s32 index)
 	{
 		if (!alloc) { return nullptr; }
 
-		AllocHeader* header = alloc->head;
-		while (index > 0 && header)
-		{
-			index--;
-			header = header->next;
-		}
-
+		// Negative indices return the head, matching the original list walk.
+		AllocHeader* header = allocator_getHeaderByIndex(alloc, max(index, 0));
 		alloc->iterPrev = header;
 		alloc->iter = header;
 		return GET_DATA(header);
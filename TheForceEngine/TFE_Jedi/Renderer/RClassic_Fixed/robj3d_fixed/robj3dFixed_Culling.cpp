@@ -1,12 +1,15 @@
 #include <TFE_System/profiler.h>
 #include <TFE_Jedi/Math/fixedPoint.h>
 #include <TFE_Jedi/Math/core_math.h>
+#include <TFE_Memory/frameArena.h>
 
 #include "robj3dFixed_Culling.h"
 #include "robj3dFixed_TransformAndLighting.h"
 #include "../rclassicFixedSharedState.h"
 #include "../../rcommon.h"
 
+using namespace TFE_Memory;
+
 namespace TFE_Jedi
 {
 
@@ -19,7 +22,7 @@ namespace RClassic_Fixed
 	};
 
 	// List of potentially visible polygons (after backface culling).
-	std::vector<JmPolygon*> s_visPolygons;
+	JmPolygon** s_visPolygons = nullptr;
 
 	s32 getPolygonFacing(const vec3_fixed* normal, const vec3_fixed* pos)
 	{
@@ -29,7 +32,7 @@ namespace RClassic_Fixed
 
 	s32 robj3d_backfaceCull(JediModel* model)
 	{
-		vec3_fixed* polygonNormal = s_polygonNormalsVS.data();
+		vec3_fixed* polygonNormal = s_polygonNormalsVS;
 		s32 polygonCount = model->polygonCount;
 		JmPolygon* polygon = model->polygons;
 		for (s32 i = 0; i < polygonCount; i++, polygonNormal++, polygon++)
@@ -40,16 +43,13 @@ namespace RClassic_Fixed
 			polygonNormal->z -= vertex->z;
 		}
 
-		if (polygonCount > s_visPolygons.size())
-		{
-			s_visPolygons.resize(polygonCount * 2);
-		}
+		s_visPolygons = frameArena_allocArray<JmPolygon*>(polygonCount);
 
-		JmPolygon** visPolygon = s_visPolygons.data();
+		JmPolygon** visPolygon = s_visPolygons;
 		s32 visPolygonCount = 0;
 
 		polygon = model->polygons;
-		polygonNormal = s_polygonNormalsVS.data();
+		polygonNormal = s_polygonNormalsVS;
 		for (s32 i = 0; i < model->polygonCount; i++, polygon++, polygonNormal++)
 		{
 			vec3_fixed* pos = &s_verticesVS[polygon->indices[1]];
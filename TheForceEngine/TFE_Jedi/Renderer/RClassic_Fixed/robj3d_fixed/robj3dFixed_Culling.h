@@ -10,7 +10,7 @@ namespace TFE_Jedi
 {
 	namespace RClassic_Fixed
 	{
-		extern std::vector<JmPolygon*> s_visPolygons;
+		extern JmPolygon** s_visPolygons;
 		s32 robj3d_backfaceCull(JediModel* model);
 	}
 }
@@ -1,11 +1,14 @@
 #include <TFE_System/profiler.h>
 #include <TFE_Jedi/Level/robject.h>
 #include <TFE_Jedi/Math/core_math.h>
+#include <TFE_Memory/frameArena.h>
 #include "robj3dFixed_TransformAndLighting.h"
 #include "../rclassicFixedSharedState.h"
 #include "../rlightingFixed.h"
 #include "../../rcommon.h"
 
+using namespace TFE_Memory;
+
 namespace TFE_Jedi
 {
 
@@ -21,16 +24,16 @@ namespace RClassic_Fixed
 	/////////////////////////////////////////////
 	// TFE: Model limits have been lifted, requiring some changes.
 	// Vertex attributes transformed to viewspace.
-	std::vector<vec3_fixed> s_verticesVS;
-	std::vector<vec3_fixed> s_vertexNormalsVS;
+	vec3_fixed* s_verticesVS = nullptr;
+	vec3_fixed* s_vertexNormalsVS = nullptr;
 	// Vertex Lighting.
-	std::vector<fixed16_16> s_vertexIntensity;
+	fixed16_16* s_vertexIntensity = nullptr;
 
 	/////////////////////////////////////////////
 	// Polygon Processing
 	/////////////////////////////////////////////
 	// Polygon normals in viewspace (used for culling).
-	std::vector<vec3_fixed> s_polygonNormalsVS;
+	vec3_fixed* s_polygonNormalsVS = nullptr;
 			
 	void robj3d_transformVertices(s32 vertexCount, vec3_fixed* vtxIn, s32* xform, vec3_fixed* offset, vec3_fixed* vtxOut)
 	{
@@ -115,18 +118,13 @@ namespace RClassic_Fixed
 		}
 	}
 
+	// Buffers are allocated from the frame arena and released when robj3d_draw() returns.
 	void robj3d_allocateBuffers(JediModel* model)
 	{
-		if (model->vertexCount > s_verticesVS.size())
-		{
-			s_verticesVS.resize(model->vertexCount);
-			s_vertexNormalsVS.resize(model->vertexCount);
-			s_vertexIntensity.resize(model->vertexCount);
-		}
-		if (model->polygonCount > s_polygonNormalsVS.size())
-		{
-			s_polygonNormalsVS.resize(model->polygonCount);
-		}
+		s_verticesVS = frameArena_allocArray<vec3_fixed>(model->vertexCount);
+		s_vertexNormalsVS = frameArena_allocArray<vec3_fixed>(model->vertexCount);
+		s_vertexIntensity = frameArena_allocArray<fixed16_16>(model->vertexCount);
+		s_polygonNormalsVS = frameArena_allocArray<vec3_fixed>(model->polygonCount);
 	}
 		
 	void robj3d_transformAndLight(SecObject* obj, JediModel* model)
@@ -148,19 +146,19 @@ namespace RClassic_Fixed
 		mulMatrix3x3(s_rcfState.cameraMtx, obj->transform, xform);
 
 		// Transform model vertices into view space.
-		robj3d_transformVertices(model->vertexCount, (vec3_fixed*)model->vertices, xform, &offsetVS, s_verticesVS.data());
+		robj3d_transformVertices(model->vertexCount, (vec3_fixed*)model->vertices, xform, &offsetVS, s_verticesVS);
 
 		// No need for polygon normals or lighting if MFLAG_DRAW_VERTICES is set.
 		if (model->flags & MFLAG_DRAW_VERTICES) { return; }
 
 		// Polygon normals (used for backface culling)
-		robj3d_transformVertices(model->polygonCount, (vec3_fixed*)model->polygonNormals, xform, &offsetVS, s_polygonNormalsVS.data());
+		robj3d_transformVertices(model->polygonCount, (vec3_fixed*)model->polygonNormals, xform, &offsetVS, s_polygonNormalsVS);
 
 		// Lighting
 		if (model->flags & MFLAG_VERTEX_LIT)
 		{
-			robj3d_transformVertices(model->vertexCount, (vec3_fixed*)model->vertexNormals, xform, &offsetVS, s_vertexNormalsVS.data());
-			robj3d_shadeVertices(model->vertexCount, s_vertexIntensity.data(), s_verticesVS.data(), s_vertexNormalsVS.data());
+			robj3d_transformVertices(model->vertexCount, (vec3_fixed*)model->vertexNormals, xform, &offsetVS, s_vertexNormalsVS);
+			robj3d_shadeVertices(model->vertexCount, s_vertexIntensity, s_verticesVS, s_vertexNormalsVS);
 		}
 	}
 
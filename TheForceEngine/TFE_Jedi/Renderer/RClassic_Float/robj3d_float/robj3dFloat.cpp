@@ -3,6 +3,7 @@
 #include <TFE_Jedi/Level/robject.h>
 #include <TFE_Jedi/Math/fixedPoint.h>
 #include <TFE_Jedi/Math/core_math.h>
+#include <TFE_Memory/frameArena.h>
 #include <TFE_Jedi/Renderer/virtualFramebuffer.h>
 
 #include "robj3dFloat.h"
@@ -27,6 +28,9 @@ namespace RClassic_Float
 
 	void robj3d_draw(SecObject* obj, JediModel* model)
 	{
+		// Per-model vertex and polygon buffers are released at the end of the draw.
+		TFE_Memory::FrameArenaScope arenaScope;
+
 		// Handle transforms and vertex lighting.
 		robj3d_transformAndLight(obj, model);
 
@@ -39,7 +43,7 @@ namespace RClassic_Float
 			const s32 scale = max(1, (s32)(height / 200));
 
 			// If the MFLAG_DRAW_VERTICES flag is set, draw all vertices as points. 
-			robj3d_drawVertices(model->vertexCount, s_verticesVS.data(), model->polygons[0].color, scale);
+			robj3d_drawVertices(model->vertexCount, s_verticesVS, model->polygons[0].color, scale);
 			return;
 		}
 
@@ -49,10 +53,10 @@ namespace RClassic_Float
 		if (visPolygonCount < 1) { return; }
 
 		// Sort polygons from back to front.
-		qsort(s_visPolygons.data(), visPolygonCount, sizeof(JmPolygon*), polygonSort);
+		qsort(s_visPolygons, visPolygonCount, sizeof(JmPolygon*), polygonSort);
 
 		// Draw polygons
-		JmPolygon** visPolygon = s_visPolygons.data();
+		JmPolygon** visPolygon = s_visPolygons;
 		JBool drawn = JFALSE;
 		for (s32 i = 0; i < visPolygonCount; i++, visPolygon++)
 		{
@@ -17,12 +17,12 @@ namespace TFE_Jedi
 	{
 		extern s32 s_enableFlatShading;
 		// Vertex attributes transformed to viewspace.
-		extern std::vector<vec3_float> s_verticesVS;
-		extern std::vector<vec3_float> s_vertexNormalsVS;
+		extern vec3_float* s_verticesVS;
+		extern vec3_float* s_vertexNormalsVS;
 		// Vertex Lighting.
-		extern std::vector<f32> s_vertexIntensity;
+		extern f32* s_vertexIntensity;
 		// Polygon normals in viewspace (used for culling).
-		extern std::vector<vec3_float> s_polygonNormalsVS;
+		extern vec3_float* s_polygonNormalsVS;
 
 		void robj3d_transformAndLight(SecObject* obj, JediModel* model);
 	}
@@ -1682,6 +1682,7 @@ namespace TFE_Jedi
 		
 		// Mark sector as being rendered for the automap.
 		curSector->flags1 |= SEC_FLAGS1_RENDERED;
+		curSector->prevDrawFrame2 = s_drawFrame;
 
 		// Build the world-space wall segments.
 		u32 segCount = 0;
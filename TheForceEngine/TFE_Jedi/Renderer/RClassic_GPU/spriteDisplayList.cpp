@@ -10,6 +10,7 @@
 #include <TFE_Jedi/Level/rtexture.h>
 #include <TFE_Jedi/Math/fixedPoint.h>
 #include <TFE_Jedi/Math/core_math.h>
+#include <TFE_Memory/frameArena.h>
 
 #include <TFE_Input/input.h>
 
@@ -210,8 +211,9 @@ namespace TFE_Jedi
 	// Sort the display list from back to front.
 	void sprdisplayList_sort()
 	{
-		// Fill in the sort keys.
-		static SpriteSortKey sortKey[MAX_DISP_ITEMS];
+		// Fill in the sort keys, the scratch memory is released when the function returns.
+		TFE_Memory::FrameArenaScope arenaScope;
+		SpriteSortKey* sortKey = TFE_Memory::frameArena_allocArray<SpriteSortKey>(s_displayListCount);
 		for (s32 i = 0; i < s_displayListCount; i++)
 		{
 			sortKey[i].index = i;
@@ -11,6 +11,7 @@
 #include <stdarg.h>
 #include <tuple>
 #include <vector>
+#include <unordered_map>
 
 using namespace TFE_DarkForces;
 using namespace TFE_Memory;
@@ -30,6 +31,7 @@ struct TaskContext
 
 	u8* stackMem;		// starts out null, can point to the block if ever needed.
 	u32 stackOffset;	// where in the stack we are.
+	s32 stackClass;		// size class of 'stackMem', see c_stackClassSize.
 
 	u8* stackPtr[TASK_MAX_LEVELS];
 	u32 stackSize[TASK_MAX_LEVELS];
@@ -63,6 +65,11 @@ struct Task
 
 	// Timing.
 	Tick nextTick;
+
+	// Scheduling.
+	s32 heapIndex;		// Index into the wait heap, -1 if the task is not waiting on a future tick.
+	s32 order;			// Position in the execution order, -1 if not yet assigned.
+	JBool ready;		// JTRUE if the task was runnable the last time it was scheduled.
 };
 
 namespace TFE_Jedi
@@ -72,12 +79,19 @@ namespace TFE_Jedi
 		TASK_CHUNK_SIZE = 256,
 		TASK_PREALLOCATED_CHUNKS = 1,
 
-		TASK_STACK_SIZE = 32 * 1024,	// 32KB of stack memory.
-		TASK_STACK_CHUNK_SIZE = 64,		// 2MB of memory for 64 tasks with stack memory.
+		TASK_STACK_SIZE = 32 * 1024,	// 32KB of stack memory, the largest stack size class.
+		TASK_STACK_CLASS_COUNT = 4,
 	};
 
+	// Task stack memory is pooled by size class. Most tasks only need a few hundred bytes of local memory,
+	// so a task starts with the smallest class that fits its first LocalContext (or the most that tasks with
+	// the same entry function have used before) and moves to a larger class if a nested call needs more.
+	// Local memory is always accessed through ctxGet(), so the stack can be moved between allocations.
+	static const u32 c_stackClassSize[TASK_STACK_CLASS_COUNT]  = { 256, 1024, 4096, TASK_STACK_SIZE };
+	static const u32 c_stackClassChunk[TASK_STACK_CLASS_COUNT] = { 128, 64, 32, 16 };
+
 	ChunkedArray* s_tasks = nullptr;
-	ChunkedArray* s_stackBlocks = nullptr;
+	ChunkedArray* s_stackBlocks[TASK_STACK_CLASS_COUNT] = { nullptr };
 	s32 s_taskCount = 0;
 
 	Task  s_rootTask;
@@ -94,22 +108,109 @@ namespace TFE_Jedi
 	static bool s_enableTimeLimiter = true;
 	static Task* s_taskPauseTask = nullptr;
 
+	// Scheduling.
+	// Tasks delayed until a future tick are kept in a min-heap keyed on nextTick, sleeping tasks are not tracked
+	// at all and runnable tasks are flagged in a bit array indexed by their position in the execution order.
+	// This way selectNextTask() only needs to look at tasks that can actually run while still visiting them
+	// in the same main-task/sub-task order as before. The order is rebuilt lazily when tasks are added or removed.
+	static std::vector<Task*> s_waitHeap;
+	static std::vector<Task*> s_taskOrder;
+	static std::vector<u32> s_readyBits;
+	static JBool s_taskOrderDirty = JTRUE;
+	static s32 s_waitingTaskCount = 0;
+
+	// Stack usage.
+	static std::unordered_map<TaskFunc, u32> s_stackHighWater;	// Largest stack offset reached by tasks, keyed on the entry function.
+	static s32 s_stackKB = 0;
+	static s32 s_stackHighWaterKB = 0;
+	static s32 s_stackRelocations = 0;
+	static u32 s_stackBytes = 0;
+	static u32 s_stackBytesHighWater = 0;
+
 	void selectNextTask();
+	void task_schedule(Task* task, Tick tick);
+	void task_clearSchedule();
+
+	static s32 task_getStackClass(u32 size)
+	{
+		for (s32 i = 0; i < TASK_STACK_CLASS_COUNT - 1; i++)
+		{
+			if (size <= c_stackClassSize[i]) { return i; }
+		}
+		assert(size <= TASK_STACK_SIZE);
+		return TASK_STACK_CLASS_COUNT - 1;
+	}
+
+	static void task_updateStackBytes(s32 delta)
+	{
+		s_stackBytes += delta;
+		s_stackBytesHighWater = max(s_stackBytesHighWater, s_stackBytes);
+		s_stackKB = s32((s_stackBytes + 1023) >> 10);
+		s_stackHighWaterKB = s32((s_stackBytesHighWater + 1023) >> 10);
+	}
+
+	// Make sure the context stack can hold at least 'size' bytes, allocating or moving it to a larger class if needed.
+	static void task_reserveStack(TaskContext* context, u32 size)
+	{
+		if (context->stackMem && size <= c_stackClassSize[context->stackClass]) { return; }
+
+		// Use the most that any task with the same entry function has needed, to avoid moving the stack later.
+		std::unordered_map<TaskFunc, u32>::const_iterator highWater = s_stackHighWater.find(context->callstack[0]);
+		if (highWater != s_stackHighWater.end()) { size = max(size, highWater->second); }
+
+		const s32 stackClass = task_getStackClass(size);
+		u8* stackMem = (u8*)allocFromChunkedArray(s_stackBlocks[stackClass]);
+		assert(stackMem);
+		task_updateStackBytes(s32(c_stackClassSize[stackClass]));
+
+		u8* prevStackMem = context->stackMem;
+		if (prevStackMem)
+		{
+			// Move the existing stack and re-base the pointers of each level.
+			memcpy(stackMem, prevStackMem, context->stackOffset);
+			for (s32 i = 0; i < TASK_MAX_LEVELS; i++)
+			{
+				if (context->stackPtr[i])
+				{
+					context->stackPtr[i] = stackMem + (context->stackPtr[i] - prevStackMem);
+				}
+			}
+			freeToChunkedArray(s_stackBlocks[context->stackClass], prevStackMem);
+			task_updateStackBytes(-s32(c_stackClassSize[context->stackClass]));
+			s_stackRelocations++;
+		}
+		context->stackMem = stackMem;
+		context->stackClass = stackClass;
+	}
+
+	static void task_freeStack(TaskContext* context)
+	{
+		if (!context->stackMem) { return; }
+		freeToChunkedArray(s_stackBlocks[context->stackClass], context->stackMem);
+		task_updateStackBytes(-s32(c_stackClassSize[context->stackClass]));
+		context->stackMem = nullptr;
+	}
 
 	void createRootTask()
 	{
 		s_tasks = createChunkedArray(sizeof(Task), TASK_CHUNK_SIZE, TASK_PREALLOCATED_CHUNKS, s_gameRegion);
-		s_stackBlocks = createChunkedArray(TASK_STACK_SIZE, TASK_STACK_CHUNK_SIZE, TASK_PREALLOCATED_CHUNKS, s_gameRegion);
+		for (s32 i = 0; i < TASK_STACK_CLASS_COUNT; i++)
+		{
+			s_stackBlocks[i] = createChunkedArray(c_stackClassSize[i], c_stackClassChunk[i], TASK_PREALLOCATED_CHUNKS, s_gameRegion);
+		}
 
 		s_rootTask = { 0 };
 		s_rootTask.prev = &s_rootTask;
 		s_rootTask.next = &s_rootTask;
 		s_rootTask.nextTick = TASK_SLEEP;
+		s_rootTask.heapIndex = -1;
+		s_rootTask.order = -1;
 
 		s_taskIter = &s_rootTask;
 		s_curTask = &s_rootTask;
 		s_taskCount = 0;
 		s_frameActiveTaskCount = 0;
+		task_clearSchedule();
 
 		CVAR_BOOL(s_enableTimeLimiter, "d_enableTaskTimeLimiter", CVFLAG_DO_NOT_SERIALIZE, "Enable the task time limiter.");
 	}
@@ -143,13 +244,16 @@ namespace TFE_Jedi
 		newTask->retTask = nullptr;
 		newTask->userData = nullptr;
 		newTask->framebreak = JFALSE;
-		
-		newTask->nextTick = 0;
 
 		newTask->context = { 0 };
 		newTask->context.callstack[0] = func;
 		newTask->localRunFunc = localRunFunc;
 		newTask->context.level = TASK_INIT_LEVEL;
+
+		newTask->heapIndex = -1;
+		newTask->order = -1;
+		s_taskOrderDirty = JTRUE;
+		task_schedule(newTask, 0);
 		return newTask;
 	}
 
@@ -185,7 +289,11 @@ namespace TFE_Jedi
 		newTask->context.callstack[0] = func;
 		newTask->localRunFunc = localRunFunc;
 		newTask->context.level = TASK_INIT_LEVEL;
-		newTask->nextTick = s_curTick;
+
+		newTask->heapIndex = -1;
+		newTask->order = -1;
+		s_taskOrderDirty = JTRUE;
+		task_schedule(newTask, s_curTick);
 
 		return newTask;
 	}
@@ -195,14 +303,22 @@ namespace TFE_Jedi
 		SERIALIZE(SaveVersionInit, task->context.ip[0], 0);
 		SERIALIZE(SaveVersionInit, task->context.stackSize[0], 0);
 		SERIALIZE(SaveVersionInit, task->nextTick, 0);
+		if (serialization_getMode() == SMODE_READ)
+		{
+			task_schedule(task, task->nextTick);
+		}
 		if (serialization_getMode() == SMODE_READ && !task->context.stackMem)
 		{
-			task->context.stackMem = (u8*)allocFromChunkedArray(s_stackBlocks);
+			task_reserveStack(&task->context, task->context.stackSize[0]);
 			memset(task->context.stackMem, 0, sizeof(u32) * TASK_MAX_LEVELS);
 			task->context.stackOffset = 0;
 			task->context.stackPtr[0] = task->context.stackMem;
 		}
 		SERIALIZE(SaveVersionInit, task->context.stackOffset, 0);
+		if (serialization_getMode() == SMODE_READ)
+		{
+			task_reserveStack(&task->context, task->context.stackOffset);
+		}
 		if (localMemCallback)
 		{
 			localMemCallback(stream, userData, task->context.stackPtr[0]);
@@ -253,9 +369,12 @@ namespace TFE_Jedi
 		{
 			parent->subtaskNext = task->next;
 		}
-		
+		// Take the task out of the scheduler.
+		task_schedule(task, TASK_SLEEP);
+		s_taskOrderDirty = JTRUE;
+
 		// Free any memory allocated for the local context.
-		freeToChunkedArray(s_stackBlocks, task->context.stackMem);
+		task_freeStack(&task->context);
 		// Finally free the task itself from the chunked array.
 		freeToChunkedArray(s_tasks, task);
 		s_taskCount--;
@@ -267,11 +386,14 @@ namespace TFE_Jedi
 		s_rootTask.prev = &s_rootTask;
 		s_rootTask.next = &s_rootTask;
 		s_rootTask.nextTick = TASK_SLEEP;
+		s_rootTask.heapIndex = -1;
+		s_rootTask.order = -1;
 
 		s_taskIter = &s_rootTask;
 		s_curTask = &s_rootTask;
 		s_taskCount = 0;
 		s_frameActiveTaskCount = 0;
+		task_clearSchedule();
 
 		s_taskSystemPaused = JFALSE;
 		s_taskPauseTask = nullptr;
@@ -280,7 +402,13 @@ namespace TFE_Jedi
 	void task_freeAll()
 	{
 		chunkedArrayClear(s_tasks);
-		chunkedArrayClear(s_stackBlocks);
+		for (s32 i = 0; i < TASK_STACK_CLASS_COUNT; i++)
+		{
+			chunkedArrayClear(s_stackBlocks[i]);
+		}
+		s_stackBytes = 0;
+		s_stackKB = 0;
+		task_clearSchedule();
 
 		s_curTask    = nullptr;
 		s_curContext = nullptr;
@@ -290,14 +418,20 @@ namespace TFE_Jedi
 	void task_shutdown()
 	{
 		freeChunkedArray(s_tasks);
-		freeChunkedArray(s_stackBlocks);
+		for (s32 i = 0; i < TASK_STACK_CLASS_COUNT; i++)
+		{
+			freeChunkedArray(s_stackBlocks[i]);
+			s_stackBlocks[i] = nullptr;
+		}
+		s_stackBytes = 0;
+		s_stackKB = 0;
 
 		s_curTask     = nullptr;
 		s_taskIter    = nullptr;
 		s_tasks       = nullptr;
-		s_stackBlocks = nullptr;
 		s_curContext  = nullptr;
 		s_taskCount   = 0;
+		task_clearSchedule();
 
 		s_prevTime = 0.0;
 		s_minIntervalInSec = 0.0;
@@ -308,12 +442,12 @@ namespace TFE_Jedi
 
 	void task_makeActive(Task* task)
 	{
-		task->nextTick = 0;
+		task_schedule(task, 0);
 	}
 
 	void task_setNextTick(Task* task, Tick tick)
 	{
-		task->nextTick = tick;
+		task_schedule(task, tick);
 	}
 
 	void task_setUserData(Task* task, void* data)
@@ -386,58 +520,240 @@ namespace TFE_Jedi
 		{
 			// Return the stack memory allocated for this level.
 			s_curContext->stackOffset -= s_curContext->stackSize[level];
-			assert(s_curContext->stackOffset >= 0 && s_curContext->stackOffset < TASK_STACK_SIZE);
+			assert(s_curContext->stackOffset <= c_stackClassSize[s_curContext->stackClass]);
 			s_curContext->stackPtr[level] = nullptr;
 			s_curContext->stackSize[level] = 0;
 		}
 	}
 
-	void selectNextTask()
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// Scheduling
+	//////////////////////////////////////////////////////////////////////////////////////////
+	static void waitHeap_set(s32 index, Task* task)
 	{
-		// Find the next task to run.
-		Task* task = s_curTask;
+		s_waitHeap[index] = task;
+		task->heapIndex = index;
+	}
+
+	static void waitHeap_siftUp(s32 index)
+	{
+		Task* task = s_waitHeap[index];
+		while (index > 0)
+		{
+			const s32 parent = (index - 1) >> 1;
+			if (s_waitHeap[parent]->nextTick <= task->nextTick) { break; }
+			waitHeap_set(index, s_waitHeap[parent]);
+			index = parent;
+		}
+		waitHeap_set(index, task);
+	}
+
+	static void waitHeap_siftDown(s32 index)
+	{
+		const s32 count = (s32)s_waitHeap.size();
+		Task* task = s_waitHeap[index];
 		while (1)
 		{
-			//////////////////////////////////////////////////////////////////////////////////////////
-			// Execution:
-			//  * Go to the next task
-			//  * Check to see if there are sub-tasks
-			//  * If so, the assign current to the sub-task.
-			//  * Execute the task.
-			//  * Once we are on the last sub-task, then go back to the parent.
-			//  * Once the parent executes, then we move on to parent->next and start all over.
-			if (task->next)
+			s32 child = index * 2 + 1;
+			if (child >= count) { break; }
+			if (child + 1 < count && s_waitHeap[child + 1]->nextTick < s_waitHeap[child]->nextTick)
 			{
-				// Move the to the next task.
-				task = task->next;
-				// If the task has sub-tasks, loop until we find the last one.
-				// This is usually only one deep.
-				while (task->subtaskNext)
-				{
-					task = task->subtaskNext;
-				}
-				// Then execute the task.
-				if (task->nextTick <= s_curTick || task->framebreak)
-				{
-					s_currentMsg = MSG_RUN_TASK;
-					s_curTask = task;
-					return;
-				}
+				child++;
+			}
+			if (task->nextTick <= s_waitHeap[child]->nextTick) { break; }
+			waitHeap_set(index, s_waitHeap[child]);
+			index = child;
+		}
+		waitHeap_set(index, task);
+	}
+
+	static void waitHeap_push(Task* task)
+	{
+		s_waitHeap.push_back(task);
+		waitHeap_siftUp((s32)s_waitHeap.size() - 1);
+		s_waitingTaskCount = (s32)s_waitHeap.size();
+	}
+
+	static void waitHeap_remove(Task* task)
+	{
+		const s32 index = task->heapIndex;
+		Task* last = s_waitHeap.back();
+		s_waitHeap.pop_back();
+		task->heapIndex = -1;
+
+		// Move the last task into the hole and restore the heap property.
+		if (last != task)
+		{
+			waitHeap_set(index, last);
+			waitHeap_siftUp(index);
+			waitHeap_siftDown(last->heapIndex);
+		}
+		s_waitingTaskCount = (s32)s_waitHeap.size();
+	}
+
+	static void task_setReadyBit(Task* task, JBool ready)
+	{
+		// The bits are rebuilt from scratch if the order is dirty.
+		if (s_taskOrderDirty || task->order < 0) { return; }
+
+		const u32 mask = 1u << (task->order & 31);
+		if (ready) { s_readyBits[task->order >> 5] |= mask; }
+		else { s_readyBits[task->order >> 5] &= ~mask; }
+	}
+
+	// Returns the task that follows 'task' in execution order:
+	// sub-tasks execute before their parent, and the parent before the next main task.
+	static Task* task_getNextInOrder(Task* task)
+	{
+		if (task->next)
+		{
+			// Move the to the next task.
+			task = task->next;
+			// If the task has sub-tasks, loop until we find the last one.
+			// This is usually only one deep.
+			while (task->subtaskNext)
+			{
+				task = task->subtaskNext;
 			}
-			else if (task->subtaskParent)
+			return task;
+		}
+		// Otherwise go back to the parent.
+		return task->subtaskParent;
+	}
+
+	static void task_rebuildOrder()
+	{
+		s_taskOrder.clear();
+
+		// Walk the tasks once, starting after the root, until it comes back around to the root task.
+		Task* task = &s_rootTask;
+		do
+		{
+			task = task_getNextInOrder(task);
+			if (!task) { break; }
+
+			task->order = (s32)s_taskOrder.size();
+			s_taskOrder.push_back(task);
+		} while (task != &s_rootTask && (s32)s_taskOrder.size() <= s_taskCount);
+
+		const s32 count = (s32)s_taskOrder.size();
+		s_readyBits.assign((count + 31) >> 5, 0u);
+		s_taskOrderDirty = JFALSE;
+
+		for (s32 i = 0; i < count; i++)
+		{
+			task = s_taskOrder[i];
+			task_setReadyBit(task, task->ready || task->framebreak);
+		}
+	}
+
+	// Move tasks whose time has come from the wait heap to the ready set.
+	static void task_wakeWaiting()
+	{
+		while (!s_waitHeap.empty() && s_waitHeap[0]->nextTick <= s_curTick)
+		{
+			Task* task = s_waitHeap[0];
+			waitHeap_remove(task);
+			task->ready = JTRUE;
+			task_setReadyBit(task, JTRUE);
+		}
+	}
+
+	// Returns the first position in [start, end) with a ready bit set, or -1 if there are none.
+	static s32 task_findReady(s32 start, s32 end)
+	{
+		while (start < end)
+		{
+			u32 bits = s_readyBits[start >> 5] >> (start & 31);
+			if (!bits)
 			{
-				// Otherwise, try to execute the parent.
-				task = task->subtaskParent;
+				start = (start | 31) + 1;
+				continue;
+			}
+			while (!(bits & 1))
+			{
+				bits >>= 1;
+				start++;
+			}
+			return start < end ? start : -1;
+		}
+		return -1;
+	}
+
+	void task_schedule(Task* task, Tick tick)
+	{
+		task->nextTick = tick;
+		if (task->heapIndex >= 0)
+		{
+			waitHeap_remove(task);
+		}
+
+		// Sleeping tasks are not tracked until they are made active again.
+		task->ready = (tick <= s_curTick) ? JTRUE : JFALSE;
+		if (!task->ready && tick != TASK_SLEEP)
+		{
+			waitHeap_push(task);
+		}
+		// The framebreak task is always selected, even when it is not ready.
+		task_setReadyBit(task, task->ready || task->framebreak);
+	}
+
+	void task_clearSchedule()
+	{
+		s_waitHeap.clear();
+		s_taskOrder.clear();
+		s_readyBits.clear();
+		s_taskOrderDirty = JTRUE;
+		s_waitingTaskCount = 0;
+	}
+
+	void selectNextTask()
+	{
+		//////////////////////////////////////////////////////////////////////////////////////////
+		// Execution:
+		//  * Go to the next task
+		//  * Check to see if there are sub-tasks
+		//  * If so, the assign current to the sub-task.
+		//  * Execute the task.
+		//  * Once we are on the last sub-task, then go back to the parent.
+		//  * Once the parent executes, then we move on to parent->next and start all over.
+		// This order is cached in s_taskOrder, so only the tasks flagged as ready need to be visited.
+		if (s_taskOrderDirty)
+		{
+			task_rebuildOrder();
+		}
+		task_wakeWaiting();
+
+		const s32 count = (s32)s_taskOrder.size();
+		if (s_curTask && count)
+		{
+			// Search the tasks after the current task, then wrap around up to and including the current task.
+			const s32 curPos = (s_curTask->order >= 0 && s_curTask->order < count) ? s_curTask->order : count - 1;
+			s32 pos = curPos + 1;
+			s32 end = count;
+			JBool wrapped = JFALSE;
+			while (1)
+			{
+				pos = task_findReady(pos, end);
+				if (pos < 0)
+				{
+					if (wrapped) { break; }
+					wrapped = JTRUE;
+					pos = 0;
+					end = curPos + 1;
+					continue;
+				}
+
+				Task* task = s_taskOrder[pos];
 				if (task->nextTick <= s_curTick || task->framebreak)
 				{
 					s_currentMsg = MSG_RUN_TASK;
 					s_curTask = task;
 					return;
 				}
-			}
-			else
-			{
-				break;
+				// The current tick can move backwards when loading a save, so put the task back in the wait heap.
+				task_schedule(task, task->nextTick);
+				pos++;
 			}
 		}
 
@@ -507,7 +823,7 @@ namespace TFE_Jedi
 		}
 
 		// Update the current tick based on the delay.
-		s_curTask->nextTick = (delay < TASK_SLEEP) ? s_curTick + delay : delay;
+		task_schedule(s_curTask, (delay < TASK_SLEEP) ? s_curTick + delay : delay);
 		
 		// Find the next task to run.
 		selectNextTask();
@@ -628,6 +944,10 @@ namespace TFE_Jedi
 
 		TFE_COUNTER(s_taskCount, "Task Count");
 		TFE_COUNTER(s_frameActiveTaskCount, "Active Tasks");
+		TFE_COUNTER(s_waitingTaskCount, "Waiting Tasks");
+		TFE_COUNTER(s_stackKB, "Task Stack (KB)");
+		TFE_COUNTER(s_stackHighWaterKB, "Task Stack High Water (KB)");
+		TFE_COUNTER(s_stackRelocations, "Task Stack Relocations");
 	}
 
 	s32 task_getCount()
@@ -646,7 +966,6 @@ namespace TFE_Jedi
 		if (!size) { return; }
 		if (!s_curContext->stackMem)
 		{
-			s_curContext->stackMem = (u8*)allocFromChunkedArray(s_stackBlocks);
 			memset(s_curContext->stackSize, 0, sizeof(u32) * TASK_MAX_LEVELS);
 			s_curContext->stackOffset = 0;
 		}
@@ -654,10 +973,15 @@ namespace TFE_Jedi
 		s32 level = s_curContext->level;
 		if (!s_curContext->stackPtr[level])
 		{
+			task_reserveStack(s_curContext, s_curContext->stackOffset + size);
 			s_curContext->stackPtr[level] = s_curContext->stackMem + s_curContext->stackOffset;
 			s_curContext->stackSize[level] = size;
 			s_curContext->stackOffset += size;
-			assert(s_curContext->stackOffset >= 0 && s_curContext->stackOffset < TASK_STACK_SIZE);
+			assert(s_curContext->stackOffset <= c_stackClassSize[s_curContext->stackClass]);
+
+			// Record the high-water mark so later tasks with the same entry function start with a large enough stack.
+			u32& highWater = s_stackHighWater[s_curContext->callstack[0]];
+			highWater = max(highWater, s_curContext->stackOffset);
 
 			// Clear out the memory.
 			memset(s_curContext->stackPtr[level], 0, size);
@@ -0,0 +1,277 @@
+#include <cstring>
+#include <cstdlib>
+#include <cassert>
+#include <atomic>
+#include <new>
+#include <SDL_atomic.h>
+#include <TFE_System/system.h>
+#include <TFE_System/profiler.h>
+#include <TFE_FileSystem/filestream.h>
+#include "allocTracker.h"
+
+namespace TFE_Memory
+{
+	// Counters are plain zero-initialized statics so they are usable by operator new
+	// before any constructors run.
+	struct TagCounters
+	{
+		std::atomic<s64> liveBytes;
+		std::atomic<s64> liveCount;
+		std::atomic<s64> peakBytes;
+		std::atomic<u64> totalAllocs;
+		std::atomic<u32> frameAllocs;
+		std::atomic<u64> frameBytes;
+	};
+
+	static TagCounters s_counters[ALLOC_TAG_MAX];
+	static char s_tagName[ALLOC_TAG_MAX][32];
+	static AllocTag s_tagParent[ALLOC_TAG_MAX];
+	static u32 s_allocsLastFrame[ALLOC_TAG_MAX];
+	static u64 s_bytesLastFrame[ALLOC_TAG_MAX];
+	static std::atomic<u32> s_tagCount;
+	static SDL_SpinLock s_tagLock = 0;
+	static s64 s_totalPeak = 0;
+	static thread_local AllocTag s_heapTag = ALLOC_TAG_HEAP;
+
+	// Profiler counters.
+	static s32 s_allocsPerFrame = 0;
+	static s32 s_heapLiveKB = 0;
+
+	// Must be called with the tag lock held.
+	void allocTracker_init()
+	{
+		if (s_tagCount) { return; }
+		strcpy(s_tagName[ALLOC_TAG_HEAP], "Heap");
+		s_tagParent[ALLOC_TAG_HEAP] = ALLOC_TAG_NONE;
+		s_tagCount = 1;
+	}
+
+	AllocTag allocTracker_registerTag(const char* name, AllocTag parent)
+	{
+		SDL_AtomicLock(&s_tagLock);
+		allocTracker_init();
+
+		const u32 count = s_tagCount;
+		for (u32 i = 0; i < count; i++)
+		{
+			if (strncmp(s_tagName[i], name, sizeof(s_tagName[i]) - 1) == 0)
+			{
+				SDL_AtomicUnlock(&s_tagLock);
+				return i;
+			}
+		}
+		if (count >= ALLOC_TAG_MAX)
+		{
+			SDL_AtomicUnlock(&s_tagLock);
+			TFE_System::logWrite(LOG_WARNING, "AllocTracker", "Too many allocation tags, '%s' is tracked as heap memory.", name);
+			return ALLOC_TAG_HEAP;
+		}
+
+		strncpy(s_tagName[count], name, sizeof(s_tagName[count]) - 1);
+		s_tagParent[count] = parent < count ? parent : ALLOC_TAG_NONE;
+		s_tagCount = count + 1;
+		SDL_AtomicUnlock(&s_tagLock);
+		return count;
+	}
+
+	void allocTracker_alloc(AllocTag tag, u64 size, u32 count)
+	{
+		assert(tag < ALLOC_TAG_MAX);
+		TagCounters* counters = &s_counters[tag];
+		const s64 live = counters->liveBytes.fetch_add(s64(size), std::memory_order_relaxed) + s64(size);
+		counters->liveCount.fetch_add(count, std::memory_order_relaxed);
+		counters->totalAllocs.fetch_add(count, std::memory_order_relaxed);
+		counters->frameAllocs.fetch_add(count, std::memory_order_relaxed);
+		counters->frameBytes.fetch_add(size, std::memory_order_relaxed);
+
+		s64 peak = counters->peakBytes.load(std::memory_order_relaxed);
+		while (live > peak && !counters->peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed));
+	}
+
+	void allocTracker_free(AllocTag tag, u64 size, u32 count)
+	{
+		assert(tag < ALLOC_TAG_MAX);
+		TagCounters* counters = &s_counters[tag];
+		counters->liveBytes.fetch_sub(s64(size), std::memory_order_relaxed);
+		counters->liveCount.fetch_sub(count, std::memory_order_relaxed);
+	}
+
+	void allocTracker_clearTag(AllocTag tag)
+	{
+		if (tag >= s_tagCount) { return; }
+		s_counters[tag].liveBytes = 0;
+		s_counters[tag].liveCount = 0;
+
+		const u32 count = s_tagCount;
+		for (u32 i = 0; i < count; i++)
+		{
+			if (s_tagParent[i] == tag)
+			{
+				allocTracker_clearTag(i);
+			}
+		}
+	}
+
+	AllocTag allocTracker_setHeapTag(AllocTag tag)
+	{
+		const AllocTag prevTag = s_heapTag;
+		s_heapTag = tag < ALLOC_TAG_MAX ? tag : ALLOC_TAG_HEAP;
+		return prevTag;
+	}
+
+	void allocTracker_beginFrame()
+	{
+		// Tags may be registered during static initialization, so the counters are added on the first frame instead.
+		if (s_tagCount < 1)
+		{
+			SDL_AtomicLock(&s_tagLock);
+			allocTracker_init();
+			SDL_AtomicUnlock(&s_tagLock);
+		}
+		static bool s_countersAdded = false;
+		if (!s_countersAdded)
+		{
+			TFE_COUNTER(s_allocsPerFrame, "Allocations / Frame");
+			TFE_COUNTER(s_heapLiveKB, "Tracked Live Memory (KB)");
+			s_countersAdded = true;
+		}
+
+		const u32 count = s_tagCount;
+		u32 allocs = 0;
+		s64 live = 0;
+		for (u32 i = 0; i < count; i++)
+		{
+			s_allocsLastFrame[i] = s_counters[i].frameAllocs.exchange(0, std::memory_order_relaxed);
+			s_bytesLastFrame[i] = s_counters[i].frameBytes.exchange(0, std::memory_order_relaxed);
+			if (s_tagParent[i] == ALLOC_TAG_NONE)
+			{
+				allocs += s_allocsLastFrame[i];
+				live += s_counters[i].liveBytes.load(std::memory_order_relaxed);
+			}
+		}
+		if (live > s_totalPeak) { s_totalPeak = live; }
+
+		s_allocsPerFrame = s32(allocs);
+		s_heapLiveKB = s32(live >> 10);
+	}
+
+	u32 allocTracker_getTagCount()
+	{
+		return s_tagCount;
+	}
+
+	bool allocTracker_getTagStats(AllocTag tag, AllocTagStats* stats)
+	{
+		if (tag >= s_tagCount) { return false; }
+
+		const TagCounters* counters = &s_counters[tag];
+		stats->name = s_tagName[tag];
+		stats->parent = s_tagParent[tag];
+		stats->liveBytes = counters->liveBytes.load(std::memory_order_relaxed);
+		stats->liveCount = counters->liveCount.load(std::memory_order_relaxed);
+		stats->peakBytes = counters->peakBytes.load(std::memory_order_relaxed);
+		stats->totalAllocs = counters->totalAllocs.load(std::memory_order_relaxed);
+		stats->allocsLastFrame = s_allocsLastFrame[tag];
+		stats->bytesLastFrame = s_bytesLastFrame[tag];
+		return true;
+	}
+
+	void allocTracker_getTotals(AllocTotals* totals)
+	{
+		memset(totals, 0, sizeof(AllocTotals));
+		const u32 count = s_tagCount;
+		for (u32 i = 0; i < count; i++)
+		{
+			if (s_tagParent[i] != ALLOC_TAG_NONE) { continue; }
+			totals->liveBytes += s_counters[i].liveBytes.load(std::memory_order_relaxed);
+			totals->allocsLastFrame += s_allocsLastFrame[i];
+			totals->bytesLastFrame += s_bytesLastFrame[i];
+		}
+		totals->peakBytes = s_totalPeak;
+	}
+
+	bool allocTracker_writeCsv(const char* path)
+	{
+		FileStream file;
+		if (!file.open(path, Stream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_ERROR, "AllocTracker", "Cannot open '%s' for writing.", path);
+			return false;
+		}
+
+		file.writeString("Tag,Parent,Live Bytes,Live Count,Peak Bytes,Total Allocs,Allocs Last Frame,Bytes Last Frame\n");
+		const u32 count = allocTracker_getTagCount();
+		for (u32 i = 0; i < count; i++)
+		{
+			AllocTagStats stats;
+			allocTracker_getTagStats(i, &stats);
+			file.writeString("%s,%s,%lld,%lld,%lld,%llu,%u,%llu\n", stats.name, stats.parent != ALLOC_TAG_NONE ? s_tagName[stats.parent] : "",
+				(long long)stats.liveBytes, (long long)stats.liveCount, (long long)stats.peakBytes, (unsigned long long)stats.totalAllocs,
+				stats.allocsLastFrame, (unsigned long long)stats.bytesLastFrame);
+		}
+		file.close();
+
+		TFE_System::logWrite(LOG_MSG, "AllocTracker", "Wrote allocation stats for %u tags to '%s'.", count, path);
+		return true;
+	}
+}
+
+#ifdef TFE_ALLOC_TRACKING
+//////////////////////////////////////////////////////////////////////
+// Global operator new/delete replacements.
+// Each allocation is prefixed with a small header holding the size
+// and tag, so frees are attributed to the tag that allocated them.
+//////////////////////////////////////////////////////////////////////
+namespace
+{
+	struct HeapHeader
+	{
+		u64 size;
+		u32 tag;
+		u32 pad;
+	};
+	static_assert(sizeof(HeapHeader) == 16, "HeapHeader must preserve the default new alignment.");
+
+	void* trackedAlloc(size_t size)
+	{
+		HeapHeader* header = (HeapHeader*)malloc(sizeof(HeapHeader) + size);
+		if (!header) { return nullptr; }
+
+		header->size = size;
+		header->tag = TFE_Memory::s_heapTag;
+		TFE_Memory::allocTracker_alloc(header->tag, size);
+		return header + 1;
+	}
+
+	void trackedFree(void* ptr)
+	{
+		if (!ptr) { return; }
+		HeapHeader* header = (HeapHeader*)ptr - 1;
+		TFE_Memory::allocTracker_free(header->tag, header->size);
+		free(header);
+	}
+}
+
+void* operator new(size_t size)
+{
+	void* ptr = trackedAlloc(size);
+	if (!ptr) { throw std::bad_alloc(); }
+	return ptr;
+}
+
+void* operator new[](size_t size)
+{
+	void* ptr = trackedAlloc(size);
+	if (!ptr) { throw std::bad_alloc(); }
+	return ptr;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return trackedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return trackedAlloc(size); }
+void operator delete(void* ptr) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { trackedFree(ptr); }
+#endif
@@ -0,0 +1,93 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Tagged allocation tracker.
+// Keeps live/peak/per-frame counters for each allocation tag.
+// Add TFE_ALLOC_TRACKING to preprocessor defines in the build to enable,
+// it replaces the global operator new/delete which adds a header and
+// counter updates to every heap allocation.
+//
+// Tags come in two kinds:
+// * Root tags own their memory: the global heap (operator new) and
+//   memory regions. Heap allocations are attributed to the tag set by
+//   the innermost TFE_ALLOC_SCOPE() on the calling thread.
+// * Child tags track sub-allocations made from memory owned by their
+//   parent (e.g. JEDI Allocator items in a region), so they are not
+//   included in the totals. Clearing a tag also clears its children.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+#define ALLOC_TOKENPASTE(x, y) x ## y
+#define ALLOC_TOKENPASTE2(x, y) ALLOC_TOKENPASTE(x, y)
+#ifdef TFE_ALLOC_TRACKING
+#define TFE_ALLOC_SCOPE(tag) TFE_Memory::AllocTagScope ALLOC_TOKENPASTE2(__allocScope, __LINE__)(tag)
+#define TFE_TRACK_ALLOC(tag, ...) TFE_Memory::allocTracker_alloc(tag, __VA_ARGS__)
+#define TFE_TRACK_FREE(tag, ...) TFE_Memory::allocTracker_free(tag, __VA_ARGS__)
+#else
+#define TFE_ALLOC_SCOPE(tag) (void)(tag)
+#define TFE_TRACK_ALLOC(tag, ...)
+#define TFE_TRACK_FREE(tag, ...)
+#endif
+
+namespace TFE_Memory
+{
+	typedef u32 AllocTag;
+
+	enum AllocTagConst : u32
+	{
+		ALLOC_TAG_HEAP = 0,		// Untagged heap allocations.
+		ALLOC_TAG_MAX = 128,
+		ALLOC_TAG_NONE = 0xffffffff,
+	};
+
+	struct AllocTagStats
+	{
+		const char* name;
+		AllocTag parent;		// ALLOC_TAG_NONE for root tags.
+		s64 liveBytes;
+		s64 liveCount;
+		s64 peakBytes;
+		u64 totalAllocs;
+		u32 allocsLastFrame;
+		u64 bytesLastFrame;
+	};
+
+	struct AllocTotals
+	{
+		s64 liveBytes;
+		s64 peakBytes;			// Peak of the sum of live bytes, sampled once per frame.
+		u32 allocsLastFrame;
+		u64 bytesLastFrame;
+	};
+
+	// Returns the existing tag if one with the same name was already registered.
+	AllocTag allocTracker_registerTag(const char* name, AllocTag parent = ALLOC_TAG_NONE);
+
+	void allocTracker_alloc(AllocTag tag, u64 size, u32 count = 1);
+	void allocTracker_free(AllocTag tag, u64 size, u32 count = 1);
+	// Drop all live allocations from a tag and its children, used when memory is released in bulk.
+	void allocTracker_clearTag(AllocTag tag);
+
+	// Set the tag used for heap allocations on the calling thread, returns the previous tag.
+	AllocTag allocTracker_setHeapTag(AllocTag tag);
+
+	// Latch the per-frame counters, called once per frame by the main loop.
+	void allocTracker_beginFrame();
+
+	u32  allocTracker_getTagCount();
+	bool allocTracker_getTagStats(AllocTag tag, AllocTagStats* stats);
+	void allocTracker_getTotals(AllocTotals* totals);
+	bool allocTracker_writeCsv(const char* path);
+
+	class AllocTagScope
+	{
+	public:
+		AllocTagScope(AllocTag tag) : m_prevTag(allocTracker_setHeapTag(tag)) {}
+		~AllocTagScope() { allocTracker_setHeapTag(m_prevTag); }
+
+		AllocTagScope(const AllocTagScope&) = delete;
+		AllocTagScope& operator=(const AllocTagScope&) = delete;
+
+	private:
+		AllocTag m_prevTag;
+	};
+}
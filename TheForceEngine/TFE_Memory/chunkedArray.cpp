@@ -8,6 +8,9 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 // Uncomment the following line to verify memory on free.
 #ifdef _DEBUG
@@ -25,8 +28,14 @@ struct ChunkedArray
 	u32 freeSlotCount;
 	u32 freeSlotCapacity;
 
+	u32 wordsPerChunk;	// number of live bitmap words per chunk.
+	u32 slotCapacity;	// number of slots with live bits and generations, only grows so generations survive compaction.
+
 	u8** chunks;
-	u8** freeSlots;
+	u32* chunkOrder;	// Chunk indices sorted by address, so a pointer can be mapped to its chunk with a binary search.
+	u32* freeSlots;		// Indices of free elements, the next allocation is taken from the end.
+	u32* liveBits;		// Live element bitmap, 'wordsPerChunk' words per chunk.
+	u32* generations;	// Incremented every time an element is freed.
 	MemoryRegion* region;
 };
 
@@ -36,58 +45,78 @@ namespace TFE_Memory
 	{
 		FREE_SLOT_STEP = 32,
 	};
-	void addFreeSlot(ChunkedArray* arr, u8* ptr);
+	void addFreeSlot(ChunkedArray* arr, u32 index);
+	void reserveSlots(ChunkedArray* arr, u32 chunkCount);
+	void updateChunkOrder(ChunkedArray* arr);
+
+	// Index of the lowest set bit, 'x' must not be zero.
+	static inline u32 bitScanForward(u32 x)
+	{
+	#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, x);
+		return u32(index);
+	#else
+		return u32(__builtin_ctz(x));
+	#endif
+	}
+
+	static inline u32* getLiveWord(ChunkedArray* arr, u32 index)
+	{
+		const u32 chunkId = index / arr->elemPerChunk;
+		const u32 elemId = index - chunkId * arr->elemPerChunk;
+		return &arr->liveBits[chunkId * arr->wordsPerChunk + (elemId >> 5)];
+	}
+
+	static inline u32 getLiveMask(ChunkedArray* arr, u32 index)
+	{
+		return 1u << ((index % arr->elemPerChunk) & 31);
+	}
 
 	void serialize(ChunkedArray* arr, FileStream* file)
 	{
 		assert(file);
-		size_t size = size_t(&arr->chunks) - sizeof(arr);
-		file->writeBuffer(arr, (u32)size);
+		file->write(&arr->elemSize);
+		file->write(&arr->elemPerChunk);
+		file->write(&arr->elemCount);
+		file->write(&arr->chunkCount);
+		file->write(&arr->freeSlotCount);
 
 		const u32 chunkAllocSize = arr->elemPerChunk * arr->elemSize;
 		for (u32 i = 0; i < arr->chunkCount; i++)
 		{
 			file->write(arr->chunks[i], chunkAllocSize);
 		}
-
-		for (u32 i = 0; i < arr->freeSlotCount; i++)
-		{
-			s32 freeSlotIndex = getSlotIndex(arr, arr->freeSlots[i]);
-			file->write(&freeSlotIndex);
-		}
+		file->write(arr->liveBits, arr->chunkCount * arr->wordsPerChunk);
+		file->write(arr->generations, arr->chunkCount * arr->elemPerChunk);
+		file->write(arr->freeSlots, arr->freeSlotCount);
 	}
 
 	ChunkedArray* restore(FileStream* file, MemoryRegion* region)
 	{
 		assert(file && region);
-		ChunkedArray* arr = (ChunkedArray*)region_alloc(region, sizeof(ChunkedArray));
-		memset(arr, 0, sizeof(ChunkedArray));
+		u32 elemSize, elemPerChunk, elemCount, chunkCount, freeSlotCount;
+		file->read(&elemSize);
+		file->read(&elemPerChunk);
+		file->read(&elemCount);
+		file->read(&chunkCount);
+		file->read(&freeSlotCount);
 
-		size_t size = size_t(&arr->chunks) - sizeof(arr);
-		file->readBuffer(arr, (u32)size);
+		ChunkedArray* arr = createChunkedArray(elemSize, elemPerChunk, chunkCount, region);
+		arr->elemCount = elemCount;
 
-		arr->chunks = (u8**)region_realloc(region, arr->chunks, sizeof(u8*) * arr->chunkCount);
 		const u32 chunkAllocSize = arr->elemPerChunk * arr->elemSize;
 		for (u32 i = 0; i < arr->chunkCount; i++)
 		{
-			arr->chunks[i] = (u8*)region_alloc(region, chunkAllocSize);
 			file->read(arr->chunks[i], chunkAllocSize);
 		}
+		file->read(arr->liveBits, arr->chunkCount * arr->wordsPerChunk);
+		file->read(arr->generations, arr->chunkCount * arr->elemPerChunk);
 
-		arr->freeSlots = (u8**)region_realloc(region, arr->freeSlots, sizeof(u8**) * arr->freeSlotCapacity);
-		for (u32 i = 0; i < arr->freeSlotCount; i++)
-		{
-			s32 freeSlotIndex;
-			file->read(&freeSlotIndex);
-			if (freeSlotIndex >= 0)
-			{
-				arr->freeSlots[i] = arr->chunks[freeSlotIndex];
-			}
-			else
-			{
-				arr->freeSlots[i] = nullptr;
-			}
-		}
+		arr->freeSlotCapacity = freeSlotCount + FREE_SLOT_STEP;
+		arr->freeSlots = (u32*)region_realloc(region, arr->freeSlots, sizeof(u32) * arr->freeSlotCapacity);
+		arr->freeSlotCount = freeSlotCount;
+		file->read(arr->freeSlots, freeSlotCount);
 		return arr;
 	}
 
@@ -95,15 +124,16 @@ namespace TFE_Memory
 	{
 		ChunkedArray* arr = (ChunkedArray*)region_alloc(region, sizeof(ChunkedArray));
 		memset(arr, 0, sizeof(ChunkedArray));
-		
+
 		arr->region = region;
 		arr->elemSize = elemSize;
 		arr->elemCount = 0;
-				
+
 		arr->elemPerChunk = elemPerChunk;
+		arr->wordsPerChunk = (elemPerChunk + 31) >> 5;
 		arr->chunkCount = initChunkCount;
 		arr->chunks = (u8**)region_realloc(region, arr->chunks, sizeof(u8*) * initChunkCount);
-		
+
 		arr->freeSlotCount = 0;
 		arr->freeSlotCapacity = 0;
 		arr->freeSlots = nullptr;
@@ -113,6 +143,8 @@ namespace TFE_Memory
 		{
 			arr->chunks[i] = (u8*)region_alloc(region, chunkAllocSize);
 		}
+		reserveSlots(arr, initChunkCount);
+		updateChunkOrder(arr);
 
 		return arr;
 	}
@@ -126,7 +158,10 @@ namespace TFE_Memory
 			region_free(arr->region, arr->chunks[i]);
 		}
 		region_free(arr->region, arr->chunks);
+		region_free(arr->region, arr->chunkOrder);
 		region_free(arr->region, arr->freeSlots);
+		region_free(arr->region, arr->liveBits);
+		region_free(arr->region, arr->generations);
 		region_free(arr->region, arr);
 	}
 
@@ -135,7 +170,9 @@ namespace TFE_Memory
 		if (arr->freeSlotCount)
 		{
 			arr->freeSlotCount--;
-			return arr->freeSlots[arr->freeSlotCount];
+			const u32 index = arr->freeSlots[arr->freeSlotCount];
+			*getLiveWord(arr, index) |= getLiveMask(arr, index);
+			return chunkedArrayGet(arr, index);
 		}
 		s32 elementIndex = arr->elemCount;
 		arr->elemCount++;
@@ -152,44 +189,46 @@ namespace TFE_Memory
 				arr->chunks[i] = (u8*)region_alloc(arr->region, chunkAllocSize);
 			}
 			arr->chunkCount = newChunkCount;
+			reserveSlots(arr, newChunkCount);
+			updateChunkOrder(arr);
 		}
 
 		const u32 index = elementIndex - newChunkIndex*arr->elemPerChunk;
 		assert(index < arr->elemPerChunk);
+		*getLiveWord(arr, elementIndex) |= getLiveMask(arr, elementIndex);
 		return arr->chunks[newChunkIndex] + index*arr->elemSize;
 	}
-		
+
 	void freeToChunkedArray(ChunkedArray* arr, void* ptr)
 	{
 		if (!arr || !ptr) { return; }
-		
+
+		const s32 index = getSlotIndex(arr, (u8*)ptr);
+		assert(index >= 0);
+		if (index < 0) { return; }
+
+		u32* liveWord = getLiveWord(arr, index);
+		const u32 mask = getLiveMask(arr, index);
 #ifdef _VERIFY_CHUNKED_ARR_FREE
-		// First verify that the memory is contained within the chunked array.
-		for (s32 i = arr->chunkCount - 1; i >= 0; i--)
-		{
-			if (ptr >= arr->chunks[i])
-			{
-				assert(ptr < arr->chunks[i] + arr->elemPerChunk * arr->elemSize);
-				// Then find the index.
-				u32 index = u32((u8*)ptr - arr->chunks[i]) / arr->elemSize;
-				assert(index < arr->elemPerChunk);
-				break;
-			}
-		}
-		// Then verify that it hasn't already been freed.
-		for (u32 i = 0; i < arr->freeSlotCount; i++)
-		{
-			assert(arr->freeSlots[i] != ptr);
-		}
+		// Verify that it hasn't already been freed.
+		assert(*liveWord & mask);
 #endif
-
-		addFreeSlot(arr, (u8*)ptr);
+		*liveWord &= ~mask;
+		arr->generations[index]++;
+		addFreeSlot(arr, index);
 	}
 
 	void chunkedArrayClear(ChunkedArray* arr)
 	{
 		if (!arr) { return; }
 
+		// Invalidate any outstanding handles.
+		for (u32 i = 0; i < arr->elemCount; i++)
+		{
+			if (chunkedArrayIsLive(arr, i)) { arr->generations[i]++; }
+		}
+		memset(arr->liveBits, 0, sizeof(u32) * arr->chunkCount * arr->wordsPerChunk);
+
 		arr->elemCount = 0;
 		arr->freeSlotCount = 0;
 		for (u32 i = 0; i < arr->chunkCount; i++)
@@ -198,6 +237,40 @@ namespace TFE_Memory
 		}
 	}
 
+	void chunkedArrayCompact(ChunkedArray* arr)
+	{
+		if (!arr) { return; }
+
+		// Trim free elements from the end.
+		while (arr->elemCount && !chunkedArrayIsLive(arr, arr->elemCount - 1))
+		{
+			arr->elemCount--;
+		}
+
+		// Release chunks past the end, but keep at least one.
+		const u32 usedChunkCount = std::max(1u, (arr->elemCount + arr->elemPerChunk - 1) / arr->elemPerChunk);
+		for (u32 i = usedChunkCount; i < arr->chunkCount; i++)
+		{
+			region_free(arr->region, arr->chunks[i]);
+			arr->chunks[i] = nullptr;
+		}
+		if (usedChunkCount < arr->chunkCount)
+		{
+			arr->chunkCount = usedChunkCount;
+			updateChunkOrder(arr);
+		}
+
+		// Rebuild the free list from the bitmap, highest index first so the lowest free slots are reused first.
+		arr->freeSlotCount = 0;
+		for (s32 i = s32(arr->elemCount) - 1; i >= 0; i--)
+		{
+			if (!chunkedArrayIsLive(arr, i))
+			{
+				addFreeSlot(arr, i);
+			}
+		}
+	}
+
 	u32 chunkedArraySize(ChunkedArray* arr)
 	{
 		if (!arr) { return 0; }
@@ -220,26 +293,116 @@ namespace TFE_Memory
 		return arr->chunks[chunkId] + elemId*arr->elemSize;
 	}
 
-	void addFreeSlot(ChunkedArray* arr, u8* ptr)
+	bool chunkedArrayIsLive(ChunkedArray* arr, u32 index)
+	{
+		if (!arr || index >= arr->elemCount) { return false; }
+		return (*getLiveWord(arr, index) & getLiveMask(arr, index)) != 0;
+	}
+
+	void* chunkedArrayIterate(ChunkedArray* arr, u32* iter)
+	{
+		if (!arr) { return nullptr; }
+
+		u32 index = *iter;
+		while (index < arr->elemCount)
+		{
+			const u32 chunkId = index / arr->elemPerChunk;
+			const u32 elemId = index - chunkId * arr->elemPerChunk;
+			const u32 word = arr->liveBits[chunkId * arr->wordsPerChunk + (elemId >> 5)] & (~0u << (elemId & 31));
+			if (word)
+			{
+				index += bitScanForward(word) - (elemId & 31);
+				if (index >= arr->elemCount) { break; }
+
+				*iter = index + 1;
+				return chunkedArrayGet(arr, index);
+			}
+			// Skip to the next word, or the next chunk if this was the last word in the chunk.
+			const u32 nextElem = (elemId | 31) + 1;
+			index = chunkId * arr->elemPerChunk + std::min(nextElem, arr->elemPerChunk);
+		}
+		*iter = arr->elemCount;
+		return nullptr;
+	}
+
+	ChunkedArrayHandle chunkedArrayGetHandle(ChunkedArray* arr, void* ptr)
+	{
+		const s32 index = getSlotIndex(arr, (u8*)ptr);
+		if (index < 0) { return { ~0u, 0 }; }
+		return { u32(index), arr->generations[index] };
+	}
+
+	void* chunkedArrayResolve(ChunkedArray* arr, ChunkedArrayHandle handle)
+	{
+		if (!chunkedArrayIsLive(arr, handle.index) || arr->generations[handle.index] != handle.generation)
+		{
+			return nullptr;
+		}
+		return chunkedArrayGet(arr, handle.index);
+	}
+
+	void addFreeSlot(ChunkedArray* arr, u32 index)
 	{
 		if (arr->freeSlotCount + 1 >= arr->freeSlotCapacity)
 		{
 			arr->freeSlotCapacity += FREE_SLOT_STEP;
-			arr->freeSlots = (u8**)region_realloc(arr->region, arr->freeSlots, sizeof(u8*) * arr->freeSlotCapacity);
+			arr->freeSlots = (u32*)region_realloc(arr->region, arr->freeSlots, sizeof(u32) * arr->freeSlotCapacity);
 		}
-		arr->freeSlots[arr->freeSlotCount] = ptr;
+		arr->freeSlots[arr->freeSlotCount] = index;
 		arr->freeSlotCount++;
 	}
 
+	// Make sure the live bitmap and generations cover 'chunkCount' chunks.
+	void reserveSlots(ChunkedArray* arr, u32 chunkCount)
+	{
+		const u32 slotCount = chunkCount * arr->elemPerChunk;
+		if (slotCount <= arr->slotCapacity) { return; }
+
+		const u32 prevChunkCount = arr->slotCapacity / arr->elemPerChunk;
+		arr->liveBits = (u32*)region_realloc(arr->region, arr->liveBits, sizeof(u32) * chunkCount * arr->wordsPerChunk);
+		arr->generations = (u32*)region_realloc(arr->region, arr->generations, sizeof(u32) * slotCount);
+		memset(arr->liveBits + prevChunkCount * arr->wordsPerChunk, 0, sizeof(u32) * (chunkCount - prevChunkCount) * arr->wordsPerChunk);
+		memset(arr->generations + arr->slotCapacity, 0, sizeof(u32) * (slotCount - arr->slotCapacity));
+		arr->slotCapacity = slotCount;
+	}
+
+	// Sort the chunk indices by address, called whenever chunks are added or released.
+	void updateChunkOrder(ChunkedArray* arr)
+	{
+		arr->chunkOrder = (u32*)region_realloc(arr->region, arr->chunkOrder, sizeof(u32) * std::max(arr->chunkCount, 1u));
+		for (u32 i = 0; i < arr->chunkCount; i++)
+		{
+			arr->chunkOrder[i] = i;
+		}
+		u8** chunks = arr->chunks;
+		std::sort(arr->chunkOrder, arr->chunkOrder + arr->chunkCount, [chunks](u32 a, u32 b) { return chunks[a] < chunks[b]; });
+	}
+
 	s32 getSlotIndex(ChunkedArray* arr, u8* ptr)
 	{
-		for (s32 i = 0; i < (s32)arr->chunkCount; i++)
+		// Find the last chunk that starts at or before 'ptr', then make sure 'ptr' is inside of it.
+		s32 lo = 0, hi = s32(arr->chunkCount) - 1, found = -1;
+		while (lo <= hi)
 		{
-			if (arr->chunks[i] == ptr)
+			const s32 mid = (lo + hi) >> 1;
+			if (arr->chunks[arr->chunkOrder[mid]] <= ptr)
 			{
-				return i;
+				found = mid;
+				lo = mid + 1;
 			}
+			else
+			{
+				hi = mid - 1;
+			}
+		}
+		if (found < 0) { return -1; }
+
+		const u32 chunkId = arr->chunkOrder[found];
+		const u32 offset = u32(ptr - arr->chunks[chunkId]);
+		if (offset >= arr->elemPerChunk * arr->elemSize || (offset % arr->elemSize) != 0)
+		{
+			return -1;
 		}
-		return -1;
+		return s32(chunkId * arr->elemPerChunk + offset / arr->elemSize);
 	}
 }
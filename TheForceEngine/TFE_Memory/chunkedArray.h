@@ -1,6 +1,10 @@
 #pragma once
 //////////////////////////////////////////////////////////////////////
 // Chunked array allocator
+// Elements never move once allocated, so pointers stay valid until
+// the element is freed. Each chunk keeps a bitmap of live elements,
+// which allows iterating without visiting free slots, and a
+// generation per slot, which allows handles to detect reuse.
 //////////////////////////////////////////////////////////////////////
 #include <TFE_System/types.h>
 #include <TFE_FileSystem/filestream.h>
@@ -12,11 +16,22 @@ struct MemoryRegion;
 
 namespace TFE_Memory
 {
+	// Stable reference to an element, resolves to null once the element is freed (even if the slot is reused).
+	struct ChunkedArrayHandle
+	{
+		u32 index;
+		u32 generation;
+	};
+
 	ChunkedArray* createChunkedArray(u32 elemSize, u32 elemPerChunk, u32 initChunkCount, MemoryRegion* region);
 	// Free everything.
 	void freeChunkedArray(ChunkedArray* arr);
 	// Empty the array but do not free the memory.
 	void chunkedArrayClear(ChunkedArray* arr);
+	// Trim free elements from the end of the array, release the chunks that are no longer used and
+	// reorder the free list so the lowest free slots are reused first. Live elements are not moved,
+	// so pointers and handles remain valid.
+	void chunkedArrayCompact(ChunkedArray* arr);
 
 	void* allocFromChunkedArray(ChunkedArray* arr);
 	void freeToChunkedArray(ChunkedArray* arr, void* ptr);
@@ -24,9 +39,30 @@ namespace TFE_Memory
 	u32 chunkedArraySize(ChunkedArray* arr);
 	u32 chunkedArrayCount(ChunkedArray* arr);
 	void* chunkedArrayGet(ChunkedArray* arr, u32 index);
+	bool chunkedArrayIsLive(ChunkedArray* arr, u32 index);
+
+	// Returns the next live element at or after '*iter' and advances '*iter' past it, or null when done.
+	// Start with '*iter' = 0.
+	void* chunkedArrayIterate(ChunkedArray* arr, u32* iter);
+
+	ChunkedArrayHandle chunkedArrayGetHandle(ChunkedArray* arr, void* ptr);
+	void* chunkedArrayResolve(ChunkedArray* arr, ChunkedArrayHandle handle);
 
 	void serialize(ChunkedArray* arr, FileStream* file);
 	ChunkedArray* restore(FileStream* file, MemoryRegion* region);
 
+	// Returns the element index of 'ptr' or -1 if it is not part of the array.
 	s32 getSlotIndex(ChunkedArray* arr, u8* ptr);
-}
\ No newline at end of file
+
+	// Calls func(T*) for each live element in index order.
+	// Elements may be freed during iteration, elements allocated during iteration may or may not be visited.
+	template <typename T, typename Func>
+	void chunkedArrayForEach(ChunkedArray* arr, Func func)
+	{
+		u32 iter = 0;
+		while (void* elem = chunkedArrayIterate(arr, &iter))
+		{
+			func((T*)elem);
+		}
+	}
+}
@@ -0,0 +1,268 @@
+#include <cstring>
+#include <cstdlib>
+#include <cassert>
+#include <cstdio>
+#include <vector>
+#include <SDL_atomic.h>
+#include <TFE_System/system.h>
+#include <TFE_System/profiler.h>
+#include "frameArena.h"
+
+#define FRAME_ARENA_INITIAL_SIZE (256u * 1024u)
+#define FRAME_ARENA_MIN_CHUNK (64u * 1024u)
+
+namespace TFE_Memory
+{
+	enum
+	{
+		FRAME_ARENA_BUFFER_COUNT = 2,
+	};
+
+	// Overflow chunks are linked from newest to oldest, the data follows the header.
+	struct ArenaChunk
+	{
+		ArenaChunk* prev;
+		u64 size;
+		u64 pad[2];
+	};
+
+	struct ArenaBuffer
+	{
+		u8* base;
+		u64 capacity;
+		u64 offset;			// Offset into the current chunk, or the base buffer if 'chunk' is null.
+		ArenaChunk* chunk;	// Current overflow chunk.
+		u64 used;			// Total bytes used, including overflow chunks and alignment padding.
+		u64 highWater;		// Largest 'used' since the last reset.
+	};
+}
+
+struct FrameArena
+{
+	char name[32];
+	TFE_Memory::ArenaBuffer buffers[TFE_Memory::FRAME_ARENA_BUFFER_COUNT];
+	u64 frameHighWater;
+	u64 highWater;
+	u32 overflowCount;
+};
+
+namespace TFE_Memory
+{
+	static thread_local FrameArena* s_threadArena = nullptr;
+	static std::vector<FrameArena*> s_arenas;
+	static SDL_SpinLock s_arenaLock = 0;
+	static u32 s_curBuffer = 0;
+
+	// Profiler counters (in KB).
+	static s32 s_frameArenaUsedKB = 0;
+	static s32 s_frameArenaHighWaterKB = 0;
+	static s32 s_frameArenaOverflows = 0;
+
+	void buffer_freeChunks(ArenaBuffer* buffer, ArenaChunk* stop)
+	{
+		ArenaChunk* chunk = buffer->chunk;
+		while (chunk != stop)
+		{
+			ArenaChunk* prev = chunk->prev;
+			free(chunk);
+			chunk = prev;
+		}
+		buffer->chunk = stop;
+	}
+
+	void buffer_reset(ArenaBuffer* buffer)
+	{
+		buffer_freeChunks(buffer, nullptr);
+		// Grow to fit the largest frame seen so far, so the next frame does not overflow.
+		if (buffer->highWater > buffer->capacity)
+		{
+			u64 newCapacity = buffer->capacity ? buffer->capacity : FRAME_ARENA_INITIAL_SIZE;
+			while (newCapacity < buffer->highWater) { newCapacity <<= 1; }
+
+			free(buffer->base);
+			buffer->base = (u8*)malloc(newCapacity);
+			buffer->capacity = buffer->base ? newCapacity : 0;
+		}
+		buffer->offset = 0;
+		buffer->used = 0;
+		buffer->highWater = 0;
+	}
+
+	FrameArena* arena_create()
+	{
+		FrameArena* arena = (FrameArena*)malloc(sizeof(FrameArena));
+		memset(arena, 0, sizeof(FrameArena));
+		for (s32 i = 0; i < FRAME_ARENA_BUFFER_COUNT; i++)
+		{
+			arena->buffers[i].highWater = FRAME_ARENA_INITIAL_SIZE;
+			buffer_reset(&arena->buffers[i]);
+		}
+
+		SDL_AtomicLock(&s_arenaLock);
+		if (s_arenas.empty())
+		{
+			// The first arena is created by the main loop.
+			strcpy(arena->name, "Main");
+			TFE_COUNTER(s_frameArenaUsedKB, "Frame Arena Used (KB)");
+			TFE_COUNTER(s_frameArenaHighWaterKB, "Frame Arena High Water (KB)");
+			TFE_COUNTER(s_frameArenaOverflows, "Frame Arena Overflows");
+		}
+		else
+		{
+			snprintf(arena->name, sizeof(arena->name), "Worker %u", (u32)s_arenas.size());
+		}
+		s_arenas.push_back(arena);
+		SDL_AtomicUnlock(&s_arenaLock);
+
+		return arena;
+	}
+
+	FrameArena* frameArena_get()
+	{
+		if (!s_threadArena)
+		{
+			s_threadArena = arena_create();
+		}
+		return s_threadArena;
+	}
+
+	void* frameArena_alloc(FrameArena* arena, u64 size, u32 alignment)
+	{
+		assert(arena && alignment && (alignment & (alignment - 1)) == 0 && alignment <= FRAME_ARENA_MAX_ALIGN);
+		ArenaBuffer* buffer = &arena->buffers[s_curBuffer];
+		if (!size) { size = 1; }
+
+		u8* data = buffer->chunk ? (u8*)(buffer->chunk + 1) : buffer->base;
+		u64 capacity = buffer->chunk ? buffer->chunk->size : buffer->capacity;
+		// Align the address rather than the offset so any alignment up to FRAME_ARENA_MAX_ALIGN is honored.
+		u64 start = data ? ((((size_t)data + buffer->offset + alignment - 1) & ~size_t(alignment - 1)) - (size_t)data) : 0;
+		if (!data || start + size > capacity)
+		{
+			// Overflow, allocate a new chunk. The buffer will be grown to the high-water mark on reset.
+			u64 chunkSize = size + alignment;
+			if (chunkSize < FRAME_ARENA_MIN_CHUNK) { chunkSize = FRAME_ARENA_MIN_CHUNK; }
+			ArenaChunk* chunk = (ArenaChunk*)malloc(sizeof(ArenaChunk) + chunkSize);
+			if (!chunk)
+			{
+				TFE_System::logWrite(LOG_ERROR, "FrameArena", "Failed to allocate an overflow chunk of %llu bytes.", (unsigned long long)chunkSize);
+				return nullptr;
+			}
+			chunk->prev = buffer->chunk;
+			chunk->size = chunkSize;
+			buffer->chunk = chunk;
+			buffer->offset = 0;
+			arena->overflowCount++;
+
+			data = (u8*)(chunk + 1);
+			start = (((size_t)data + alignment - 1) & ~size_t(alignment - 1)) - (size_t)data;
+		}
+
+		buffer->used += start + size - buffer->offset;
+		buffer->offset = start + size;
+		if (buffer->used > buffer->highWater) { buffer->highWater = buffer->used; }
+		return data + start;
+	}
+
+	void* frameArena_alloc(u64 size, u32 alignment)
+	{
+		return frameArena_alloc(frameArena_get(), size, alignment);
+	}
+
+	FrameArenaMarker frameArena_getMarker(FrameArena* arena)
+	{
+		const ArenaBuffer* buffer = &arena->buffers[s_curBuffer];
+		return { buffer->chunk, buffer->offset, buffer->used };
+	}
+
+	void frameArena_freeToMarker(FrameArena* arena, const FrameArenaMarker& marker)
+	{
+		ArenaBuffer* buffer = &arena->buffers[s_curBuffer];
+		assert(marker.used <= buffer->used);
+		buffer_freeChunks(buffer, (ArenaChunk*)marker.chunk);
+		buffer->offset = marker.offset;
+		buffer->used = marker.used;
+	}
+
+	void frameArena_beginFrame()
+	{
+		// Make sure the calling (main) thread always has an arena.
+		frameArena_get();
+
+		const u32 nextBuffer = (s_curBuffer + 1) % FRAME_ARENA_BUFFER_COUNT;
+		u64 usedTotal = 0, highWaterTotal = 0;
+		u32 overflowTotal = 0;
+
+		SDL_AtomicLock(&s_arenaLock);
+		const size_t count = s_arenas.size();
+		for (size_t i = 0; i < count; i++)
+		{
+			FrameArena* arena = s_arenas[i];
+			const ArenaBuffer* prev = &arena->buffers[s_curBuffer];
+			arena->frameHighWater = prev->highWater;
+			if (prev->highWater > arena->highWater) { arena->highWater = prev->highWater; }
+
+			// Both buffers should fit the peak, so grow the one about to be reused.
+			ArenaBuffer* next = &arena->buffers[nextBuffer];
+			if (arena->highWater > next->highWater) { next->highWater = arena->highWater; }
+			buffer_reset(next);
+
+			usedTotal += arena->frameHighWater;
+			highWaterTotal += arena->highWater;
+			overflowTotal += arena->overflowCount;
+		}
+		SDL_AtomicUnlock(&s_arenaLock);
+		s_curBuffer = nextBuffer;
+
+		s_frameArenaUsedKB = s32((usedTotal + 1023) >> 10);
+		s_frameArenaHighWaterKB = s32((highWaterTotal + 1023) >> 10);
+		s_frameArenaOverflows = s32(overflowTotal);
+	}
+
+	void frameArena_shutdown()
+	{
+		SDL_AtomicLock(&s_arenaLock);
+		const size_t count = s_arenas.size();
+		for (size_t i = 0; i < count; i++)
+		{
+			FrameArena* arena = s_arenas[i];
+			for (s32 b = 0; b < FRAME_ARENA_BUFFER_COUNT; b++)
+			{
+				buffer_freeChunks(&arena->buffers[b], nullptr);
+				free(arena->buffers[b].base);
+			}
+			free(arena);
+		}
+		s_arenas.clear();
+		SDL_AtomicUnlock(&s_arenaLock);
+		// Only the calling thread's pointer can be cleared, other threads must not use their arenas after shutdown.
+		s_threadArena = nullptr;
+	}
+
+	u32 frameArena_getCount()
+	{
+		SDL_AtomicLock(&s_arenaLock);
+		const u32 count = (u32)s_arenas.size();
+		SDL_AtomicUnlock(&s_arenaLock);
+		return count;
+	}
+
+	bool frameArena_getStats(u32 index, FrameArenaStats* stats)
+	{
+		SDL_AtomicLock(&s_arenaLock);
+		if (index >= (u32)s_arenas.size())
+		{
+			SDL_AtomicUnlock(&s_arenaLock);
+			return false;
+		}
+		const FrameArena* arena = s_arenas[index];
+		const ArenaBuffer* buffer = &arena->buffers[s_curBuffer];
+		stats->name = arena->name;
+		stats->used = buffer->used;
+		stats->capacity = buffer->capacity;
+		stats->frameHighWater = arena->frameHighWater;
+		stats->highWater = arena->highWater;
+		stats->overflowCount = arena->overflowCount;
+		SDL_AtomicUnlock(&s_arenaLock);
+		return true;
+	}
+}
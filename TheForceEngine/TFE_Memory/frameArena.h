@@ -0,0 +1,89 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Per-frame scratch arena.
+// Linear allocator for temporary data that lives at most two frames,
+// replacing per-frame heap traffic.
+//
+// * Each thread gets its own arena on first use, so worker threads
+//   can allocate without locking.
+// * Arenas are double buffered: memory allocated during frame N stays
+//   valid until the start of frame N + 2. This allows data built in
+//   one frame to be consumed (e.g. uploaded) in the next.
+// * Markers allow scoped allocations to be released early, which keeps
+//   the footprint down for code that is called many times per frame.
+// * If a buffer runs out of space, allocations fall back to overflow
+//   chunks and the buffer is grown to the high-water mark on the next
+//   reset, so steady state frames never touch the heap.
+//
+// frameArena_beginFrame() is called once per frame by the main loop,
+// it must not be called while other threads are using their arenas.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+struct FrameArena;
+
+namespace TFE_Memory
+{
+	enum FrameArenaConst : u32
+	{
+		FRAME_ARENA_DEFAULT_ALIGN = 16,
+		FRAME_ARENA_MAX_ALIGN = 4096,
+	};
+
+	struct FrameArenaMarker
+	{
+		void* chunk;
+		u64 offset;
+		u64 used;
+	};
+
+	struct FrameArenaStats
+	{
+		const char* name;
+		u64 used;			// Bytes in use in the current frame buffer.
+		u64 capacity;		// Capacity of the current frame buffer, not including overflow chunks.
+		u64 frameHighWater;	// Largest usage of the previous frame.
+		u64 highWater;		// Largest usage of any frame.
+		u32 overflowCount;	// Number of overflow chunks allocated since startup.
+	};
+
+	// Get the calling thread's arena, creating it if needed.
+	FrameArena* frameArena_get();
+
+	// Allocate from an arena. Alignment must be a power of two <= FRAME_ARENA_MAX_ALIGN.
+	void* frameArena_alloc(FrameArena* arena, u64 size, u32 alignment = FRAME_ARENA_DEFAULT_ALIGN);
+	// Allocate from the calling thread's arena.
+	void* frameArena_alloc(u64 size, u32 alignment = FRAME_ARENA_DEFAULT_ALIGN);
+
+	// Markers only apply to the current frame buffer.
+	FrameArenaMarker frameArena_getMarker(FrameArena* arena);
+	void frameArena_freeToMarker(FrameArena* arena, const FrameArenaMarker& marker);
+
+	// Swap the double buffers of all arenas and reset the new current buffers.
+	void frameArena_beginFrame();
+	void frameArena_shutdown();
+
+	u32  frameArena_getCount();
+	bool frameArena_getStats(u32 index, FrameArenaStats* stats);
+
+	template <typename T>
+	T* frameArena_allocArray(u64 count, u32 alignment = alignof(T) > FRAME_ARENA_DEFAULT_ALIGN ? alignof(T) : FRAME_ARENA_DEFAULT_ALIGN)
+	{
+		return (T*)frameArena_alloc(sizeof(T) * count, alignment);
+	}
+
+	// Releases everything allocated in the calling thread's arena during the scope.
+	class FrameArenaScope
+	{
+	public:
+		FrameArenaScope() : m_arena(frameArena_get()), m_marker(frameArena_getMarker(m_arena)) {}
+		~FrameArenaScope() { frameArena_freeToMarker(m_arena, m_marker); }
+
+		FrameArenaScope(const FrameArenaScope&) = delete;
+		FrameArenaScope& operator=(const FrameArenaScope&) = delete;
+
+	private:
+		FrameArena* m_arena;
+		FrameArenaMarker m_marker;
+	};
+}
@@ -1,8 +1,10 @@
 #include <cstring>
 
 #include "memoryRegion.h"
+#include "allocTracker.h"
 #include <TFE_System/system.h>
 #include <TFE_System/memoryPool.h>
+#include <TFE_FileSystem/memorystream.h>
 #include <TFE_System/math.h>
 #include <TFE_Jedi/Math/core_math.h>
 #include <assert.h>
@@ -10,6 +12,9 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 // #define _VERIFY_MEMORY
 
@@ -26,54 +31,64 @@ enum
 	MIN_SPLIT_SIZE = 32,
 	BLOCK_ARR_STEP = 16,
 	ALIGNMENT = 8,
-	ALLOC_BIN_COUNT = 6,
-	ALLOC_BIN_LAST = 5,
+	ALIGNMENT_SHIFT = 3,
 	// No more then 256 blocks, and no more than 16MB per block for a total of 4GB.
 	MAX_BLOCK_COUNT = 256,
 	MAX_BLOCK_SIZE  = 16 * 1024 * 1024,
+	MAX_BLOCK_SIZE_LOG2 = 24,
 	RELATIVE_NON_NULL_BIT = 1u,
-	SHARED_HEADER_SIZE = 8,	// 8 bytes are shared between RegionAllocHeader{} and AllocHeaderFree{}
+	SHARED_HEADER_SIZE = 12,	// 12 bytes are shared between RegionAllocHeader{} and AllocHeaderFree{}
+
+	// Two-level segregated fit (TLSF) free lists.
+	// The first level splits free ranges by power of two, the second level splits each power of two
+	// into TLSF_SL_COUNT linear ranges. Sizes below TLSF_SMALL_SIZE all go into first level 0.
+	TLSF_SL_LOG2    = 4,
+	TLSF_SL_COUNT   = 1 << TLSF_SL_LOG2,
+	TLSF_FL_SHIFT   = TLSF_SL_LOG2 + ALIGNMENT_SHIFT,
+	TLSF_SMALL_SIZE = 1 << TLSF_FL_SHIFT,
+	TLSF_FL_COUNT   = MAX_BLOCK_SIZE_LOG2 - TLSF_FL_SHIFT + 2,
 };
 
 struct RegionAllocHeader
 {
-	u32 size;
+	u32 size;		// Size of the allocation, including the header.
 	u8  free;
-	u8  bin;
+	u8  block;		// Index of the memory block that owns the allocation.
 	u8  pad8[2];
-	u32 pad4[2];	// pad to 16 bytes.
+	u32 prevSize;	// Size of the previous allocation in the same block, 0 if this is the first.
+	u32 pad4;		// pad to 16 bytes.
 };
 
-// free structure is larger than header, because it fits within the
+// The free header is larger than the shared part of the header, but it fits within the
 // alignment: align(8, sizeof(header)=16 + size), so at least 24 bytes is allocated.
+// Links are stored as relative pointers so they are the same size on all targets and
+// do not need to be fixed up when the region is serialized.
 struct AllocHeaderFree
 {
 	u32 size;
 	u8  free;
-	u8  bin;
+	u8  block;
 	u8  pad8[2];
-	AllocHeaderFree* binNext;
-	AllocHeaderFree* binPrev;
-#if (defined(_WIN32) && !defined(_WIN64)) || (__SIZEOF_POINTER__ == 4)
-// the code assumes the above 2 pointers are 8bytes,
-// so we need to pad this structure for 32bit targets.
-	u32 _pad32[2];
-#endif
+	u32 prevSize;
+	RelativePointer binNext;
+	RelativePointer binPrev;
 };
 
 struct MemoryBlock
 {
 	u32 sizeFree;
 	u32 count;
-	// Head pointer to each bin.
-	// Bin index = clamp(log2(nextPow2(size)) - 5, 0, 5)
-	// bin 0: [0,  32]
-	//     1: [33, 64]
-	//     2: [65, 128]
-	//     3: [129, 256]
-	//     4: [257, 512]
-	//     5: [513+]
-	AllocHeaderFree* freeListBins[ALLOC_BIN_COUNT];
+};
+
+// Free lists shared by all of the blocks in a region.
+// A free range in list [fl][sl] is guaranteed to fit any size that maps to a lower list,
+// so finding a fit is two bit scans rather than a search.
+struct RegionFreeIndex
+{
+	u32 flBitmap;
+	u32 slBitmap[TLSF_FL_COUNT];
+	RelativePointer freeLists[TLSF_FL_COUNT][TLSF_SL_COUNT];
+	u32 freeCount;
 };
 
 struct MemoryRegion
@@ -85,10 +100,31 @@ struct MemoryRegion
 	u64 blockCount;
 	u64 blockSize;
 	u64 maxBlocks;
+
+	RegionFreeIndex freeIndex;
+	TFE_Memory::AllocTag allocTag;
+	TFE_Memory::AllocTag subAllocTag;
+};
+
+struct RegionSnapshot
+{
+	char name[32];
+	u64 blockSize;
+	u64 blockCount;
+	u64 blockCapacity;
+	RegionFreeIndex freeIndex;
+	// Fixup table: the address and copied size of each block when the snapshot was taken.
+	MemoryBlock** blockAddr;
+	u64* blockBytes;
+
+	u8* data;
+	u64 dataSize;
+	u64 dataCapacity;
 };
 
 static_assert(sizeof(RegionAllocHeader) == 16, "RegionAllocHeader is the wrong size.");
-static_assert(sizeof(AllocHeaderFree) == 24, "AllocHeaderFree is the wrong size.");
+static_assert(sizeof(AllocHeaderFree) == 20, "AllocHeaderFree is the wrong size.");
+static_assert(TLSF_FL_COUNT <= 32, "The first level bitmap is too small.");
 
 namespace TFE_Memory
 {
@@ -97,44 +133,142 @@ namespace TFE_Memory
 	static const u32 c_relativeBlockShift = 24u;
 	static const u32 c_relativeOffsetMask = (1u << c_relativeBlockShift) - 1u;
 
-	void freeSlot(RegionAllocHeader* alloc, RegionAllocHeader* next, MemoryBlock* block);
+	void freeSlot(MemoryRegion* region, RegionAllocHeader* alloc);
 	u64 alloc_align(u64 baseSize);
-	s32  getBinFromSize(u32 size);
 	bool allocateNewBlock(MemoryRegion* region);
-	void removeHeaderFromFreelist(MemoryBlock* block, RegionAllocHeader* header);
-	void insertBlockIntoFreelist(MemoryBlock* block, RegionAllocHeader* header);
+	void resetBlock(MemoryRegion* region, s32 blockIndex);
+	void removeHeaderFromFreelist(MemoryRegion* region, RegionAllocHeader* header);
+	void insertBlockIntoFreelist(MemoryRegion* region, RegionAllocHeader* header);
+
+	// Index of the highest set bit, 'x' must not be zero.
+	static inline s32 tlsf_fls(u32 x)
+	{
+	#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanReverse(&index, x);
+		return s32(index);
+	#else
+		return 31 - __builtin_clz(x);
+	#endif
+	}
+
+	// Index of the lowest set bit, 'x' must not be zero.
+	static inline s32 tlsf_ffs(u32 x)
+	{
+	#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, x);
+		return s32(index);
+	#else
+		return __builtin_ctz(x);
+	#endif
+	}
+
+	// Get the free list that a free range of 'size' belongs to.
+	static inline void tlsf_mapping(u32 size, s32* fl, s32* sl)
+	{
+		if (size < TLSF_SMALL_SIZE)
+		{
+			*fl = 0;
+			*sl = s32(size >> ALIGNMENT_SHIFT);
+		}
+		else
+		{
+			const s32 topBit = tlsf_fls(size);
+			*sl = s32(size >> (topBit - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+			*fl = topBit - (TLSF_FL_SHIFT - 1);
+		}
+	}
+
+	static inline u8* getBlockMemory(MemoryBlock* block)
+	{
+		return (u8*)block + sizeof(MemoryBlock);
+	}
+
+	static inline RelativePointer getHeaderRelativePointer(MemoryRegion* region, RegionAllocHeader* header)
+	{
+		const u32 offset = u32((u8*)header - getBlockMemory(region->memBlocks[header->block]));
+		return offset | (u32(header->block) << c_relativeBlockShift) | RELATIVE_NON_NULL_BIT;
+	}
+
+	static inline AllocHeaderFree* getFreeHeader(MemoryRegion* region, RelativePointer ptr)
+	{
+		if (ptr == NULL_RELATIVE_POINTER) { return nullptr; }
+		ptr &= ~RELATIVE_NON_NULL_BIT;
+		return (AllocHeaderFree*)(getBlockMemory(region->memBlocks[ptr >> c_relativeBlockShift]) + (ptr & c_relativeOffsetMask));
+	}
+
+	// Returns the allocation that physically follows 'header' in its block, or null if it is the last one.
+	static inline RegionAllocHeader* getNextHeader(MemoryRegion* region, RegionAllocHeader* header)
+	{
+		u8* next = (u8*)header + header->size;
+		if (next >= getBlockMemory(region->memBlocks[header->block]) + region->blockSize)
+		{
+			return nullptr;
+		}
+		return (RegionAllocHeader*)next;
+	}
 
 	void verifyMemory(MemoryRegion* region)
 	{
+		u32 freeCount = 0;
 		for (s32 i = 0; i < region->blockCount; i++)
 		{
 			MemoryBlock* block = region->memBlocks[i];
 			assert(block->sizeFree <= region->blockSize);
-			u8* mem = (u8*)block + sizeof(MemoryBlock);
+			u8* mem = getBlockMemory(block);
 			RegionAllocHeader* prev = nullptr;
+			u32 sizeFree = 0;
 			for (u32 a = 0; a < block->count; a++)
 			{
 				RegionAllocHeader* header = (RegionAllocHeader*)mem;
 				assert(header->free == 0 || header->free == 1);
 				assert(header->size <= region->blockSize);
+				assert(header->block == i);
+				assert(header->prevSize == (prev ? prev->size : 0));
+				// Adjacent free ranges should always be merged.
+				assert(!header->free || !prev || !prev->free);
+				if (header->free)
+				{
+					sizeFree += header->size;
+					freeCount++;
+				}
 				mem += header->size;
 				prev = header;
 			}
+			assert(mem == getBlockMemory(block) + region->blockSize);
+			assert(sizeFree == block->sizeFree);
+		}
 
-			for (s32 b = 0; b < ALLOC_BIN_COUNT; b++)
+		RegionFreeIndex* index = &region->freeIndex;
+		u32 listCount = 0;
+		for (s32 fl = 0; fl < TLSF_FL_COUNT; fl++)
+		{
+			assert(((index->flBitmap >> fl) & 1) == (index->slBitmap[fl] ? 1u : 0u));
+			for (s32 sl = 0; sl < TLSF_SL_COUNT; sl++)
 			{
-				if (block->freeListBins[b])
+				AllocHeaderFree* slot = getFreeHeader(region, index->freeLists[fl][sl]);
+				assert(((index->slBitmap[fl] >> sl) & 1) == (slot ? 1u : 0u));
+				while (slot)
 				{
-					AllocHeaderFree* slot = block->freeListBins[b];
-					while (slot)
-					{
-						assert(slot->free == 1 && slot->bin == b);
-						assert(slot->size <= block->sizeFree);
-						slot = slot->binNext;
-					}
+					s32 slotFl, slotSl;
+					tlsf_mapping(slot->size, &slotFl, &slotSl);
+					assert(slot->free == 1 && slotFl == fl && slotSl == sl);
+					listCount++;
+					slot = getFreeHeader(region, slot->binNext);
 				}
 			}
 		}
+		assert(listCount == freeCount && freeCount == index->freeCount);
+	}
+
+	void region_registerAllocTags(MemoryRegion* region)
+	{
+		char tagName[32];
+		snprintf(tagName, sizeof(tagName), "Region: %s", region->name);
+		region->allocTag = allocTracker_registerTag(tagName);
+		snprintf(tagName, sizeof(tagName), "Allocator: %s", region->name);
+		region->subAllocTag = allocTracker_registerTag(tagName, region->allocTag);
 	}
 
 	MemoryRegion* region_create(const char* name, u64 blockSize, u64 maxSize)
@@ -160,6 +294,8 @@ namespace TFE_Memory
 		region->blockCount = 0;
 		region->blockSize = blockSize;
 		region->maxBlocks = maxSize ? (maxSize + blockSize - 1) / blockSize : 0;
+		memset(&region->freeIndex, 0, sizeof(RegionFreeIndex));
+		region_registerAllocTags(region);
 		if (!allocateNewBlock(region))
 		{
 			free(region);
@@ -174,24 +310,19 @@ namespace TFE_Memory
 	void region_clear(MemoryRegion* region)
 	{
 		assert(region);
+		allocTracker_clearTag(region->allocTag);
+		memset(&region->freeIndex, 0, sizeof(RegionFreeIndex));
 		for (s32 i = 0; i < region->blockCount; i++)
 		{
-			MemoryBlock* block = region->memBlocks[i];
-			block->sizeFree = u32(region->blockSize);
-			block->count = 1;
-
-			RegionAllocHeader* header = (RegionAllocHeader*)((u8*)block + sizeof(MemoryBlock));
-			header->size = block->sizeFree;
-			header->free = 0;
-			memset(block->freeListBins, 0, sizeof(AllocHeaderFree*)*ALLOC_BIN_COUNT);
-			insertBlockIntoFreelist(block, header);
-			VERIFY_MEMORY();
+			resetBlock(region, i);
 		}
+		VERIFY_MEMORY();
 	}
 
 	void region_destroy(MemoryRegion* region)
 	{
 		assert(region);
+		allocTracker_clearTag(region->allocTag);
 		for (s32 i = 0; i < region->blockCount; i++)
 		{
 			free(region->memBlocks[i]);
@@ -199,38 +330,92 @@ namespace TFE_Memory
 		free(region->memBlocks);
 		free(region);
 	}
-		
-	void* allocFromHeader(MemoryBlock* block, RegionAllocHeader* header, u32 size)
+
+	// Split 'header' so that it is 'size' bytes, the remainder is added to the free lists.
+	// Returns the size of the new free range or 0 if the remainder is too small to split off.
+	u32 splitHeader(MemoryRegion* region, RegionAllocHeader* header, u32 size)
 	{
-		assert(header->free == 1);
-		if (header->size - size >= MIN_SPLIT_SIZE)
+		if (header->size - size < MIN_SPLIT_SIZE)
 		{
-			// Split.
-			u64 split0 = size;
-			u64 split1 = header->size - split0;
-			RegionAllocHeader* next = (RegionAllocHeader*)((u8*)header + split0);
+			return 0;
+		}
 
-			// Cleanup the free list.
-			removeHeaderFromFreelist(block, header);
-			header->size = u32(split0);
+		RegionAllocHeader* next = (RegionAllocHeader*)((u8*)header + size);
+		next->size = header->size - size;
+		next->free = 0;
+		next->block = header->block;
+		next->prevSize = size;
+		header->size = size;
 
-			// Create a new free block.
-			next->size = u32(split1);
-			next->free = 0;
-			block->count++;
-						
-			// Add the new block to the free list.
-			insertBlockIntoFreelist(block, next);
-		}
-		else
+		RegionAllocHeader* after = getNextHeader(region, next);
+		if (after)
 		{
-			// Consume the whole block.
-			removeHeaderFromFreelist(block, header);
+			after->prevSize = next->size;
 		}
-		block->sizeFree -= header->size;
+		region->memBlocks[header->block]->count++;
+
+		// Add the new block to the free list.
+		insertBlockIntoFreelist(region, next);
+		return next->size;
+	}
+
+	void* allocFromHeader(MemoryRegion* region, RegionAllocHeader* header, u32 size)
+	{
+		assert(header->free == 1);
+		removeHeaderFromFreelist(region, header);
+		splitHeader(region, header, size);
+
+		region->memBlocks[header->block]->sizeFree -= header->size;
+		TFE_TRACK_ALLOC(region->allocTag, header->size);
 		return (u8*)header + sizeof(RegionAllocHeader);
 	}
 
+	// Find a free range that can hold 'size' bytes in constant time.
+	AllocHeaderFree* findFreeHeader(MemoryRegion* region, u32 size)
+	{
+		RegionFreeIndex* index = &region->freeIndex;
+
+		// Round up to the next list so that any range in it is large enough.
+		u32 searchSize = size;
+		if (searchSize >= TLSF_SMALL_SIZE)
+		{
+			searchSize += (1u << (tlsf_fls(searchSize) - TLSF_SL_LOG2)) - 1u;
+		}
+		s32 fl, sl;
+		tlsf_mapping(searchSize, &fl, &sl);
+		if (fl < TLSF_FL_COUNT)
+		{
+			u32 slMap = index->slBitmap[fl] & (~0u << sl);
+			if (!slMap)
+			{
+				const u32 flMap = (fl + 1 < TLSF_FL_COUNT) ? index->flBitmap & (~0u << (fl + 1)) : 0u;
+				if (flMap)
+				{
+					fl = tlsf_ffs(flMap);
+					slMap = index->slBitmap[fl];
+				}
+			}
+			if (slMap)
+			{
+				return getFreeHeader(region, index->freeLists[fl][tlsf_ffs(slMap)]);
+			}
+		}
+
+		// Before giving up, search the list that 'size' itself maps to since it may still contain a large enough range.
+		// This only happens when the region is nearly full, so it is worth avoiding a new block.
+		tlsf_mapping(size, &fl, &sl);
+		AllocHeaderFree* header = getFreeHeader(region, index->freeLists[fl][sl]);
+		while (header)
+		{
+			if (header->size >= size)
+			{
+				return header;
+			}
+			header = getFreeHeader(region, header->binNext);
+		}
+		return nullptr;
+	}
+
 	void* region_alloc(MemoryRegion* region, u64 size)
 	{
 		assert(region);
@@ -239,32 +424,14 @@ namespace TFE_Memory
 		size = alloc_align(size + sizeof(RegionAllocHeader));
 		assert(size >= 24);	// at least 24 bytes is required to hold the free header.
 		if (size > region->blockSize) { return nullptr; }
-		
-		for (s32 i = 0; i < region->blockCount; i++)
-		{
-			MemoryBlock* block = region->memBlocks[i];
-			if (block->sizeFree < size)
-			{
-				continue;
-			}
 
-			// Try to allocate from the closest matching bin.
-			s32 bin = getBinFromSize((u32)size);
-			for (s32 b = bin; b < ALLOC_BIN_COUNT; b++)
-			{
-				AllocHeaderFree* header = block->freeListBins[b];
-				while (header)
-				{
-					if (header->size >= size)
-					{
-						VERIFY_MEMORY();
-						void* mem = allocFromHeader(block, (RegionAllocHeader*)header, (u32)size);
-						VERIFY_MEMORY();
-						return mem;
-					}
-					header = header->binNext;
-				}
-			}
+		AllocHeaderFree* header = findFreeHeader(region, (u32)size);
+		if (header)
+		{
+			VERIFY_MEMORY();
+			void* mem = allocFromHeader(region, (RegionAllocHeader*)header, (u32)size);
+			VERIFY_MEMORY();
+			return mem;
 		}
 
 		if (!region->maxBlocks || region->blockCount < region->maxBlocks)
@@ -272,7 +439,7 @@ namespace TFE_Memory
 			if (allocateNewBlock(region))
 			{
 				VERIFY_MEMORY();
-				void* mem = region_alloc(region, size);
+				void* mem = region_alloc(region, size - sizeof(RegionAllocHeader));
 				VERIFY_MEMORY();
 				return mem;
 			}
@@ -289,87 +456,52 @@ namespace TFE_Memory
 		if (!ptr) { return region_alloc(region, size); }
 		if (size == 0) { return nullptr; }
 
+		const u64 requestSize = size;
 		size = alloc_align(size + sizeof(RegionAllocHeader));
 		if (size > region->blockSize) { return nullptr; }
 
-		// If the current block is already large enough, skip looping over the memory blocks.
+		// If the current block is already large enough, just stick to the same memory.
 		RegionAllocHeader* header = (RegionAllocHeader*)((u8*)ptr - sizeof(RegionAllocHeader));
+		assert(header->free == 0);
 		if (header->size >= size)
 		{
 			return ptr;
 		}
 
-		// First try to reallocate in the same region.
-		u32 prevSize = 0;
-		for (s32 i = (s32)region->blockCount - 1; i >= 0; i--)
+		// If the next block is free, merge the two blocks and then allocate from that.
+		RegionAllocHeader* nextHeader = getNextHeader(region, header);
+		if (nextHeader && nextHeader->free && header->size + nextHeader->size >= size)
 		{
-			MemoryBlock* block = region->memBlocks[i];
-			if (ptr >= block)
-			{
-				RegionAllocHeader* header = (RegionAllocHeader*)((u8*)ptr - sizeof(RegionAllocHeader));
-				RegionAllocHeader* nextHeader = (RegionAllocHeader*)((u8*)header + header->size);
-				assert(header->free == 0);
+			VERIFY_MEMORY();
+			MemoryBlock* block = region->memBlocks[header->block];
+			// Remove the nextHeader from the freelist.
+			removeHeaderFromFreelist(region, nextHeader);
+
+			// Merge blocks.
+			TFE_TRACK_FREE(region->allocTag, header->size);
+			block->sizeFree -= nextHeader->size;
+			header->size += nextHeader->size;
+			block->count--;
 
-				if ((u8*)nextHeader >= (u8*)block + region->blockSize)
-				{
-					nextHeader = nullptr;
-				}
-				// If it is big enough, just stick to the same memory.
-				if (header->size >= size)
-				{
-					return ptr;
-				}
-				// If the next block is free, merge the two blocks and then allocate from that.
-				if (nextHeader && nextHeader->free && header->size + nextHeader->size >= size)
-				{
-					VERIFY_MEMORY();
-					// Remove the nextHeader from the freelist.
-					assert(nextHeader->free == 1);
-					removeHeaderFromFreelist(block, nextHeader);
-
-					// Merge blocks.
-					block->sizeFree += header->size;
-					header->size += nextHeader->size;
-					block->count--;
-									
-					// Allocate from the new header.
-					if (header->size - size >= MIN_SPLIT_SIZE)
-					{
-						// Split.
-						u64 split0 = size;
-						u64 split1 = header->size - split0;
-						RegionAllocHeader* next = (RegionAllocHeader*)((u8*)header + split0);
-
-						// Reset the header.
-						header->free = 0;
-						header->size = u32(split0);
-
-						// Create a new free block.
-						next->size = u32(split1);
-						next->free = 0;
-						block->count++;
-
-						// Add the new block to the free list.
-						insertBlockIntoFreelist(block, next);
-					}
-					block->sizeFree -= header->size;
-					VERIFY_MEMORY();
-					return (u8*)header + sizeof(RegionAllocHeader);
-				}
-				// Otherwise break, we have to free and reallocate.
-				prevSize = header->size;
-				break;
+			RegionAllocHeader* after = getNextHeader(region, header);
+			if (after)
+			{
+				after->prevSize = header->size;
 			}
+
+			// Then give back whatever is not needed.
+			block->sizeFree += splitHeader(region, header, (u32)size);
+			TFE_TRACK_ALLOC(region->allocTag, header->size);
+			VERIFY_MEMORY();
+			return ptr;
 		}
 
-		// Allocate a new block of memory.
-		void* newMem = region_alloc(region, size);
+		// Otherwise we have to allocate a new block of memory.
+		const u32 prevSize = header->size;
+		void* newMem = region_alloc(region, requestSize);
 		if (!newMem) { return nullptr; }
 		// Copy over the contents from the previous block.
-		if (prevSize > sizeof(RegionAllocHeader))
-		{
-			memcpy(newMem, ptr, std::min((u32)size, prevSize) - sizeof(RegionAllocHeader));
-		}
+		memcpy(newMem, ptr, std::min((u32)size, prevSize) - sizeof(RegionAllocHeader));
 		// Free the previous block
 		region_free(region, ptr);
 		// Then return the new block.
@@ -381,31 +513,24 @@ namespace TFE_Memory
 	{
 		if (!ptr || !region) { return; }
 
-		for (s32 i = (s32)region->blockCount - 1; i >= 0; i--)
+		RegionAllocHeader* header = (RegionAllocHeader*)((u8*)ptr - sizeof(RegionAllocHeader));
+		if (header->block >= region->blockCount || (u8*)header < getBlockMemory(region->memBlocks[header->block]) ||
+			(u8*)header >= getBlockMemory(region->memBlocks[header->block]) + region->blockSize)
 		{
-			MemoryBlock* block = region->memBlocks[i];
-			if (ptr >= block)
-			{
-				RegionAllocHeader* header = (RegionAllocHeader*)((u8*)ptr - sizeof(RegionAllocHeader));
-				RegionAllocHeader* nextHeader = (RegionAllocHeader*)((u8*)header + header->size);
-				if ((u8*)nextHeader >= (u8*)block + region->blockSize)
-				{
-					nextHeader = nullptr;
-				}
-
-				assert(!header->free);
-				if (header->free)
-				{
-					TFE_System::logWrite(LOG_ERROR, "MemoryRegion", "Attempted to double free pointer %x in region '%s'.", ptr, region->name);
-					return;
-				}
+			TFE_System::logWrite(LOG_ERROR, "MemoryRegion", "Attempted to free pointer %x which is not in region '%s'.", ptr, region->name);
+			return;
+		}
 
-				VERIFY_MEMORY();
-				freeSlot(header, nextHeader, block);
-				VERIFY_MEMORY();
-				return;
-			}
+		assert(!header->free);
+		if (header->free)
+		{
+			TFE_System::logWrite(LOG_ERROR, "MemoryRegion", "Attempted to double free pointer %x in region '%s'.", ptr, region->name);
+			return;
 		}
+
+		VERIFY_MEMORY();
+		freeSlot(region, header);
+		VERIFY_MEMORY();
 	}
 		
 	u64 region_getMemoryUsed(MemoryRegion* region)
@@ -418,6 +543,16 @@ namespace TFE_Memory
 		return used;
 	}
 
+	AllocTag region_getAllocTag(MemoryRegion* region)
+	{
+		return region ? region->allocTag : ALLOC_TAG_HEAP;
+	}
+
+	AllocTag region_getSubAllocTag(MemoryRegion* region)
+	{
+		return region ? region->subAllocTag : ALLOC_TAG_HEAP;
+	}
+
 	void region_getBlockInfo(MemoryRegion* region, u64* blockCount, u64* blockSize)
 	{
 		*blockCount = region->blockCount;
@@ -428,6 +563,37 @@ namespace TFE_Memory
 	{
 		return region->blockCount * region->blockSize;
 	}
+
+	void region_getStats(MemoryRegion* region, MemoryRegionStats* stats)
+	{
+		memset(stats, 0, sizeof(MemoryRegionStats));
+		if (!region) { return; }
+
+		u32 rangeCount = 0;
+		for (s32 i = 0; i < region->blockCount; i++)
+		{
+			stats->freeBytes += region->memBlocks[i]->sizeFree;
+			rangeCount += region->memBlocks[i]->count;
+		}
+		stats->usedBytes = region->blockCount * region->blockSize - stats->freeBytes;
+		stats->freeRanges = region->freeIndex.freeCount;
+		stats->allocCount = rangeCount - stats->freeRanges;
+
+		// The largest free range is in the highest non-empty list.
+		const RegionFreeIndex* index = &region->freeIndex;
+		if (index->flBitmap)
+		{
+			const s32 fl = tlsf_fls(index->flBitmap);
+			const s32 sl = tlsf_fls(index->slBitmap[fl]);
+			AllocHeaderFree* header = getFreeHeader(region, index->freeLists[fl][sl]);
+			while (header)
+			{
+				stats->largestFree = std::max(stats->largestFree, (u64)header->size);
+				header = getFreeHeader(region, header->binNext);
+			}
+		}
+		stats->fragmentation = stats->freeBytes ? 1.0f - f32(stats->largestFree) / f32(stats->freeBytes) : 0.0f;
+	}
 		
 	RelativePointer region_getRelativePointer(MemoryRegion* region, void* ptr)
 	{
@@ -436,10 +602,10 @@ namespace TFE_Memory
 		
 		for (s32 i = (s32)region->blockCount - 1; i >= 0; i--)
 		{
-			MemoryBlock* block = region->memBlocks[i];
-			if (ptr >= block)
+			u8* mem = getBlockMemory(region->memBlocks[i]);
+			if (ptr >= mem && ptr < mem + region->blockSize)
 			{
-				rp = RelativePointer((u8*)ptr - (u8*)block - sizeof(MemoryBlock));
+				rp = RelativePointer((u8*)ptr - mem);
 				rp |= (i << c_relativeBlockShift);
 				assert(!(rp & RELATIVE_NON_NULL_BIT));
 
@@ -469,12 +635,12 @@ namespace TFE_Memory
 			return nullptr;
 		}
 		MemoryBlock* block = region->memBlocks[blockIndex];
-		return (u8*)block + (ptr & c_relativeOffsetMask) + sizeof(MemoryBlock);
+		return getBlockMemory(block) + (ptr & c_relativeOffsetMask);
 	}
 
-	bool region_serializeToDisk(MemoryRegion* region, FileStream* file)
+	bool region_serialize(MemoryRegion* region, Stream* file)
 	{
-		if (!region || !file || !file->isOpen())
+		if (!region || !file)
 		{
 			return false;
 		}
@@ -484,31 +650,22 @@ namespace TFE_Memory
 		file->write(&region->blockCount);
 		file->write(&region->blockSize);
 		file->write(&region->maxBlocks);
+		// Free list links are relative pointers, so the index can be written as-is.
+		file->writeBuffer(&region->freeIndex, sizeof(RegionFreeIndex));
 
 		for (s32 b = 0; b < region->blockCount; b++)
 		{
 			MemoryBlock* block = region->memBlocks[b];
 			file->write(&block->count);
 			file->write(&block->sizeFree);
-			for (s32 bin = 0; bin < ALLOC_BIN_COUNT; bin++)
-			{
-				RelativePointer ptr = region_getRelativePointer(region, block->freeListBins[bin]);
-				file->write(&ptr);
-			}
 
-			u8* memPtr = (u8*)block + sizeof(MemoryBlock);
+			u8* memPtr = getBlockMemory(block);
 			for (u32 al = 0; al < block->count; al++)
 			{
 				RegionAllocHeader* header = (RegionAllocHeader*)memPtr;
 				if (header->free)
 				{
-					AllocHeaderFree* freeHeader = (AllocHeaderFree*)memPtr;
-					file->writeBuffer(freeHeader, SHARED_HEADER_SIZE);
-
-					RelativePointer binNext = region_getRelativePointer(region, freeHeader->binNext);
-					RelativePointer binPrev = region_getRelativePointer(region, freeHeader->binPrev);
-					file->write(&binNext);
-					file->write(&binPrev);
+					file->writeBuffer(header, sizeof(AllocHeaderFree));
 				}
 				else
 				{
@@ -522,9 +679,9 @@ namespace TFE_Memory
 		return true;
 	}
 
-	MemoryRegion* region_restoreFromDisk(MemoryRegion* region, FileStream* file)
+	MemoryRegion* region_restore(MemoryRegion* region, Stream* file)
 	{
-		if (!file || !file->isOpen())
+		if (!file)
 		{
 			return nullptr;
 		}
@@ -541,6 +698,7 @@ namespace TFE_Memory
 
 		u64 blockAllocStart = 0;
 		file->readBuffer(region->name, 32);
+		region_registerAllocTags(region);
 		if (region->blockArrCapacity == 0)
 		{
 			file->read(&region->blockArrCapacity);
@@ -596,6 +754,7 @@ namespace TFE_Memory
 			TFE_System::logWrite(LOG_ERROR, "MemoryRegion", "Failed to allocate region.");
 			return nullptr;
 		}
+		file->readBuffer(&region->freeIndex, sizeof(RegionFreeIndex));
 		
 		for (s32 b = 0; b < region->blockCount; b++)
 		{
@@ -609,20 +768,13 @@ namespace TFE_Memory
 			if (!block)
 			{
 				TFE_System::logWrite(LOG_ERROR, "MemoryRegion", "Invalid memory block.");
-				file->close();
 				return nullptr;
 			}
 
 			file->read(&block->count);
 			file->read(&block->sizeFree);
-			for (s32 bin = 0; bin < ALLOC_BIN_COUNT; bin++)
-			{
-				RelativePointer ptr;
-				file->read(&ptr);
-				block->freeListBins[bin] = (AllocHeaderFree*)region_getRealPointer(region, ptr);
-			}
 
-			u8* memPtr = (u8*)block + sizeof(MemoryBlock);
+			u8* memPtr = getBlockMemory(block);
 			for (u32 al = 0; al < block->count; al++)
 			{
 				RegionAllocHeader* header = (RegionAllocHeader*)memPtr;
@@ -630,13 +782,7 @@ namespace TFE_Memory
 
 				if (header->free)
 				{
-					AllocHeaderFree* freeHeader = (AllocHeaderFree*)memPtr;
-					RelativePointer binNext, binPrev;
-					file->read(&binNext);
-					file->read(&binPrev);
-
-					freeHeader->binNext = (AllocHeaderFree*)region_getRealPointer(region, binNext);
-					freeHeader->binPrev = (AllocHeaderFree*)region_getRealPointer(region, binPrev);
+					file->readBuffer((u8*)header + SHARED_HEADER_SIZE, sizeof(AllocHeaderFree) - SHARED_HEADER_SIZE);
 				}
 				else
 				{
@@ -646,105 +792,310 @@ namespace TFE_Memory
 				memPtr += header->size;
 			}
 		}
+		VERIFY_MEMORY();
+
+		// The restored allocations replace whatever was tracked before. Sub-allocations cannot be
+		// recovered from the region alone, so the sub-allocation tag restarts from zero.
+		MemoryRegionStats stats;
+		region_getStats(region, &stats);
+		allocTracker_clearTag(region->allocTag);
+		allocTracker_alloc(region->allocTag, stats.usedBytes, stats.allocCount);
 
 		return region;
 	}
 
-	void freeSlot(RegionAllocHeader* alloc, RegionAllocHeader* next, MemoryBlock* block)
+	bool region_serializeToDisk(MemoryRegion* region, FileStream* file)
+	{
+		if (!file || !file->isOpen())
+		{
+			return false;
+		}
+		// Allocations are written one at a time, so gather them unless the caller already buffers the file.
+		const bool wasBuffered = file->isBuffered();
+		if (!wasBuffered) { file->setBuffered(FileStream::FS_BUFFER_MAX); }
+		const bool result = region_serialize(region, file);
+		if (!wasBuffered) { file->setBuffered(0); }
+		return result;
+	}
+
+	MemoryRegion* region_restoreFromDisk(MemoryRegion* region, FileStream* file)
+	{
+		if (!file || !file->isOpen())
+		{
+			return nullptr;
+		}
+		// Allocation headers are read a few bytes at a time.
+		const bool wasBuffered = file->isBuffered();
+		if (!wasBuffered) { file->setBuffered(FileStream::FS_BUFFER_MAX); }
+		MemoryRegion* result = region_restore(region, file);
+		if (!result)
+		{
+			file->close();
+		}
+		if (!wasBuffered) { file->setBuffered(0); }
+		return result;
+	}
+
+	// Returns the number of bytes of the block, including the block header, that need to be copied to capture its state.
+	// Everything past the last allocation is free, so only the header of a trailing free range is needed.
+	u64 getBlockUsedExtent(MemoryBlock* block)
+	{
+		u8* mem = getBlockMemory(block);
+		RegionAllocHeader* header = (RegionAllocHeader*)mem;
+		for (u32 i = 1; i < block->count; i++)
+		{
+			header = (RegionAllocHeader*)((u8*)header + header->size);
+		}
+		const u64 end = u64((u8*)header - mem) + (header->free ? sizeof(AllocHeaderFree) : header->size);
+		return sizeof(MemoryBlock) + end;
+	}
+
+	RegionSnapshot* region_createSnapshot(MemoryRegion* region, RegionSnapshot* snapshot)
+	{
+		if (!region) { return nullptr; }
+		RegionSnapshot* newSnapshot = nullptr;
+		if (!snapshot)
+		{
+			newSnapshot = (RegionSnapshot*)malloc(sizeof(RegionSnapshot));
+			if (!newSnapshot)
+			{
+				TFE_System::logWrite(LOG_ERROR, "MemoryRegion", "Failed to allocate a snapshot for region '%s'.", region->name);
+				return nullptr;
+			}
+			memset(newSnapshot, 0, sizeof(RegionSnapshot));
+			snapshot = newSnapshot;
+		}
+
+		// Grow the buffers before anything is overwritten, so a snapshot passed in by the caller
+		// still holds its previous contents if an allocation fails.
+		u64 dataSize = 0;
+		for (u64 b = 0; b < region->blockCount; b++)
+		{
+			dataSize += getBlockUsedExtent(region->memBlocks[b]);
+		}
+		bool allocated = true;
+		if (snapshot->blockCapacity < region->blockCount)
+		{
+			const u64 capacity = region->blockArrCapacity;
+			MemoryBlock** blockAddr = (MemoryBlock**)realloc(snapshot->blockAddr, sizeof(MemoryBlock*) * capacity);
+			if (blockAddr) { snapshot->blockAddr = blockAddr; }
+			u64* blockBytes = blockAddr ? (u64*)realloc(snapshot->blockBytes, sizeof(u64) * capacity) : nullptr;
+			if (blockBytes) { snapshot->blockBytes = blockBytes; }
+
+			allocated = blockAddr && blockBytes;
+			if (allocated) { snapshot->blockCapacity = capacity; }
+		}
+		if (allocated && snapshot->dataCapacity < dataSize)
+		{
+			// Leave some room so that snapshots taken repeatedly (e.g. for rewind) rarely need to grow.
+			const u64 capacity = dataSize + dataSize / 4;
+			u8* data = (u8*)malloc(capacity);
+			allocated = data != nullptr;
+			if (allocated)
+			{
+				free(snapshot->data);
+				snapshot->data = data;
+				snapshot->dataCapacity = capacity;
+			}
+		}
+		if (!allocated)
+		{
+			TFE_System::logWrite(LOG_ERROR, "MemoryRegion", "Failed to allocate %llu bytes for a snapshot of region '%s'.", (unsigned long long)dataSize, region->name);
+			// Only free the snapshot if it was allocated here, the caller still owns the one passed in.
+			region_freeSnapshot(newSnapshot);
+			return nullptr;
+		}
+
+		strcpy(snapshot->name, region->name);
+		snapshot->blockSize = region->blockSize;
+		snapshot->blockCount = region->blockCount;
+		snapshot->freeIndex = region->freeIndex;
+		snapshot->dataSize = dataSize;
+
+		u8* data = snapshot->data;
+		for (u64 b = 0; b < region->blockCount; b++)
+		{
+			snapshot->blockAddr[b] = region->memBlocks[b];
+			snapshot->blockBytes[b] = getBlockUsedExtent(region->memBlocks[b]);
+			memcpy(data, region->memBlocks[b], snapshot->blockBytes[b]);
+			data += snapshot->blockBytes[b];
+		}
+		return snapshot;
+	}
+
+	bool region_restoreSnapshot(MemoryRegion* region, const RegionSnapshot* snapshot)
+	{
+		if (!region || !snapshot) { return false; }
+		if (strcmp(region->name, snapshot->name) != 0 || region->blockSize != snapshot->blockSize || region->blockCount < snapshot->blockCount)
+		{
+			TFE_System::logWrite(LOG_ERROR, "MemoryRegion", "Snapshot of region '%s' does not match region '%s'.", snapshot->name, region->name);
+			return false;
+		}
+		for (u64 b = 0; b < snapshot->blockCount; b++)
+		{
+			if (region->memBlocks[b] != snapshot->blockAddr[b])
+			{
+				TFE_System::logWrite(LOG_ERROR, "MemoryRegion", "Block %u of region '%s' has moved since the snapshot was taken.", u32(b), region->name);
+				return false;
+			}
+		}
+
+		region->freeIndex = snapshot->freeIndex;
+		const u8* data = snapshot->data;
+		for (u64 b = 0; b < snapshot->blockCount; b++)
+		{
+			memcpy(region->memBlocks[b], data, snapshot->blockBytes[b]);
+			data += snapshot->blockBytes[b];
+		}
+		// Blocks allocated after the snapshot was taken become free ranges again.
+		for (u64 b = snapshot->blockCount; b < region->blockCount; b++)
+		{
+			resetBlock(region, s32(b));
+		}
+		VERIFY_MEMORY();
+
+		MemoryRegionStats stats;
+		region_getStats(region, &stats);
+		allocTracker_clearTag(region->allocTag);
+		allocTracker_alloc(region->allocTag, stats.usedBytes, stats.allocCount);
+		return true;
+	}
+
+	void region_freeSnapshot(RegionSnapshot* snapshot)
 	{
+		if (!snapshot) { return; }
+		free(snapshot->blockAddr);
+		free(snapshot->blockBytes);
+		free(snapshot->data);
+		free(snapshot);
+	}
+
+	u64 region_getSnapshotSize(const RegionSnapshot* snapshot)
+	{
+		return snapshot ? snapshot->dataSize : 0;
+	}
+
+	void freeSlot(MemoryRegion* region, RegionAllocHeader* alloc)
+	{
+		MemoryBlock* block = region->memBlocks[alloc->block];
 		block->sizeFree += alloc->size;
+		TFE_TRACK_FREE(region->allocTag, alloc->size);
 
 		assert(alloc->free == 0);
+		RegionAllocHeader* next = getNextHeader(region, alloc);
 		if (next && next->free)  // Then try merging the current and next.
 		{
-			assert(next->free == 1);
 			// Remove the next block from the freelist.
-			removeHeaderFromFreelist(block, next);
+			removeHeaderFromFreelist(region, next);
 
 			// Merge
 			alloc->size += next->size;
 			block->count--;
 		}
+		RegionAllocHeader* prev = alloc->prevSize ? (RegionAllocHeader*)((u8*)alloc - alloc->prevSize) : nullptr;
+		if (prev && prev->free)  // Then try merging the previous and current.
+		{
+			removeHeaderFromFreelist(region, prev);
+
+			prev->size += alloc->size;
+			block->count--;
+			alloc = prev;
+		}
+		next = getNextHeader(region, alloc);
+		if (next)
+		{
+			next->prevSize = alloc->size;
+		}
 		// Then add the new item to the free list.
-		insertBlockIntoFreelist(block, alloc);
+		insertBlockIntoFreelist(region, alloc);
 	}
 
 	u64 alloc_align(u64 baseSize)
 	{
 		return (baseSize + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
 	}
-		
-	s32 getBinFromSize(u32 size)
-	{
-		if (size < 32) { return 0; }
-		else if (size <= 64) { return 1; }
-		else if (size <= 128) { return 2; }
-		else if (size <= 256) { return 3; }
-		else if (size <= 512) { return 4; }
-		return 5;
-	}
 
-	void removeHeaderFromFreelist(MemoryBlock* block, RegionAllocHeader* header)
+	void removeHeaderFromFreelist(MemoryRegion* region, RegionAllocHeader* header)
 	{
 		AllocHeaderFree* freeHeader = (AllocHeaderFree*)header;
 		assert(freeHeader->free == 1);
-		assert(freeHeader->bin < ALLOC_BIN_COUNT);
 
-		u8 bin = freeHeader->bin;
-		freeHeader->free = 0;
-		freeHeader->bin = 0;
-		if (freeHeader->binPrev)
+		s32 fl, sl;
+		tlsf_mapping(freeHeader->size, &fl, &sl);
+		RegionFreeIndex* index = &region->freeIndex;
+
+		AllocHeaderFree* prevFree = getFreeHeader(region, freeHeader->binPrev);
+		AllocHeaderFree* nextFree = getFreeHeader(region, freeHeader->binNext);
+		if (prevFree)
 		{
-			AllocHeaderFree* nextFree = freeHeader->binNext;
-			AllocHeaderFree* prevFree = freeHeader->binPrev;
-			prevFree->binNext = nextFree;
-			if (nextFree)
-			{
-				nextFree->binPrev = prevFree;
-			}
+			prevFree->binNext = freeHeader->binNext;
 		}
-		else if (freeHeader->binNext)
+		else
 		{
-			assert(freeHeader == block->freeListBins[bin]);
-			if (freeHeader == block->freeListBins[bin])
+			assert(index->freeLists[fl][sl] == getHeaderRelativePointer(region, header));
+			index->freeLists[fl][sl] = freeHeader->binNext;
+			if (!nextFree)
 			{
-				block->freeListBins[bin] = freeHeader->binNext;
-				block->freeListBins[bin]->binPrev = nullptr;
+				// The list is now empty.
+				index->slBitmap[fl] &= ~(1u << sl);
+				if (!index->slBitmap[fl])
+				{
+					index->flBitmap &= ~(1u << fl);
+				}
 			}
 		}
-		else
+		if (nextFree)
 		{
-			assert(freeHeader->binPrev || freeHeader == block->freeListBins[bin]);
-			if (freeHeader == block->freeListBins[bin])
-			{
-				block->freeListBins[bin] = nullptr;
-			}
+			nextFree->binPrev = freeHeader->binPrev;
 		}
+
+		freeHeader->free = 0;
+		freeHeader->binNext = NULL_RELATIVE_POINTER;
+		freeHeader->binPrev = NULL_RELATIVE_POINTER;
+		index->freeCount--;
 	}
 
-	void insertBlockIntoFreelist(MemoryBlock* block, RegionAllocHeader* header)
+	void insertBlockIntoFreelist(MemoryRegion* region, RegionAllocHeader* header)
 	{
 		AllocHeaderFree* freeNext = (AllocHeaderFree*)header;
 		assert(freeNext->free == 0);
-		s32 bin = getBinFromSize(header->size);
+
+		s32 fl, sl;
+		tlsf_mapping(header->size, &fl, &sl);
+		RegionFreeIndex* index = &region->freeIndex;
+
+		const RelativePointer ptr = getHeaderRelativePointer(region, header);
+		const RelativePointer head = index->freeLists[fl][sl];
 		freeNext->free = 1;
-		freeNext->bin = bin;
 		freeNext->pad8[0] = 0;
 		freeNext->pad8[1] = 0;
-		if (!block->freeListBins[bin])
+		freeNext->binPrev = NULL_RELATIVE_POINTER;
+		freeNext->binNext = head;
+		if (head)
 		{
-			block->freeListBins[bin] = freeNext;
-			freeNext->binPrev = nullptr;
-			freeNext->binNext = nullptr;
+			getFreeHeader(region, head)->binPrev = ptr;
 		}
-		else
-		{
-			block->freeListBins[bin]->binPrev = freeNext;
-			freeNext->binNext = block->freeListBins[bin];
-			freeNext->binPrev = nullptr;
 
-			block->freeListBins[bin] = freeNext;
-		}
+		index->freeLists[fl][sl] = ptr;
+		index->slBitmap[fl] |= (1u << sl);
+		index->flBitmap |= (1u << fl);
+		index->freeCount++;
+	}
+
+	// Reset a block so that it is a single free range.
+	// Note that the free lists must be cleared first.
+	void resetBlock(MemoryRegion* region, s32 blockIndex)
+	{
+		MemoryBlock* block = region->memBlocks[blockIndex];
+		block->sizeFree = u32(region->blockSize);
+		block->count = 1;
+
+		RegionAllocHeader* header = (RegionAllocHeader*)getBlockMemory(block);
+		header->size = block->sizeFree;
+		header->free = 0;
+		header->block = u8(blockIndex);
+		header->prevSize = 0;
+		insertBlockIntoFreelist(region, header);
 	}
 
 	bool allocateNewBlock(MemoryRegion* region)
@@ -782,16 +1133,7 @@ namespace TFE_Memory
 		region->blockCount++;
 		TFE_System::logWrite(LOG_MSG, "MemoryRegion", "Allocated new memory block in region '%s' - new size is %u blocks, total size is '%u'", region->name, region->blockCount, region->blockSize * region->blockCount);
 
-		MemoryBlock* block = region->memBlocks[blockIndex];
-		block->sizeFree = u32(region->blockSize);
-		block->count = 1;
-
-		RegionAllocHeader* header = (RegionAllocHeader*)((u8*)block + sizeof(MemoryBlock));
-		header->size = block->sizeFree;
-		header->free = 0;
-		memset(block->freeListBins, 0, sizeof(AllocHeaderFree*)*ALLOC_BIN_COUNT);
-		insertBlockIntoFreelist(block, header);
-
+		resetBlock(region, s32(blockIndex));
 		return true;
 	}
 
@@ -801,6 +1143,140 @@ namespace TFE_Memory
 	#define ALLOC_COUNT 20000
 	const u64 _testAllocSize[] = { 16, 32, 24, 100, 200, 500, 327, 537, 200, 17, 57, 387, 874, 204, 100, 22 };
 
+	// Stress test - random alloc/realloc/free churn over a fixed number of live slots, which is similar to
+	// objects being spawned and freed over a long play session.
+	#define STRESS_SLOT_COUNT 8192
+	#define STRESS_OP_COUNT   500000
+
+	static u32 s_testSeed = 1;
+	static u32 test_random()
+	{
+		s_testSeed = s_testSeed * 1103515245u + 12345u;
+		return s_testSeed >> 8;
+	}
+
+	static u64 test_randomSize()
+	{
+		// Mostly small allocations with the occasional large one.
+		const u32 r = test_random();
+		return (r & 63) == 0 ? 4096 + (r >> 6) % 65536 : _testAllocSize[r & 15] + (r >> 4) % 64;
+	}
+
+	void region_stressTest()
+	{
+		void** slots = (void**)calloc(STRESS_SLOT_COUNT, sizeof(void*));
+
+		s_testSeed = 1;
+		u64 start = TFE_System::getCurrentTimeInTicks();
+		for (s32 i = 0; i < STRESS_OP_COUNT; i++)
+		{
+			const s32 s = test_random() % STRESS_SLOT_COUNT;
+			if (!slots[s])
+			{
+				slots[s] = malloc(test_randomSize());
+			}
+			else if (test_random() & 3)
+			{
+				free(slots[s]);
+				slots[s] = nullptr;
+			}
+			else
+			{
+				slots[s] = realloc(slots[s], test_randomSize());
+			}
+		}
+		u64 mallocDelta = TFE_System::getCurrentTimeInTicks() - start;
+		for (s32 i = 0; i < STRESS_SLOT_COUNT; i++)
+		{
+			free(slots[i]);
+			slots[i] = nullptr;
+		}
+
+		MemoryRegion* region = region_create("Stress", 8 * 1024 * 1024);
+		s_testSeed = 1;
+		start = TFE_System::getCurrentTimeInTicks();
+		for (s32 i = 0; i < STRESS_OP_COUNT; i++)
+		{
+			const s32 s = test_random() % STRESS_SLOT_COUNT;
+			if (!slots[s])
+			{
+				slots[s] = region_alloc(region, test_randomSize());
+			}
+			else if (test_random() & 3)
+			{
+				region_free(region, slots[s]);
+				slots[s] = nullptr;
+			}
+			else
+			{
+				slots[s] = region_realloc(region, slots[s], test_randomSize());
+			}
+		}
+		u64 regionDelta = TFE_System::getCurrentTimeInTicks() - start;
+
+		MemoryRegionStats stats;
+		region_getStats(region, &stats);
+		region_destroy(region);
+		free(slots);
+
+		TFE_System::logWrite(LOG_MSG, "MemoryRegion", "Stress - Malloc: %f, Region: %f", TFE_System::convertFromTicksToSeconds(mallocDelta), TFE_System::convertFromTicksToSeconds(regionDelta));
+		TFE_System::logWrite(LOG_MSG, "MemoryRegion", "Stress - Used: %zu, Free: %zu, Largest Free: %zu, Free Ranges: %u, Allocations: %u, Fragmentation: %0.3f",
+			stats.usedBytes, stats.freeBytes, stats.largestFree, stats.freeRanges, stats.allocCount, stats.fragmentation);
+	}
+
+	// Compare a full stream serialization against an in-memory snapshot of the same region.
+	void region_snapshotTest()
+	{
+		void** slots = (void**)calloc(STRESS_SLOT_COUNT, sizeof(void*));
+		MemoryRegion* region = region_create("Snapshot", 8 * 1024 * 1024);
+		s_testSeed = 7;
+		for (s32 i = 0; i < STRESS_OP_COUNT / 4; i++)
+		{
+			const s32 s = test_random() % STRESS_SLOT_COUNT;
+			if (slots[s]) { region_free(region, slots[s]); }
+			const u64 size = test_randomSize();
+			slots[s] = region_alloc(region, size);
+			memset(slots[s], s & 0xff, size_t(size));
+		}
+
+		MemoryStream stream;
+		stream.open(Stream::MODE_WRITE);
+		u64 start = TFE_System::getCurrentTimeInTicks();
+		region_serialize(region, &stream);
+		u64 serializeDelta = TFE_System::getCurrentTimeInTicks() - start;
+		stream.close();
+
+		// The first snapshot allocates its memory, later snapshots reuse it.
+		RegionSnapshot* snapshot = region_createSnapshot(region);
+		start = TFE_System::getCurrentTimeInTicks();
+		const bool captured = snapshot && region_createSnapshot(region, snapshot);
+		u64 snapshotDelta = TFE_System::getCurrentTimeInTicks() - start;
+
+		// Change the region, then roll it back.
+		for (s32 i = 0; i < STRESS_SLOT_COUNT; i += 2)
+		{
+			if (slots[i]) { memset(slots[i], 0xcd, 16); }
+			region_free(region, slots[i + 1]);
+		}
+		region_alloc(region, 4 * 1024 * 1024);
+		start = TFE_System::getCurrentTimeInTicks();
+		const bool restored = captured && region_restoreSnapshot(region, snapshot);
+		u64 restoreDelta = TFE_System::getCurrentTimeInTicks() - start;
+
+		s32 mismatchCount = 0;
+		for (s32 i = 0; restored && i < STRESS_SLOT_COUNT; i++)
+		{
+			if (slots[i] && *(u8*)slots[i] != u8(i & 0xff)) { mismatchCount++; }
+		}
+		TFE_System::logWrite(LOG_MSG, "MemoryRegion", "Snapshot - Serialize: %f, Snapshot: %f, Restore: %f, Size: %llu, Stream Size: %zu, Restored: %s, Mismatches: %d",
+			TFE_System::convertFromTicksToSeconds(serializeDelta), TFE_System::convertFromTicksToSeconds(snapshotDelta), TFE_System::convertFromTicksToSeconds(restoreDelta),
+			(unsigned long long)region_getSnapshotSize(snapshot), stream.getSize(), restored ? "yes" : "no", mismatchCount);
+
+		region_freeSnapshot(snapshot);
+		region_destroy(region);
+		free(slots);
+	}
+
 	void region_test()
 	{
 		u64 start = TFE_System::getCurrentTimeInTicks();
@@ -822,7 +1298,7 @@ namespace TFE_Memory
 			free(alloc[i]);
 		}
 
-		MemoryRegion* region = region_create("Test", 32 * 1024 * 1024);
+		MemoryRegion* region = region_create("Test", MAX_BLOCK_SIZE);
 		start = TFE_System::getCurrentTimeInTicks();
 		for (s32 i = 0; i < ALLOC_COUNT; i++)
 		{
@@ -838,5 +1314,8 @@ namespace TFE_Memory
 		region_destroy(region);
 
 		TFE_System::logWrite(LOG_MSG, "MemoryRegion", "Malloc: %f, Region: %f", TFE_System::convertFromTicksToSeconds(mallocDelta), TFE_System::convertFromTicksToSeconds(regionDelta));
+
+		region_stressTest();
+		region_snapshotTest();
 	}
-}
\ No newline at end of file
+}
@@ -5,16 +5,28 @@
 //////////////////////////////////////////////////////////////////////
 #include <TFE_System/types.h>
 #include <TFE_FileSystem/filestream.h>
+#include "allocTracker.h"
 #include <vector>
 #include <string>
 
 struct MemoryRegion;
+struct RegionSnapshot;
 typedef u32 RelativePointer;
 
 #define NULL_RELATIVE_POINTER 0
 
 namespace TFE_Memory
 {
+	struct MemoryRegionStats
+	{
+		u64 usedBytes;
+		u64 freeBytes;
+		u64 largestFree;	// Size of the largest free range, the largest allocation that fits without adding a block.
+		u32 freeRanges;
+		u32 allocCount;
+		f32 fragmentation;	// 1 - largestFree / freeBytes: 0 when all free memory is contiguous.
+	};
+
 	MemoryRegion* region_create(const char* name, u64 blockSize, u64 maxSize = 0u);
 	void region_clear(MemoryRegion* region);
 	void region_destroy(MemoryRegion* region);
@@ -26,15 +38,39 @@ namespace TFE_Memory
 	u64 region_getMemoryUsed(MemoryRegion* region);
 	u64 region_getMemoryCapacity(MemoryRegion* region);
 	void region_getBlockInfo(MemoryRegion* region, u64* blockCount, u64* blockSize);
+	void region_getStats(MemoryRegion* region, MemoryRegionStats* stats);
+
+	// Tags used to track allocations in the region and items sub-allocated from it (such as JEDI Allocator items).
+	AllocTag region_getAllocTag(MemoryRegion* region);
+	AllocTag region_getSubAllocTag(MemoryRegion* region);
 
 	RelativePointer region_getRelativePointer(MemoryRegion* region, void* ptr);
 	void* region_getRealPointer(MemoryRegion* region, RelativePointer ptr);
 
-	// TODO: Support writing to and restoring from streams in memory.
-	bool region_serializeToDisk(MemoryRegion* region, FileStream* file);
-	// Restore a region from disk. If 'region' is NULL then a new region is allocated,
+	// Write the region to a file or memory stream.
+	bool region_serialize(MemoryRegion* region, Stream* stream);
+	// Restore a region from a stream. If 'region' is NULL then a new region is allocated,
 	// otherwise it will attempt to reuse the existing region.
+	MemoryRegion* region_restore(MemoryRegion* region, Stream* stream);
+
+	bool region_serializeToDisk(MemoryRegion* region, FileStream* file);
 	MemoryRegion* region_restoreFromDisk(MemoryRegion* region, FileStream* file);
 
+	// In-memory snapshots, used for quick save/load style features.
+	// A snapshot copies the used part of each block with a single memcpy and records the block
+	// addresses. Blocks are never freed or moved while a region is alive, so restoring into the
+	// same region puts every allocation back at its original address: raw pointers into the region
+	// stay valid and relative pointers taken at any time remain valid as well.
+	// Pointers into the region held outside of it (such as globals) must be restored by the caller.
+	//
+	// Pass an existing snapshot to reuse its memory, otherwise a new snapshot is allocated.
+	// On failure NULL is returned, a snapshot that was passed in is left unchanged and still owned by the caller.
+	RegionSnapshot* region_createSnapshot(MemoryRegion* region, RegionSnapshot* snapshot = nullptr);
+	// Fails if the snapshot was taken from a different region or the blocks have been reallocated,
+	// blocks added after the snapshot was taken are kept but emptied.
+	bool region_restoreSnapshot(MemoryRegion* region, const RegionSnapshot* snapshot);
+	void region_freeSnapshot(RegionSnapshot* snapshot);
+	u64  region_getSnapshotSize(const RegionSnapshot* snapshot);
+
 	void region_test();
 }
\ No newline at end of file
@@ -533,6 +533,7 @@ namespace TFE_Settings
 				writeKeyValue_Bool(settings, "stepSecondAlt", s_gameSettings.df_stepSecondAlt);
 				writeKeyValue_Int(settings, "pitchLimit", s_gameSettings.df_pitchLimit);
 				writeKeyValue_Bool(settings, "solidWallFlagFix", s_gameSettings.df_solidWallFlagFix);
+				writeKeyValue_Bool(settings, "actorSimLod", s_gameSettings.df_actorSimLod);
 			}
 		}
 	}
@@ -1133,6 +1134,10 @@ namespace TFE_Settings
 		{
 			s_gameSettings.df_solidWallFlagFix = parseBool(value);
 		}
+		else if (strcasecmp("actorSimLod", key) == 0)
+		{
+			s_gameSettings.df_actorSimLod = parseBool(value);
+		}
 	}
 
 	void parseOutlawsSettings(const char* key, const char* value)
@@ -1309,6 +1314,15 @@ namespace TFE_Settings
 		}
 		return s_graphicsSettings.fix3doNormalOverflow;
 	}
+
+	bool actorSimLod()
+	{
+		if (s_modSettings.actorSimLod != MSO_NOT_SET)
+		{
+			return s_modSettings.actorSimLod == MSO_TRUE ? true : false;
+		}
+		return s_gameSettings.df_actorSimLod;
+	}
 		
 	//////////////////////////////////////////////////
 	// Mod Settings/Overrides.
@@ -1359,6 +1373,10 @@ namespace TFE_Settings
 		{
 			modSettings->normalFix3do = parseJSonBoolToOverride(tfeOverride);
 		}
+		else if (strcasecmp(tfeOverride->string, "actorSimLod") == 0)
+		{
+			modSettings->actorSimLod = parseJSonBoolToOverride(tfeOverride);
+		}
 	}
 
 	void parseJsonStringArray(const cJSON* item, std::vector<std::string>& stringList)
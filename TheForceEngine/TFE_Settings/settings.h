@@ -214,6 +214,7 @@ struct TFE_Settings_Game
 	bool df_ignoreInfLimit = true;		// Ignore the vanilla INF limit.
 	bool df_stepSecondAlt = false;		// Allow the player to step up onto second heights, similar to the way normal stairs work.
 	bool df_solidWallFlagFix = true;	// Solid wall flag is enforced for collision with moving walls.
+	bool df_actorSimLod = false;		// Update distant actors that are out of view at a reduced rate (for mods with very large actor counts).
 	PitchLimit df_pitchLimit  = PITCH_VANILLA_PLUS;
 };
 
@@ -291,6 +292,7 @@ struct TFE_ModSettings
 	ModSettingOverride extendAjoinLimits = MSO_NOT_SET;
 	ModSettingOverride ignore3doLimits   = MSO_NOT_SET;
 	ModSettingOverride normalFix3do      = MSO_NOT_SET;
+	ModSettingOverride actorSimLod       = MSO_NOT_SET;
 
 	std::vector<ModHdIgnoreList> ignoreList;
 };
@@ -327,6 +329,7 @@ namespace TFE_Settings
 	bool extendAdjoinLimits();
 	bool ignore3doLimits();
 	bool normalFix3do();
+	bool actorSimLod();
 
 	bool validatePath(const char* path, const char* sentinel);
 	void autodetectGamePaths();
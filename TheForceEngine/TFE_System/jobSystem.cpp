@@ -0,0 +1,496 @@
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cassert>
+#include <thread>
+#include <algorithm>
+#include <SDL.h>
+#include "jobSystem.h"
+#include "system.h"
+
+namespace TFE_Jobs
+{
+	enum JobConst : u32
+	{
+		JOB_QUEUE_SIZE = 1024,			// Per-thread deque and job pool size, must be a power of two.
+		JOB_QUEUE_MASK = JOB_QUEUE_SIZE - 1,
+		JOB_MAX_THREADS = 32,
+		JOB_MAX_ZONES = 16,				// Per-thread job names tracked for the profiler.
+		JOB_SPIN_COUNT = 64,			// Attempts to find work before a worker goes to sleep.
+		JOB_SLEEP_TIMEOUT_MS = 10,
+	};
+
+	struct Job
+	{
+		JobFunc func;
+		void* userData;
+		u32 begin;
+		u32 end;
+		JobCounter* counter;
+		const char* name;
+		std::atomic<u32> pending;
+	};
+
+	// Chase-Lev work-stealing deque with a fixed capacity.
+	// The owning thread pushes and pops at the bottom, other threads steal from the top.
+	struct JobDeque
+	{
+		std::atomic<s64> top;
+		std::atomic<s64> bottom;
+		std::atomic<Job*> jobs[JOB_QUEUE_SIZE];
+	};
+
+	struct JobZone
+	{
+		std::atomic<const char*> name;
+		std::atomic<u32> jobCount;
+		std::atomic<u64> ticks;
+	};
+
+	struct JobThread
+	{
+		char name[32];
+		JobDeque deque;
+		Job pool[JOB_QUEUE_SIZE];
+		u32 poolNext;
+		SDL_Thread* thread;
+
+		// Written by the owning thread, latched by jobs_beginFrame().
+		std::atomic<u32> jobCount;
+		std::atomic<u32> stealCount;
+		std::atomic<u64> busyTicks;
+		std::atomic<u32> zoneCount;
+		JobZone zones[JOB_MAX_ZONES];
+
+		JobThreadStats stats;
+		JobZoneStats zoneStats[JOB_MAX_ZONES];
+	};
+
+	static JobThread* s_threads[JOB_MAX_THREADS] = { nullptr };
+	static u32 s_threadCount = 0;
+	static thread_local s32 s_threadIndex = -1;
+
+	static std::atomic<bool> s_quit{ false };
+	static std::atomic<s32> s_queuedJobs{ 0 };
+	static std::atomic<s32> s_sleepingWorkers{ 0 };
+	static SDL_sem* s_wakeSem = nullptr;
+
+	/////////////////////////////////////////////
+	// Deque
+	/////////////////////////////////////////////
+	static bool deque_push(JobDeque* deque, Job* job)
+	{
+		const s64 b = deque->bottom.load(std::memory_order_relaxed);
+		const s64 t = deque->top.load(std::memory_order_acquire);
+		if (b - t >= JOB_QUEUE_SIZE) { return false; }
+
+		deque->jobs[b & JOB_QUEUE_MASK].store(job, std::memory_order_release);
+		std::atomic_thread_fence(std::memory_order_release);
+		deque->bottom.store(b + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	static Job* deque_pop(JobDeque* deque)
+	{
+		const s64 b = deque->bottom.load(std::memory_order_relaxed) - 1;
+		deque->bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		s64 t = deque->top.load(std::memory_order_relaxed);
+
+		if (t > b)
+		{
+			// Empty.
+			deque->bottom.store(b + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		Job* job = deque->jobs[b & JOB_QUEUE_MASK].load(std::memory_order_relaxed);
+		if (t == b)
+		{
+			// Last job, race against thieves.
+			if (!deque->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				job = nullptr;
+			}
+			deque->bottom.store(b + 1, std::memory_order_relaxed);
+		}
+		return job;
+	}
+
+	static Job* deque_steal(JobDeque* deque)
+	{
+		s64 t = deque->top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const s64 b = deque->bottom.load(std::memory_order_acquire);
+		if (t >= b) { return nullptr; }
+
+		Job* job = deque->jobs[t & JOB_QUEUE_MASK].load(std::memory_order_acquire);
+		if (!deque->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			return nullptr;
+		}
+		return job;
+	}
+
+	/////////////////////////////////////////////
+	// Execution
+	/////////////////////////////////////////////
+	static void job_recordZone(JobThread* thread, const char* name, u64 ticks)
+	{
+		const u32 zoneCount = thread->zoneCount.load(std::memory_order_relaxed);
+		for (u32 z = 0; z < zoneCount; z++)
+		{
+			if (thread->zones[z].name.load(std::memory_order_relaxed) == name)
+			{
+				thread->zones[z].jobCount.fetch_add(1, std::memory_order_relaxed);
+				thread->zones[z].ticks.fetch_add(ticks, std::memory_order_relaxed);
+				return;
+			}
+		}
+		if (zoneCount < JOB_MAX_ZONES)
+		{
+			thread->zones[zoneCount].name.store(name, std::memory_order_relaxed);
+			thread->zones[zoneCount].jobCount.store(1, std::memory_order_relaxed);
+			thread->zones[zoneCount].ticks.store(ticks, std::memory_order_relaxed);
+			thread->zoneCount.store(zoneCount + 1, std::memory_order_release);
+		}
+	}
+
+	static void job_execute(Job* job, JobThread* thread)
+	{
+		const u64 start = TFE_System::getCurrentTimeInTicks();
+		job->func(job->userData, job->begin, job->end);
+		const u64 ticks = TFE_System::getCurrentTimeInTicks() - start;
+
+		if (thread)
+		{
+			thread->jobCount.fetch_add(1, std::memory_order_relaxed);
+			thread->busyTicks.fetch_add(ticks, std::memory_order_relaxed);
+			job_recordZone(thread, job->name, ticks);
+		}
+		JobCounter* counter = job->counter;
+		job->pending.store(0, std::memory_order_release);
+		if (counter)
+		{
+			counter->count.fetch_sub(1, std::memory_order_acq_rel);
+		}
+	}
+
+	// Pop from the thread's own deque first, then try to steal from the others.
+	static Job* job_find(u32 threadIndex)
+	{
+		JobThread* thread = s_threads[threadIndex];
+		Job* job = deque_pop(&thread->deque);
+		if (!job)
+		{
+			for (u32 i = 1; i < s_threadCount && !job; i++)
+			{
+				job = deque_steal(&s_threads[(threadIndex + i) % s_threadCount]->deque);
+			}
+			if (job) { thread->stealCount.fetch_add(1, std::memory_order_relaxed); }
+		}
+		if (job) { s_queuedJobs.fetch_sub(1, std::memory_order_relaxed); }
+		return job;
+	}
+
+	static s32 job_workerFunc(void* userData)
+	{
+		const u32 threadIndex = u32(size_t(userData));
+		s_threadIndex = s32(threadIndex);
+		JobThread* thread = s_threads[threadIndex];
+
+		u32 spinCount = 0;
+		while (!s_quit.load(std::memory_order_acquire))
+		{
+			Job* job = job_find(threadIndex);
+			if (job)
+			{
+				job_execute(job, thread);
+				spinCount = 0;
+				continue;
+			}
+			if (++spinCount < JOB_SPIN_COUNT)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			// Go to sleep, checking for jobs queued while going to sleep.
+			s_sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+			if (s_queuedJobs.load(std::memory_order_seq_cst) <= 0 && !s_quit.load(std::memory_order_acquire))
+			{
+				SDL_SemWaitTimeout(s_wakeSem, JOB_SLEEP_TIMEOUT_MS);
+			}
+			s_sleepingWorkers.fetch_sub(1, std::memory_order_seq_cst);
+			spinCount = 0;
+		}
+		return 0;
+	}
+
+	static JobThread* job_createThread(u32 index)
+	{
+		JobThread* thread = new JobThread();
+		if (index == 0) { strcpy(thread->name, "Main"); }
+		else { snprintf(thread->name, sizeof(thread->name), "Worker %u", index); }
+
+		thread->deque.top = 0;
+		thread->deque.bottom = 0;
+		thread->poolNext = 0;
+		thread->thread = nullptr;
+		thread->jobCount = 0;
+		thread->stealCount = 0;
+		thread->busyTicks = 0;
+		thread->zoneCount = 0;
+		for (u32 i = 0; i < JOB_QUEUE_SIZE; i++)
+		{
+			thread->deque.jobs[i] = nullptr;
+			thread->pool[i].pending = 0;
+		}
+		memset(&thread->stats, 0, sizeof(JobThreadStats));
+		memset(thread->zoneStats, 0, sizeof(thread->zoneStats));
+		thread->stats.name = thread->name;
+		return thread;
+	}
+
+	/////////////////////////////////////////////
+	// API
+	/////////////////////////////////////////////
+	void jobs_init(s32 workerCount)
+	{
+		if (s_threadCount) { return; }
+		if (workerCount < 0)
+		{
+			workerCount = std::max(0, SDL_GetCPUCount() - 1);
+		}
+		workerCount = std::min(workerCount, s32(JOB_MAX_THREADS - 1));
+
+		s_quit = false;
+		s_queuedJobs = 0;
+		s_sleepingWorkers = 0;
+		s_wakeSem = SDL_CreateSemaphore(0);
+
+		// The main thread is thread 0.
+		s_threads[0] = job_createThread(0);
+		s_threadIndex = 0;
+		s_threadCount = workerCount + 1;
+		for (s32 i = 1; i <= workerCount; i++)
+		{
+			s_threads[i] = job_createThread(i);
+		}
+		// Start the workers once all of the threads exist, since they steal from each other.
+		for (s32 i = 1; i <= workerCount; i++)
+		{
+			s_threads[i]->thread = SDL_CreateThread(job_workerFunc, "TFE_JobWorker", (void*)size_t(i));
+			if (!s_threads[i]->thread)
+			{
+				TFE_System::logWrite(LOG_ERROR, "Jobs", "Failed to create worker thread %d: %s", i, SDL_GetError());
+			}
+		}
+		TFE_System::logWrite(LOG_MSG, "Jobs", "Job system started with %d worker threads.", workerCount);
+	}
+
+	void jobs_shutdown()
+	{
+		if (!s_threadCount) { return; }
+
+		s_quit = true;
+		for (u32 i = 1; i < s_threadCount; i++)
+		{
+			SDL_SemPost(s_wakeSem);
+		}
+		for (u32 i = 1; i < s_threadCount; i++)
+		{
+			if (s_threads[i]->thread) { SDL_WaitThread(s_threads[i]->thread, nullptr); }
+		}
+		for (u32 i = 0; i < s_threadCount; i++)
+		{
+			delete s_threads[i];
+			s_threads[i] = nullptr;
+		}
+		SDL_DestroySemaphore(s_wakeSem);
+		s_wakeSem = nullptr;
+		s_threadCount = 0;
+		s_threadIndex = -1;
+	}
+
+	u32 jobs_getWorkerCount()
+	{
+		return s_threadCount ? s_threadCount - 1 : 0;
+	}
+
+	void jobs_submit(const char* name, JobFunc func, void* userData, JobCounter* counter, u32 begin, u32 end)
+	{
+		if (!jobs_trySubmit(name, func, userData, counter, begin, end))
+		{
+			// Not part of the job system or the queue is full, run it now.
+			Job job;
+			job.func = func;
+			job.userData = userData;
+			job.begin = begin;
+			job.end = end;
+			job.counter = nullptr;
+			job.name = name;
+			job.pending.store(1, std::memory_order_relaxed);
+			job_execute(&job, (s_threadIndex >= 0 && s_threadCount) ? s_threads[s_threadIndex] : nullptr);
+		}
+	}
+
+	bool jobs_trySubmit(const char* name, JobFunc func, void* userData, JobCounter* counter, u32 begin, u32 end)
+	{
+		JobThread* thread = (s_threadIndex >= 0 && s_threadCount) ? s_threads[s_threadIndex] : nullptr;
+		if (!thread) { return false; }
+
+		// Job slots are reused round-robin, a slot that is still pending means too many jobs are in flight.
+		Job* job = &thread->pool[thread->poolNext & JOB_QUEUE_MASK];
+		if (job->pending.load(std::memory_order_acquire)) { return false; }
+
+		job->func = func;
+		job->userData = userData;
+		job->begin = begin;
+		job->end = end;
+		job->counter = counter;
+		job->name = name;
+		job->pending.store(1, std::memory_order_relaxed);
+		if (counter) { counter->count.fetch_add(1, std::memory_order_relaxed); }
+
+		if (!deque_push(&thread->deque, job))
+		{
+			job->pending.store(0, std::memory_order_relaxed);
+			if (counter) { counter->count.fetch_sub(1, std::memory_order_relaxed); }
+			return false;
+		}
+		thread->poolNext++;
+		s_queuedJobs.fetch_add(1, std::memory_order_seq_cst);
+		if (s_sleepingWorkers.load(std::memory_order_seq_cst) > 0)
+		{
+			SDL_SemPost(s_wakeSem);
+		}
+		return true;
+	}
+
+	void jobs_wait(JobCounter* counter)
+	{
+		while (counter->count.load(std::memory_order_acquire) > 0)
+		{
+			Job* job = (s_threadIndex >= 0 && s_threadCount) ? job_find(u32(s_threadIndex)) : nullptr;
+			if (job)
+			{
+				job_execute(job, s_threads[s_threadIndex]);
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void jobs_parallelFor(const char* name, u32 count, u32 batchSize, JobFunc func, void* userData)
+	{
+		if (!count) { return; }
+		if (!batchSize)
+		{
+			// A few batches per thread, so threads that finish early can steal the rest.
+			const u32 threadCount = std::max(1u, s_threadCount);
+			batchSize = std::max(1u, count / (threadCount * 4));
+		}
+
+		JobCounter counter;
+		for (u32 begin = 0; begin < count; begin += batchSize)
+		{
+			jobs_submit(name, func, userData, &counter, begin, std::min(count, begin + batchSize));
+		}
+		jobs_wait(&counter);
+	}
+
+	void jobs_beginFrame()
+	{
+		for (u32 i = 0; i < s_threadCount; i++)
+		{
+			JobThread* thread = s_threads[i];
+			thread->stats.jobCount = thread->jobCount.exchange(0, std::memory_order_relaxed);
+			thread->stats.stealCount = thread->stealCount.exchange(0, std::memory_order_relaxed);
+			thread->stats.busyMs = TFE_System::convertFromTicksToSeconds(thread->busyTicks.exchange(0, std::memory_order_relaxed)) * 1000.0;
+
+			const u32 zoneCount = thread->zoneCount.load(std::memory_order_acquire);
+			for (u32 z = 0; z < zoneCount; z++)
+			{
+				thread->zoneStats[z].name = thread->zones[z].name.load(std::memory_order_relaxed);
+				thread->zoneStats[z].jobCount = thread->zones[z].jobCount.exchange(0, std::memory_order_relaxed);
+				thread->zoneStats[z].timeMs = TFE_System::convertFromTicksToSeconds(thread->zones[z].ticks.exchange(0, std::memory_order_relaxed)) * 1000.0;
+			}
+			thread->stats.zoneCount = zoneCount;
+		}
+	}
+
+	u32 jobs_getThreadCount()
+	{
+		return s_threadCount;
+	}
+
+	bool jobs_getThreadStats(u32 thread, JobThreadStats* stats)
+	{
+		if (thread >= s_threadCount) { return false; }
+		*stats = s_threads[thread]->stats;
+		return true;
+	}
+
+	bool jobs_getZoneStats(u32 thread, u32 zone, JobZoneStats* stats)
+	{
+		if (thread >= s_threadCount || zone >= s_threads[thread]->stats.zoneCount) { return false; }
+		*stats = s_threads[thread]->zoneStats[zone];
+		return true;
+	}
+
+	/////////////////////////////////////////////
+	// Benchmark
+	/////////////////////////////////////////////
+	#define BENCH_ELEM_COUNT (1u << 20)
+	#define BENCH_ITER_COUNT 64
+	#define BENCH_RUN_COUNT 5
+
+	static void bench_job(void* userData, u32 begin, u32 end)
+	{
+		u32* output = (u32*)userData;
+		for (u32 i = begin; i < end; i++)
+		{
+			u32 x = i + 1;
+			for (u32 k = 0; k < BENCH_ITER_COUNT; k++)
+			{
+				x ^= x << 13;
+				x ^= x >> 17;
+				x ^= x << 5;
+			}
+			output[i] = x;
+		}
+	}
+
+	void jobs_benchmark()
+	{
+		const bool wasRunning = s_threadCount > 0;
+		const s32 prevWorkerCount = s32(jobs_getWorkerCount());
+		const s32 cpuCount = SDL_GetCPUCount();
+		const u32 maxThreads = std::max(1u, std::min(u32(cpuCount), u32(JOB_MAX_THREADS)));
+		u32* output = (u32*)malloc(sizeof(u32) * BENCH_ELEM_COUNT);
+
+		f64 baseTime = 0.0;
+		for (u32 threadCount = 1; threadCount <= maxThreads; threadCount++)
+		{
+			jobs_shutdown();
+			jobs_init(s32(threadCount) - 1);
+
+			f64 bestTime = 0.0;
+			for (u32 r = 0; r < BENCH_RUN_COUNT; r++)
+			{
+				const u64 start = TFE_System::getCurrentTimeInTicks();
+				jobs_parallelFor("Benchmark", BENCH_ELEM_COUNT, 0, bench_job, output);
+				const f64 time = TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - start);
+				if (r == 0 || time < bestTime) { bestTime = time; }
+			}
+			if (threadCount == 1) { baseTime = bestTime; }
+			TFE_System::logWrite(LOG_MSG, "Jobs", "Benchmark - %2u threads: %8.3fms, speedup %5.2fx", threadCount, bestTime * 1000.0, baseTime / bestTime);
+		}
+		free(output);
+
+		jobs_shutdown();
+		if (wasRunning) { jobs_init(prevWorkerCount); }
+	}
+}
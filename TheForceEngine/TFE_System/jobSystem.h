@@ -0,0 +1,75 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Job System
+// Work-stealing job system shared by the engine.
+//
+// * Each thread (the main thread and each worker) owns a lock-free
+//   deque. Jobs are pushed to and popped from the submitting thread's
+//   deque, idle workers steal from the other end of other deques.
+// * Completion is tracked with job counters: each submitted job adds
+//   one to its counter and removes one when it finishes.
+//   jobs_wait() runs pending jobs on the calling thread until the
+//   counter reaches zero, so the main thread assists rather than
+//   blocking.
+// * Jobs may submit and wait on other jobs.
+// * Jobs submitted from threads that are not part of the job system,
+//   or before jobs_init(), are executed immediately.
+//
+// Profiler zones are only recorded on the main thread, so job time is
+// tracked per thread and per job name by the job system instead.
+//////////////////////////////////////////////////////////////////////
+#include "types.h"
+#include <atomic>
+
+namespace TFE_Jobs
+{
+	// Jobs process the index range [begin, end).
+	typedef void(*JobFunc)(void* userData, u32 begin, u32 end);
+
+	struct JobCounter
+	{
+		std::atomic<s32> count{ 0 };
+	};
+
+	struct JobZoneStats
+	{
+		const char* name;
+		u32 jobCount;
+		f64 timeMs;
+	};
+
+	struct JobThreadStats
+	{
+		const char* name;
+		u32 jobCount;		// Jobs executed on this thread in the previous frame.
+		u32 stealCount;		// Jobs stolen from other threads in the previous frame.
+		f64 busyMs;			// Time spent executing jobs in the previous frame.
+		u32 zoneCount;
+	};
+
+	// Start the worker threads, a negative count uses one less than the number of logical CPUs.
+	void jobs_init(s32 workerCount = -1);
+	// Must be called from the main thread, with no jobs in flight.
+	void jobs_shutdown();
+	u32  jobs_getWorkerCount();
+
+	// 'name' must be a string literal (or otherwise outlive the job system), it is used to tag the job time.
+	void jobs_submit(const char* name, JobFunc func, void* userData, JobCounter* counter, u32 begin = 0, u32 end = 1);
+	// Same as jobs_submit() but returns false instead of running the job on the calling thread when it cannot be queued.
+	bool jobs_trySubmit(const char* name, JobFunc func, void* userData, JobCounter* counter, u32 begin = 0, u32 end = 1);
+	// Wait until the counter reaches zero, executing pending jobs in the meantime.
+	void jobs_wait(JobCounter* counter);
+	// Split [0, count) into batches of 'batchSize' (0 = automatic) and wait for all of them to complete.
+	void jobs_parallelFor(const char* name, u32 count, u32 batchSize, JobFunc func, void* userData);
+
+	// Latch the per-thread stats, called once per frame by the main loop.
+	void jobs_beginFrame();
+	// Thread 0 is the main thread.
+	u32  jobs_getThreadCount();
+	bool jobs_getThreadStats(u32 thread, JobThreadStats* stats);
+	bool jobs_getZoneStats(u32 thread, u32 zone, JobZoneStats* stats);
+
+	// Scaling benchmark: runs the same workload with 1..N threads and logs the results.
+	// Restarts the workers, so it must be called from the main thread with no jobs in flight.
+	void jobs_benchmark();
+}
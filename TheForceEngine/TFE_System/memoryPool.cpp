@@ -4,7 +4,7 @@
 #include <TFE_System/system.h>
 #include <algorithm>
 
-MemoryPool::MemoryPool() : m_poolSize(0), m_waterMark(0), m_ptr(0) {}
+MemoryPool::MemoryPool() : m_poolSize(0), m_waterMark(0), m_ptr(0), m_allocTag(TFE_Memory::ALLOC_TAG_HEAP) {}
 
 void MemoryPool::init(size_t poolSize, const char* name)
 {
@@ -15,12 +15,21 @@ void MemoryPool::init(size_t poolSize, const char* name)
 		m_memory.resize(poolSize);
 
 		TFE_System::logWrite(LOG_MSG, "MemoryPool", "Allocating memory pool \"%s\", size %u bytes.", name, poolSize);
+
+		// The pool memory itself is tracked as heap memory, so allocations from it are a child of the heap tag.
+		char tagName[32];
+		snprintf(tagName, sizeof(tagName), "Pool: %s", name);
+		m_allocTag = TFE_Memory::allocTracker_registerTag(tagName, TFE_Memory::ALLOC_TAG_HEAP);
 	}
 	clear();
 }
 
 void MemoryPool::clear()
 {
+	if (m_allocTag != TFE_Memory::ALLOC_TAG_HEAP)
+	{
+		TFE_Memory::allocTracker_clearTag(m_allocTag);
+	}
 	m_ptr = 0u;
 }
 
@@ -42,6 +51,7 @@ void* MemoryPool::allocate(size_t size)
 
 	u8* memory = m_memory.data() + m_ptr;
 	m_ptr += size;
+	TFE_TRACK_ALLOC(m_allocTag, size);
 
 	return memory;
 }
@@ -5,6 +5,7 @@
 //////////////////////////////////////////////////////////////////////
 
 #include "types.h"
+#include <TFE_Memory/allocTracker.h>
 #include <vector>
 #include <string>
 
@@ -32,4 +33,5 @@ private:
 	size_t m_poolSize;
 	size_t m_waterMark;
 	size_t m_ptr;
+	TFE_Memory::AllocTag m_allocTag;
 };
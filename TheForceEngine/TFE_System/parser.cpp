@@ -1,8 +1,10 @@
+#include <climits>
 #include <cstring>
 
 #include "parser.h"
 #include <assert.h>
 #include <algorithm>
+#include <cstdlib>
 
 namespace
 {
@@ -24,6 +26,28 @@ namespace
 		}
 		return false;
 	}
+
+	// Whitespace as defined by sscanf().
+	bool isSpace(const char c)
+	{
+		return c == ' ' || (c >= '\t' && c <= '\r');
+	}
+
+	bool isDigit(const char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	const char* skipSpace(const char* str)
+	{
+		while (isSpace(*str)) { str++; }
+		return str;
+	}
+
+	// Powers of ten that are exact in single precision.
+	static const f32 c_pow10[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+	// Integers up to this value are exact in single precision.
+	static const u32 c_maxExactMantissa = 1u << 24u;
 }
 
 TFE_Parser::TFE_Parser() : m_buffer(nullptr), m_bufferLen(0u), m_enableBlockComments(false), m_blockComment(false), m_enableColonSeperator(false), m_convertToUppercase(false) {}
@@ -230,3 +254,150 @@ void TFE_Parser::tokenizeLine(const char* line, TokenList& tokens)
 		tokens.push_back(curToken);
 	}
 }
+
+s32 TFE_Parser::tokenizeLine(const char* line, TokenView* tokens, s32 maxTokens)
+{
+	s32 count = 0;
+	const char* tokenStart = nullptr;
+	bool inQuote = false;
+	for (const char* c = line; *c && count < maxTokens; c++)
+	{
+		if (inQuote)
+		{
+			// The closing quote ends the token, even if it is empty.
+			if (*c == '"')
+			{
+				tokens[count++] = { tokenStart, u32(c - tokenStart) };
+				tokenStart = nullptr;
+				inQuote = false;
+			}
+		}
+		else if (*c == '"' && !tokenStart)
+		{
+			tokenStart = c + 1;
+			inQuote = true;
+		}
+		else if (isWhitespace(*c) || isSeparator(*c) || (m_enableColonSeperator && *c == ':'))
+		{
+			if (tokenStart)
+			{
+				tokens[count++] = { tokenStart, u32(c - tokenStart) };
+				tokenStart = nullptr;
+			}
+		}
+		else if (!tokenStart)
+		{
+			tokenStart = c;
+		}
+	}
+	if (tokenStart && count < maxTokens)
+	{
+		tokens[count++] = { tokenStart, u32(strlen(tokenStart)) };
+	}
+	return count;
+}
+
+bool TFE_Parser::parseInt(const char*& str, s32* value)
+{
+	const char* c = skipSpace(str);
+	const bool negative = *c == '-';
+	if (*c == '-' || *c == '+') { c++; }
+	if (!isDigit(*c)) { return false; }
+
+	s64 result = 0;
+	for (; isDigit(*c); c++)
+	{
+		result = result * 10 + (*c - '0');
+		if (result > INT_MAX) { result = INT_MAX; }
+	}
+	*value = s32(negative ? -result : result);
+	str = c;
+	return true;
+}
+
+bool TFE_Parser::parseFloat(const char*& str, f32* value)
+{
+	const char* start = skipSpace(str);
+	const char* c = start;
+	const bool negative = *c == '-';
+	if (*c == '-' || *c == '+') { c++; }
+
+	// Common case: a short decimal number, which can be converted with a single (correctly rounded) multiply or divide.
+	u32 mantissa = 0;
+	s32 exponent = 0;
+	bool exact = true;
+	bool hasDigits = false;
+	for (; isDigit(*c); c++)
+	{
+		hasDigits = true;
+		if (mantissa >= c_maxExactMantissa / 10) { exact = false; }
+		else { mantissa = mantissa * 10 + (*c - '0'); }
+	}
+	if (*c == '.')
+	{
+		c++;
+		for (; isDigit(*c); c++)
+		{
+			hasDigits = true;
+			if (mantissa >= c_maxExactMantissa / 10) { exact = false; }
+			else { mantissa = mantissa * 10 + (*c - '0'); exponent--; }
+		}
+	}
+	// Exponents, hex, infinity and nan are left to strtof(), as are numbers with too many digits.
+	if (hasDigits && exact && exponent >= -10 && *c != 'e' && *c != 'E' && *c != 'x' && *c != 'X')
+	{
+		const f32 result = exponent ? f32(mantissa) / c_pow10[-exponent] : f32(mantissa);
+		*value = negative ? -result : result;
+		str = c;
+		return true;
+	}
+
+	char* end = nullptr;
+	const f32 result = strtof(start, &end);
+	if (end == start) { return false; }
+	*value = result;
+	str = end;
+	return true;
+}
+
+bool TFE_Parser::parseWord(const char*& str, char* word, size_t wordSize)
+{
+	const char* c = skipSpace(str);
+	if (!*c || wordSize < 2) { return false; }
+
+	size_t len = 0;
+	for (; *c && !isSpace(*c); c++)
+	{
+		if (len + 1 < wordSize) { word[len++] = *c; }
+	}
+	word[len] = 0;
+	str = c;
+	return true;
+}
+
+bool TFE_Parser::matchLiteral(const char*& str, const char* literal)
+{
+	const char* c = str;
+	for (; *literal; literal++)
+	{
+		if (isSpace(*literal))
+		{
+			c = skipSpace(c);
+		}
+		else if (*c == *literal)
+		{
+			c++;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	str = c;
+	return true;
+}
+
+bool TFE_Parser::tokenEquals(const TokenView& token, const char* str)
+{
+	return strncasecmp(token.str, str, token.len) == 0 && str[token.len] == 0;
+}
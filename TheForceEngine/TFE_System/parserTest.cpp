@@ -0,0 +1,88 @@
+#include <cstring>
+
+#include "parserTest.h"
+#include "parser.h"
+#include "system.h"
+#include <cstdio>
+#include <cstdlib>
+
+void parser_test(u32 lineCount)
+{
+	if (!lineCount) { return; }
+
+	// Generate 3DO style vertex lines.
+	std::string text;
+	text.reserve(lineCount * 40);
+	char line[256];
+	u32 seed = 0x1234567u;
+	for (u32 i = 0; i < lineCount; i++)
+	{
+		f32 v[3];
+		for (s32 c = 0; c < 3; c++)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			v[c] = f32(s32(seed >> 8) % 2000000 - 1000000) / 10000.0f;
+		}
+		snprintf(line, sizeof(line), "    %u: %.4f %.4f %.4f # vertex\r\n", i, v[0], v[1], v[2]);
+		text += line;
+	}
+
+	TFE_Parser parser;
+	parser.init(text.data(), text.size());
+	parser.addCommentString("#");
+
+	// Method 0 only reads the lines, the cost shared by every method.
+	// Each method sums the bits of the parsed values, so the results can be compared exactly.
+	u64 checksum[3] = { 0 };
+	f64 timeMs[4];
+	for (s32 method = 0; method < 4; method++)
+	{
+		size_t bufferPos = 0;
+		TokenList tokenList;
+		TokenView tokens[8];
+		u64 sum = 0;
+
+		const u64 start = TFE_System::getCurrentTimeInTicks();
+		const char* buffer;
+		while ((buffer = parser.readLine(bufferPos)) != nullptr)
+		{
+			s32 index = 0;
+			f32 x[3] = { 0 };
+			if (method == 1)
+			{
+				sscanf(buffer, " %d: %f %f %f", &index, &x[0], &x[1], &x[2]);
+			}
+			else if (method == 2)
+			{
+				parser.tokenizeLine(buffer, tokenList);
+				if (tokenList.size() < 4) { continue; }
+				index = strtol(tokenList[0].c_str(), nullptr, 10);
+				for (s32 c = 0; c < 3; c++) { x[c] = strtof(tokenList[1 + c].c_str(), nullptr); }
+			}
+			else if (method == 3)
+			{
+				if (parser.tokenizeLine(buffer, tokens, 8) < 4) { continue; }
+				const char* value = tokens[0].str;
+				TFE_Parser::parseInt(value, &index);
+				for (s32 c = 0; c < 3; c++)
+				{
+					value = tokens[1 + c].str;
+					TFE_Parser::parseFloat(value, &x[c]);
+				}
+			}
+
+			u32 bits[3];
+			memcpy(bits, x, sizeof(bits));
+			sum += u64(index) + bits[0] + bits[1] + bits[2];
+		}
+		timeMs[method] = 1000.0 * TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - start);
+		if (method) { checksum[method - 1] = sum; }
+	}
+
+	if (checksum[0] != checksum[1] || checksum[0] != checksum[2])
+	{
+		TFE_System::logWrite(LOG_ERROR, "Parser Test", "The tokenizers did not read the same values as sscanf().");
+	}
+	TFE_System::logWrite(LOG_MSG, "Parser Test", "%u vertex lines, %.1f KB. readLine only: %.3f ms, sscanf: %.3f ms, TokenList + strtod: %.3f ms, TokenView + parse: %.3f ms.",
+		lineCount, f64(text.size()) / 1024.0, timeMs[0], timeMs[1], timeMs[2], timeMs[3]);
+}
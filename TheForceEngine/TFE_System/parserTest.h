@@ -0,0 +1,9 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Parser test, not called by the engine. See main.cpp to run it.
+//////////////////////////////////////////////////////////////////////
+#include "types.h"
+
+// Parses generated 3DO style vertex lines with sscanf(), the allocating and the non-allocating tokenizers,
+// verifies that they read the same values and logs the time taken by each.
+void parser_test(u32 lineCount = 200000);
@@ -6,6 +6,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <thread>
 
 // TODO: Support call "paths" - with seperate time per path.
 
@@ -64,6 +65,8 @@ namespace TFE_Profiler
 	static u32 s_zoneStack[MAX_ZONE_STACK];
 	static u64 s_currentFrame = 1;
 	static u64 s_currentPath;
+	// Zones are only recorded on the thread that runs the frame, zones on job threads are ignored.
+	static std::thread::id s_profileThread;
 
 	void addZoneChild(u32 parentId, u32 zoneId)
 	{
@@ -104,6 +107,8 @@ namespace TFE_Profiler
 
 	u32 beginZone(const char* name, const char* func, u32 lineNumber)
 	{
+		if (std::this_thread::get_id() != s_profileThread) { return NULL_ZONE; }
+
 		ZoneMap::iterator iZone = s_zoneMap.find(name);
 		u32 id = 0;
 
@@ -152,6 +157,7 @@ namespace TFE_Profiler
 
 	void endZone(u32 id, u64 dt)
 	{
+		if (id == NULL_ZONE) { return; }
 		s_zoneList[id].timeInZone[s_writeBuffer] += TFE_System::convertFromTicksToSeconds(dt);
 		s_level--;
 	}
@@ -176,6 +182,7 @@ namespace TFE_Profiler
 
 	void frameBegin()
 	{
+		s_profileThread = std::this_thread::get_id();
 		std::swap(s_readBuffer, s_writeBuffer);
 		// Validate buffer indices.
 		assert(s_readBuffer < ZONE_BUFFER_COUNT && s_writeBuffer < ZONE_BUFFER_COUNT && s_readBuffer != s_writeBuffer);
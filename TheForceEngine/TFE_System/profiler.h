@@ -4,6 +4,8 @@
 // Simple "zone" based profiler.
 // Add TFE_PROFILE_ENABLED to preprocessor defines in the build to enable.
 // Currently does not respect the call path, that is TODO.
+// Zones are only recorded on the main thread (the thread calling
+// TFE_FRAME_BEGIN), see the job system for per-thread job timing.
 //////////////////////////////////////////////////////////////////////
 
 #include "types.h"
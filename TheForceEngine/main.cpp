@@ -4,12 +4,15 @@
 #include <TFE_System/types.h>
 #include <TFE_System/profiler.h>
 #include <TFE_Memory/memoryRegion.h>
+#include <TFE_Memory/frameArena.h>
+#include <TFE_Memory/allocTracker.h>
 #include <TFE_Archive/gobArchive.h>
 #include <TFE_Game/igame.h>
 #include <TFE_Game/saveSystem.h>
 #include <TFE_Game/reticle.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
 #include <TFE_FileSystem/fileutil.h>
+#include <TFE_FileSystem/filewriterAsync.h>
 #include <TFE_Audio/audioSystem.h>
 #include <TFE_FileSystem/paths.h>
 #include <TFE_Polygon/polygon.h>
@@ -20,10 +23,13 @@
 #include <TFE_System/CrashHandler/crashHandler.h>
 #include <TFE_System/frameLimiter.h>
 #include <TFE_System/tfeMessage.h>
+#include <TFE_System/jobSystem.h>
+#include <TFE_System/parserTest.h>
 #include <TFE_Jedi/Task/task.h>
 #include <TFE_RenderShared/texturePacker.h>
 #include <TFE_Asset/paletteAsset.h>
 #include <TFE_Asset/imageAsset.h>
+#include <TFE_Asset/dfKeywords.h>
 #include <TFE_Ui/ui.h>
 #include <TFE_FrontEndUI/frontEndUi.h>
 #include <TFE_FrontEndUI/modLoader.h>
@@ -616,6 +622,8 @@ int main(int argc, char* argv[])
 	TFE_Settings_Window* windowSettings = TFE_Settings::getWindowSettings();
 	TFE_Settings_Graphics* graphics = TFE_Settings::getGraphicsSettings();
 	TFE_System::init(s_refreshRate, graphics->vsync, c_gitVersion);
+	TFE_Jobs::jobs_init();
+	FileWriterAsync::init();
 	
 	// Setup the GPU Device and Window.
 	u32 windowFlags = 0;
@@ -658,6 +666,14 @@ int main(int argc, char* argv[])
 
 	// Uncomment to test memory region allocator.
 	// TFE_Memory::region_test();
+	// Uncomment to test the keyword hash table.
+	// keyword_test();
+	// Uncomment to compare the archive file stream and memory mapped reads.
+	// archive_readTest("DARK.GOB");
+	// Uncomment to compare opening ZIP entries with zip_open() and the persistent reader.
+	// archive_zipTest();
+	// Uncomment to compare sscanf() and the parser tokenizers.
+	// parser_test();
 
 	// Color correction.
 	const ColorCorrection colorCorrection = { graphics->brightness, graphics->contrast, graphics->saturation, graphics->gamma };
@@ -691,6 +707,15 @@ int main(int argc, char* argv[])
 	// Start reading the mods immediately?
 	TFE_FrontEndUI::modLoader_read();
 
+	// Heap allocation tags for the main loop phases.
+	const TFE_Memory::AllocTag allocTagUi     = TFE_Memory::allocTracker_registerTag("Heap: UI");
+	const TFE_Memory::AllocTag allocTagLoad   = TFE_Memory::allocTracker_registerTag("Heap: Loading");
+	const TFE_Memory::AllocTag allocTagGame   = TFE_Memory::allocTracker_registerTag("Heap: Game");
+#if ENABLE_EDITOR == 1
+	const TFE_Memory::AllocTag allocTagEditor = TFE_Memory::allocTracker_registerTag("Heap: Editor");
+#endif
+	const TFE_Memory::AllocTag allocTagRender = TFE_Memory::allocTracker_registerTag("Heap: Render Backend");
+
 	// Game loop
 	u32 frame = 0u;
 	bool showPerf = false;
@@ -698,6 +723,11 @@ int main(int argc, char* argv[])
 	TFE_System::logWrite(LOG_MSG, "Progam Flow", "The Force Engine Game Loop Started");
 	while (s_loop && !TFE_System::quitMessagePosted())
 	{
+		// Reset the frame arenas first so the profiler picks up the high-water marks of the previous frame.
+		TFE_Memory::frameArena_beginFrame();
+		TFE_Memory::allocTracker_beginFrame();
+		TFE_Jobs::jobs_beginFrame();
+		FileWriterAsync::update();
 		TFE_FRAME_BEGIN();
 		TFE_System::frameLimiter_begin();
 		
@@ -734,6 +764,7 @@ int main(int argc, char* argv[])
 		TFE_FrontEndUI::setCanSave(s_curGame ? s_curGame->canSave() : false);
 
 		// Update the System UI.
+		TFE_Memory::allocTracker_setHeapTag(allocTagUi);
 		AppState appState = TFE_FrontEndUI::update();
 		s_loadRequestFilename = TFE_SaveSystem::loadRequestFilename();
 		if (s_loadRequestFilename)
@@ -747,6 +778,7 @@ int main(int argc, char* argv[])
 		}
 		else if (appState != s_curState)
 		{
+			TFE_ALLOC_SCOPE(allocTagLoad);
 			if (appState == APP_STATE_EXIT_TO_MENU)	// Return to the menu from the game.
 			{
 				if (s_curGame)
@@ -857,6 +889,7 @@ int main(int argc, char* argv[])
 		if (s_curState == APP_STATE_EDITOR)
 		{
 		#if ENABLE_EDITOR == 1
+			TFE_ALLOC_SCOPE(allocTagEditor);
 			if (TFE_Editor::update(isConsoleOpen))
 			{
 				TFE_FrontEndUI::setAppState(APP_STATE_MENU);
@@ -871,6 +904,7 @@ int main(int argc, char* argv[])
 			}
 			else
 			{
+				TFE_ALLOC_SCOPE(allocTagGame);
 				TFE_SaveSystem::update();
 				s_curGame->loopGame();
 				endInputFrame = TFE_Jedi::task_run() != 0;
@@ -898,12 +932,15 @@ int main(int argc, char* argv[])
 	#if ENABLE_EDITOR == 1
 		if (s_curState == APP_STATE_EDITOR)
 		{
+			TFE_ALLOC_SCOPE(allocTagEditor);
 			swap = TFE_Editor::render();
 		}
 	#endif
 
 		// Blit the frame to the window and draw UI.
+		TFE_Memory::allocTracker_setHeapTag(allocTagRender);
 		TFE_RenderBackend::swap(swap);
+		TFE_Memory::allocTracker_setHeapTag(TFE_Memory::ALLOC_TAG_HEAP);
 
 		// Handle framerate limiter.
 		TFE_System::frameLimiter_end();
@@ -933,6 +970,8 @@ int main(int argc, char* argv[])
 	inputMapping_shutdown();
 
 	// Cleanup
+	FileWriterAsync::shutdown();
+	TFE_Jobs::jobs_shutdown();
 	TFE_FrontEndUI::shutdown();
 	TFE_Audio::shutdown();
 	TFE_MidiPlayer::destroy();
@@ -943,6 +982,7 @@ int main(int argc, char* argv[])
 	TFE_Jedi::texturepacker_freeGlobal();
 	TFE_RenderBackend::destroy();
 	TFE_SaveSystem::destroy();
+	TFE_Memory::frameArena_shutdown();
 	SDL_Quit();
 
 	#ifdef ENABLE_FORCE_SCRIPT